@@ -1,6 +1,180 @@
 #include "SLAUSolverLDLT.hpp"
+#include "SolverService.hpp"
+#include "SparseReordering.hpp"
+#include "StreamingLDLTSolver.hpp"
 
-int main()
+namespace
+{
+    /**
+     * @brief Solves the system in data/ (or a band file) with one precision instantiation.
+     *
+     * A positive refineTolerance selects mixed-precision iterative refinement
+     * instead of the direct solve. A non-negative minPivot stops the factorization
+     * at the first pivot at or below it; a positive maxCondition stops before the
+     * solve when the condition estimate exceeds it.
+     */
+    template <typename StorageT, typename AccumT>
+    void run(const string &inputFilePath, const string &alFilePath, const string &dFilePath,
+             const string &fFilePath, const string &xFilePath, const string &bandFilePath,
+             double refineTolerance, SolutionFormat format, double minPivot, double maxCondition)
+    {
+        using Solver = SLAUSolverLDLT<StorageT, AccumT>;
+
+        unique_ptr<Solver> ldlt = bandFilePath.empty()
+                                      ? make_unique<Solver>(inputFilePath, alFilePath, dFilePath, fFilePath, xFilePath)
+                                      : make_unique<Solver>(bandFilePath, xFilePath);
+        ldlt->setSolutionFormat(format);
+        if (minPivot >= 0)
+        {
+            ldlt->setPivotCheck(minPivot, true);
+        }
+        if (refineTolerance > 0)
+        {
+            RefinementReport report = ldlt->solveWithRefinement(refineTolerance);
+            ldlt->writeVectorFToFile();
+            cout << "Refinement iterations: " << report.iterations << '\n'
+                 << "Residual norm: " << scientific << report.residualNorm << '\n'
+                 << "Relative residual: " << report.relativeResidual << fixed << '\n';
+            if (!report.converged)
+            {
+                cout << "Refinement stopped before reaching the tolerance\n";
+            }
+        }
+        else
+        {
+            ldlt->setKeepSnapshot(true);
+            ldlt->performLDLtDecomposition();
+            if (maxCondition > 0)
+            {
+                const PivotReport &pivots = ldlt->pivotReport();
+                ConditionEstimate estimate = ldlt->estimateCondition();
+                cout << "Pivots |D|: min " << scientific << pivots.minAbsPivot << ", max " << pivots.maxAbsPivot << '\n'
+                     << "Condition estimate: " << estimate.condition << fixed << '\n';
+                if (estimate.condition > maxCondition)
+                {
+                    throw runtime_error("Condition estimate above --max-condition; not solving in " +
+                                        string(is_same_v<StorageT, float> ? "float (try --precision double)" : "double"));
+                }
+            }
+            ldlt->solveLinearSystem();
+            ldlt->writeVectorFToFile();
+            ldlt->returnMatix();
+        }
+        ldlt->printMultiplyMatrixToVector();
+    }
+
+    /**
+     * @brief Solves a sparse symmetric system given as a COO file after RCM reordering.
+     *
+     * F is read from fFilePath in the original numbering and X is written in it.
+     */
+    template <typename StorageT, typename AccumT>
+    void runSparse(const string &cooFilePath, const string &fFilePath, const string &xFilePath, SolutionFormat format)
+    {
+        SparseMatrix<StorageT> A = SparseMatrix<StorageT>::loadCoo(cooFilePath);
+        ReorderedBandSolver<StorageT, AccumT> reordered(A);
+        cout << "Bandwidth before RCM: " << reordered.originalBandwidth() << '\n'
+             << "Bandwidth after RCM: " << reordered.bandwidth() << '\n';
+
+        vector<StorageT> x(A.n);
+        parseVectorText(fFilePath, x.data(), A.n);
+        reordered.factor();
+        reordered.solve(x.data(), x.data());
+
+        if (format == SolutionFormat::Binary)
+        {
+            writeVectorFile(xFilePath, x.data(), x.size());
+        }
+        else
+        {
+            writeVectorText(xFilePath, x.data(), x.size(), precisionDigits<StorageT>);
+        }
+    }
+
+    /**
+     * @brief Solves the text system out of core with StreamingLDLTSolver.
+     *
+     * The factors go to factorFilePath, which must have room for n * (m + 2) values;
+     * only O(m^2) values are held in memory.
+     */
+    template <typename StorageT, typename AccumT>
+    void runStreaming(const string &inputFilePath, const string &alFilePath, const string &dFilePath,
+                      const string &fFilePath, const string &factorFilePath, const string &xFilePath)
+    {
+        StreamingLDLTSolver<StorageT, AccumT> streaming(inputFilePath, alFilePath, dFilePath, fFilePath, factorFilePath,
+                                                        xFilePath);
+        streaming.solve();
+        cout << "Streaming solve: n = " << streaming.size() << ", m = " << streaming.bandwidth()
+             << ", working set " << streaming.workingSetBytes() << " bytes\n";
+    }
+
+    /**
+     * @brief Answers solve jobs from stdin ("-") or a Unix domain socket until quit.
+     */
+    template <typename StorageT, typename AccumT>
+    void runService(const string &servePath, size_t cacheBytes, SolutionFormat format)
+    {
+        SolverService<StorageT, AccumT> service(cacheBytes, format, 0);
+        if (servePath == "-")
+        {
+            service.serve(cin, cout);
+        }
+        else
+        {
+            service.serveSocket(servePath);
+        }
+        cerr << service.statsLine() << '\n';
+    }
+
+    /**
+     * @brief Picks the precision: --precision, then double for --refine, then the band
+     *        file scalar type, then the optional third token of the size file, then double.
+     */
+    Precision selectPrecision(const string &flag, bool refine, const string &inputFilePath, const string &bandFilePath)
+    {
+        if (!flag.empty())
+        {
+            return parsePrecision(flag);
+        }
+        if (refine)
+        {
+            return Precision::Double;
+        }
+        if (!bandFilePath.empty())
+        {
+            MappedBandFile file(bandFilePath, false);
+            return file.scalarType() == BandScalarType::Float32 ? Precision::Float : Precision::Double;
+        }
+        string tag = parsePrecisionText(inputFilePath);
+        return tag.empty() ? Precision::Double : parsePrecision(tag);
+    }
+
+    /**
+     * @brief Prints the command-line options of ldlt.exe.
+     */
+    void printUsage(const char *program)
+    {
+        cout << "Usage: " << program << " [options]\n"
+             << "Solves the banded system in data/ (input.txt, AL.txt, D.txt, F.txt) and writes data/X.txt.\n"
+             << "\n"
+             << "  --precision float|double|float_double  scalar types of the solve (default: input file tag, else double)\n"
+             << "  --band-file <path>                     read the system from a binary band file\n"
+             << "  --coo <path>                           read a sparse COO system and reorder it with RCM\n"
+             << "  --rhs <path>                           right-hand side file (default data/F.txt)\n"
+             << "  --output <path>                        solution file (default data/X.txt)\n"
+             << "  --output-format text|binary            solution file format (default text)\n"
+             << "  --refine <tolerance>                   mixed-precision iterative refinement to this residual\n"
+             << "  --min-pivot <value>                    stop at the first pivot |d| at or below value\n"
+             << "  --max-condition <value>                refuse to solve above this condition estimate\n"
+             << "  --stream <factor file>                 factor out of core, keeping the factors in this file\n"
+             << "  --serve <socket>|-                     answer solve jobs from a Unix socket or stdin\n"
+             << "  --cache-mb <megabytes>                 factorization cache size of --serve (default 1024)\n"
+             << "  --profile <path>|-                     write the phase profile as JSON (INSTRUMENT=1 builds)\n"
+             << "  -h, --help                             print this help\n";
+    }
+}
+
+int main(int argc, char **argv)
 {
     try
     {
@@ -9,13 +183,138 @@ int main()
         string dFilePath = "data/D.txt";
         string fFilePath = "data/F.txt";
         string xFilePath = "data/X.txt";
+        string bandFilePath;
+        string cooFilePath;
+        string precisionFlag;
+        string profileFilePath;
+        SolutionFormat outputFormat = SolutionFormat::Text;
+        double refineTolerance = 0;
+        double minPivot = -1;
+        double maxCondition = 0;
+        string servePath;
+        double cacheMegabytes = 1024;
+        string factorFilePath;
+
+        for (int i = 1; i < argc; ++i)
+        {
+            string arg = argv[i];
+            if (arg == "--help" || arg == "-h")
+            {
+                printUsage(argv[0]);
+                return 0;
+            }
+            if (i + 1 >= argc)
+            {
+                throw invalid_argument("Missing value for " + arg);
+            }
+            if (arg == "--precision")
+            {
+                precisionFlag = argv[++i];
+            }
+            else if (arg == "--band-file")
+            {
+                bandFilePath = argv[++i];
+            }
+            else if (arg == "--coo")
+            {
+                cooFilePath = argv[++i];
+            }
+            else if (arg == "--rhs")
+            {
+                fFilePath = argv[++i];
+            }
+            else if (arg == "--output")
+            {
+                xFilePath = argv[++i];
+            }
+            else if (arg == "--output-format")
+            {
+                outputFormat = parseSolutionFormat(argv[++i]);
+            }
+            else if (arg == "--refine")
+            {
+                refineTolerance = stod(argv[++i]);
+            }
+            else if (arg == "--profile")
+            {
+                profileFilePath = argv[++i];
+            }
+            else if (arg == "--min-pivot")
+            {
+                minPivot = stod(argv[++i]);
+            }
+            else if (arg == "--max-condition")
+            {
+                maxCondition = stod(argv[++i]);
+            }
+            else if (arg == "--serve")
+            {
+                servePath = argv[++i];
+            }
+            else if (arg == "--cache-mb")
+            {
+                cacheMegabytes = stod(argv[++i]);
+            }
+            else if (arg == "--stream")
+            {
+                factorFilePath = argv[++i];
+            }
+            else
+            {
+                throw invalid_argument("Unknown option: " + arg);
+            }
+        }
+
+        if (!factorFilePath.empty() && (!bandFilePath.empty() || !cooFilePath.empty() || !servePath.empty() ||
+                                        refineTolerance > 0 || outputFormat != SolutionFormat::Text))
+        {
+            throw invalid_argument("--stream reads the text system and writes a text solution; it does not combine with "
+                                   "--band-file, --coo, --serve, --refine or --output-format binary");
+        }
+
+        // A service has no system of its own; its precision is --precision or double.
+        Precision precision = !servePath.empty()
+                                  ? (precisionFlag.empty() ? Precision::Double : parsePrecision(precisionFlag))
+                                  : selectPrecision(precisionFlag, refineTolerance > 0, inputFilePath, bandFilePath);
+        dispatchPrecision(precision, [&](auto pair)
+        {
+            using Pair = decltype(pair);
+            if (!servePath.empty())
+            {
+                runService<typename Pair::Storage, typename Pair::Accum>(servePath, size_t(cacheMegabytes * (1 << 20)),
+                                                                         outputFormat);
+            }
+            else if (!factorFilePath.empty())
+            {
+                runStreaming<typename Pair::Storage, typename Pair::Accum>(inputFilePath, alFilePath, dFilePath,
+                                                                           fFilePath, factorFilePath, xFilePath);
+            }
+            else if (!cooFilePath.empty())
+            {
+                runSparse<typename Pair::Storage, typename Pair::Accum>(cooFilePath, fFilePath, xFilePath, outputFormat);
+            }
+            else
+            {
+                run<typename Pair::Storage, typename Pair::Accum>(inputFilePath, alFilePath, dFilePath,
+                                                                  fFilePath, xFilePath, bandFilePath, refineTolerance,
+                                                                  outputFormat, minPivot, maxCondition);
+            }
+        });
 
-        SLAUSolverLDLT ldlt(inputFilePath, alFilePath, dFilePath, fFilePath, xFilePath);
-        ldlt.performLDLtDecomposition();
-        ldlt.solveLinearSystem();
-        ldlt.writeVectorFToFile();
-        ldlt.returnMatix();
-        ldlt.printMultiplyMatrixToVector();
+        // Phase summary of the run; "-" prints it to stdout. Empty unless built with INSTRUMENT=1.
+        if (profileFilePath == "-")
+        {
+            Instrumentation::writeJson(cout);
+        }
+        else if (!profileFilePath.empty())
+        {
+            ofstream profileFile(profileFilePath);
+            if (!profileFile.is_open())
+            {
+                throw runtime_error("Could not open file: " + profileFilePath);
+            }
+            Instrumentation::writeJson(profileFile);
+        }
     }
     catch (const exception &e)
     {
@@ -24,4 +323,4 @@ int main()
     }
 
     return 0;
-}
\ No newline at end of file
+}
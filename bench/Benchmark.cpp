@@ -0,0 +1,639 @@
+/**
+ * @file Benchmark.cpp
+ * @brief Benchmark driver timing every phase of the band LDLT solver.
+ *
+ * The driver generates a band system, writes it as text and as a binary band file,
+ * and then times, for each repetition, loading both formats, the factorization,
+ * each substitution and writing the solution. The precision is selected with
+ * --precision and reported in every record; `make bench` runs all three.
+ *
+ * Usage:
+ * @code
+ * ldlt_bench.exe [--precision float|double|float_double] [--n N] [--m M]
+ *                [--matrix random|laplacian|hilbert] [--repeat R]
+ *                [--kernel auto|serial|wavefront|blocked|fixed] [--threads T]
+ *                [--format csv|json] [--dir DIR] [--batch S] [--rhs K]
+ *                [--backend cpu|cuda|hip] [--header]
+ * @endcode
+ *
+ * With --batch S the driver instead packs S independent random systems of size n and
+ * bandwidth m into a BatchedLDLTSolver and times the batched factorization and solve.
+ * --rhs K adds a solve of K random right-hand sides against one factorization.
+ * The stream_* phases solve the text system again with StreamingLDLTSolver.
+ * --backend runs the batched and the K right-hand side solves on a GPU backend
+ * (see DeviceBackend.hpp); the device results are then checked against the host
+ * kernels and the run fails if their relative residual is more than 10 times
+ * that of the host solution.
+ *
+ * Flop and byte counts are analytic (compulsory traffic of each phase), not measured.
+ * Every record also carries ||F - A * x||_2 / ||F||_2 of the last solve (the largest
+ * one over the batch), the number of systems solved per second of the phase and
+ * the fewest heap allocations of one repetition, counted by the operator new of
+ * tests/AllocationCounter.cpp.
+ * The time_step phase reuses one solver and fails the run if it allocates.
+ */
+#include "AllocationCounter.hpp"
+#include "BatchedLDLTSolver.hpp"
+#include "DeviceBackend.hpp"
+#include "SLAUSolverLDLT.hpp"
+#include "StreamingLDLTSolver.hpp"
+
+namespace
+{
+    struct Options
+    {
+        Precision precision = Precision::Double;
+        int n = 100000;
+        int m = 16;
+        string matrix = "random";
+        int repeat = 3;
+        string kernel = "auto";
+        int threads = 1;
+        string format = "csv";
+        string dir = "build/bench_data";
+        int batch = 0;
+        int rhs = 0;
+        ComputeBackend backend = ComputeBackend::Cpu;
+        bool header = false;
+    };
+
+    struct Phase
+    {
+        string name;
+        double flops;
+        double bytes;
+        vector<double> seconds;
+        double systems;
+        vector<size_t> allocations;
+
+        Phase(string phaseName, double phaseFlops, double phaseBytes, double phaseSystems = 1)
+            : name(std::move(phaseName)), flops(phaseFlops), bytes(phaseBytes), systems(phaseSystems)
+        {
+        }
+    };
+
+    Options parseOptions(int argc, char **argv)
+    {
+        Options options;
+        for (int i = 1; i < argc; ++i)
+        {
+            string arg = argv[i];
+            auto value = [&]() -> string
+            {
+                if (i + 1 >= argc)
+                {
+                    throw invalid_argument("Missing value for " + arg);
+                }
+                return argv[++i];
+            };
+
+            if (arg == "--precision")
+            {
+                options.precision = parsePrecision(value());
+            }
+            else if (arg == "--n")
+            {
+                options.n = stoi(value());
+            }
+            else if (arg == "--m")
+            {
+                options.m = stoi(value());
+            }
+            else if (arg == "--matrix")
+            {
+                options.matrix = value();
+            }
+            else if (arg == "--repeat")
+            {
+                options.repeat = max(1, stoi(value()));
+            }
+            else if (arg == "--kernel")
+            {
+                options.kernel = value();
+            }
+            else if (arg == "--threads")
+            {
+                options.threads = stoi(value());
+            }
+            else if (arg == "--format")
+            {
+                options.format = value();
+            }
+            else if (arg == "--dir")
+            {
+                options.dir = value();
+            }
+            else if (arg == "--batch")
+            {
+                options.batch = max(0, stoi(value()));
+            }
+            else if (arg == "--rhs")
+            {
+                options.rhs = max(0, stoi(value()));
+            }
+            else if (arg == "--backend")
+            {
+                options.backend = parseComputeBackend(value());
+            }
+            else if (arg == "--header")
+            {
+                options.header = true;
+            }
+            else
+            {
+                throw invalid_argument("Unknown option: " + arg);
+            }
+        }
+        return options;
+    }
+
+    FactorizationKernel parseKernel(const string &name)
+    {
+        if (name == "auto")
+        {
+            return FactorizationKernel::Auto;
+        }
+        if (name == "serial")
+        {
+            return FactorizationKernel::Serial;
+        }
+        if (name == "wavefront")
+        {
+            return FactorizationKernel::Wavefront;
+        }
+        if (name == "blocked")
+        {
+            return FactorizationKernel::Blocked;
+        }
+        if (name == "fixed")
+        {
+            return FactorizationKernel::Fixed;
+        }
+        throw invalid_argument("Unknown kernel: " + name);
+    }
+
+    template <typename Solver>
+    void generate(Solver &solver, const string &matrix)
+    {
+        if (matrix == "random")
+        {
+            solver.DiagonallyDominantBandMatrix(12345u);
+        }
+        else if (matrix == "laplacian")
+        {
+            solver.LaplacianBandMatrix();
+        }
+        else if (matrix == "hilbert")
+        {
+            solver.HilbertBandMatrix();
+        }
+        else
+        {
+            throw invalid_argument("Unknown matrix: " + matrix);
+        }
+    }
+
+    template <typename Function>
+    void measure(Phase &phase, Function function)
+    {
+        size_t allocationsBefore = allocationCount();
+        auto start = chrono::steady_clock::now();
+        function();
+        double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        size_t allocations = allocationCount() - allocationsBefore;
+        phase.seconds.push_back(seconds);
+        phase.allocations.push_back(allocations);
+    }
+
+    double fileBytes(const vector<string> &paths)
+    {
+        double total = 0;
+        for (const string &path : paths)
+        {
+            total += double(filesystem::file_size(path));
+        }
+        return total;
+    }
+
+    /// Fails the run when a device solution is clearly worse than the host solution of the same systems.
+    template <typename StorageT>
+    void checkAgainstHost(const Options &options, double deviceResidual, double hostResidual)
+    {
+        const double limit = max(10 * hostResidual, 100 * double(numeric_limits<StorageT>::epsilon()));
+        if (deviceResidual > limit)
+        {
+            ostringstream message;
+            message << computeBackendName(options.backend) << " relative residual " << scientific << deviceResidual
+                    << " against " << hostResidual << " on the host";
+            throw runtime_error(message.str());
+        }
+    }
+
+    void report(const Options &options, const vector<Phase> &phases, double relativeResidual)
+    {
+        cout << defaultfloat << setprecision(6);
+        if (options.format == "json")
+        {
+            cout << "[\n";
+        }
+        else if (options.header)
+        {
+            cout << "precision,matrix,n,m,kernel,threads,backend,phase,repeat,seconds_min,seconds_mean,gflops,gbps,relative_residual,systems_per_second,allocations_min\n";
+        }
+
+        for (size_t p = 0; p < phases.size(); ++p)
+        {
+            const Phase &phase = phases[p];
+            double best = *min_element(phase.seconds.begin(), phase.seconds.end());
+            double mean = accumulate(phase.seconds.begin(), phase.seconds.end(), 0.0) / phase.seconds.size();
+            double gflops = best > 0 ? phase.flops / best * 1e-9 : 0.0;
+            double gbps = best > 0 ? phase.bytes / best * 1e-9 : 0.0;
+            double throughput = best > 0 ? phase.systems / best : 0.0;
+            size_t allocations = *min_element(phase.allocations.begin(), phase.allocations.end());
+
+            if (options.format == "json")
+            {
+                cout << "  {\"precision\": \"" << precisionName(options.precision) << "\", \"matrix\": \"" << options.matrix
+                     << "\", \"n\": " << options.n << ", \"m\": " << options.m
+                     << ", \"kernel\": \"" << options.kernel << "\", \"threads\": " << options.threads
+                     << ", \"backend\": \"" << computeBackendName(options.backend) << '"'
+                     << ", \"phase\": \"" << phase.name << "\", \"repeat\": " << phase.seconds.size()
+                     << ", \"seconds_min\": " << best << ", \"seconds_mean\": " << mean
+                     << ", \"gflops\": " << gflops << ", \"gbps\": " << gbps
+                     << ", \"relative_residual\": " << relativeResidual
+                     << ", \"systems_per_second\": " << throughput
+                     << ", \"allocations_min\": " << allocations << "}"
+                     << (p + 1 < phases.size() ? ",\n" : "\n");
+            }
+            else
+            {
+                cout << precisionName(options.precision) << ',' << options.matrix << ',' << options.n << ',' << options.m << ','
+                     << options.kernel << ',' << options.threads << ',' << computeBackendName(options.backend) << ','
+                     << phase.name << ','
+                     << phase.seconds.size() << ',' << best << ',' << mean << ',' << gflops << ',' << gbps << ','
+                     << relativeResidual << ',' << throughput << ',' << allocations << '\n';
+            }
+        }
+
+        if (options.format == "json")
+        {
+            cout << "]\n";
+        }
+    }
+
+    template <typename StorageT, typename AccumT>
+    void runBenchmark(const Options &options)
+    {
+        using Solver = SLAUSolverLDLT<StorageT, AccumT>;
+
+        filesystem::create_directories(options.dir);
+
+        const string prefix = options.dir + "/" + precisionName(options.precision) + "_";
+        const string inputFilePath = prefix + "input.txt";
+        const string alFilePath = prefix + "AL.txt";
+        const string dFilePath = prefix + "D.txt";
+        const string fFilePath = prefix + "F.txt";
+        const string bandFilePath = prefix + "system.ldlt";
+        const string xFilePath = prefix + "X.txt";
+
+        const double n = options.n, m = options.m, s = sizeof(StorageT);
+        const double stride = BandMatrix<StorageT>::paddedStride(options.m);
+
+        Phase generatePhase("generate", 0, n * (stride + 2) * s);
+        Phase writeTextPhase("write_text", 0, 0);
+        Phase writeBandPhase("write_band_file", 0, 0);
+        Phase loadTextPhase("load_text", 0, 0);
+        Phase loadBandPhase("load_band_file", 0, 0);
+        Phase factorPhase("factorization", n * (1.5 * m * m + 3.5 * m), 2 * n * (stride + 1) * s);
+        Phase forwardPhase("forward", 2 * n * m, n * (stride + 2) * s);
+        Phase diagonalPhase("diagonal", n, 3 * n * s);
+        Phase backwardPhase("backward", 2 * n * m, n * (stride + 2) * s);
+        // Fused solve: L twice, F read and written once per sweep, 1 / D once.
+        Phase solvePhase("solve", 4 * n * m + n, n * (2 * stride + 5) * s);
+        Phase residualPhase("residual", 4 * n * m + 3 * n, n * (stride + 4) * s);
+        Phase writeSolutionPhase("write_solution", 0, 0);
+        Phase stepPhase("time_step", factorPhase.flops + 4 * n * m + n, factorPhase.bytes + 2 * n * (stride + 2) * s);
+
+        {
+            unique_ptr<Solver> generated;
+            measure(generatePhase, [&]
+            {
+                generated = make_unique<Solver>(options.n, options.m, xFilePath);
+                generate(*generated, options.matrix);
+            });
+            measure(writeTextPhase, [&]
+            { generated->saveToFile(inputFilePath, alFilePath, dFilePath, fFilePath); });
+            measure(writeBandPhase, [&]
+            { generated->saveToBandFile(bandFilePath); });
+        }
+        writeTextPhase.bytes = fileBytes({inputFilePath, alFilePath, dFilePath, fFilePath});
+        writeBandPhase.bytes = fileBytes({bandFilePath});
+        loadTextPhase.bytes = writeTextPhase.bytes;
+        loadBandPhase.bytes = writeBandPhase.bytes;
+
+        // Unfactored A and F for the residual check of every solve.
+        Solver original(bandFilePath, xFilePath, false);
+        original.setNumThreads(options.threads);
+        ResidualNorms norms;
+
+        // The solvers of all repetitions share one workspace, as a caller reusing it step after step would.
+        auto workspace = make_shared<typename Solver::Workspace>();
+
+        for (int r = 0; r < options.repeat; ++r)
+        {
+            measure(loadBandPhase, [&]
+            { Solver mapped(bandFilePath, xFilePath, true); });
+
+            unique_ptr<Solver> solver;
+            measure(loadTextPhase, [&]
+            { solver = make_unique<Solver>(inputFilePath, alFilePath, dFilePath, fFilePath, xFilePath); });
+
+            solver->setNumThreads(options.threads);
+            solver->setFactorizationKernel(parseKernel(options.kernel));
+            solver->setWorkspace(workspace);
+
+            measure(factorPhase, [&]
+            { solver->performLDLtDecomposition(); });
+            measure(forwardPhase, [&]
+            { solver->solveForwardSubstitution(); });
+            measure(diagonalPhase, [&]
+            { solver->solveDiagonalSubstitution(); });
+            measure(backwardPhase, [&]
+            { solver->solveBackwardSubstitution(); });
+            measure(residualPhase, [&]
+            { norms = original.residualNorms(solver->getVectorF().data(), original.getVectorF().data()); });
+            measure(writeSolutionPhase, [&]
+            { solver->writeVectorFToFile(); });
+
+            solver->setVectorF(original.getVectorF().data());
+            measure(solvePhase, [&]
+            { solver->solveLinearSystem(); });
+        }
+        writeSolutionPhase.bytes = fileBytes({xFilePath});
+
+        // A time-stepping loop on one solver: restore A from the snapshot, set F,
+        // factor and solve. The first step grows the snapshot and the workspace,
+        // every later step must run without heap allocations.
+        {
+            Solver stepper(inputFilePath, alFilePath, dFilePath, fFilePath, xFilePath);
+            stepper.setNumThreads(options.threads);
+            stepper.setFactorizationKernel(parseKernel(options.kernel));
+            stepper.setKeepSnapshot(true);
+
+            Phase warmUp("warm_up", 0, 0);
+            for (int r = 0; r <= options.repeat; ++r)
+            {
+                measure(r == 0 ? warmUp : stepPhase, [&]
+                {
+                    if (stepper.isFactored())
+                    {
+                        stepper.returnMatix();
+                    }
+                    stepper.setVectorF(original.getVectorF().data());
+                    stepper.performLDLtDecomposition();
+                    stepper.solveLinearSystem();
+                });
+            }
+
+            size_t stepAllocations = *max_element(stepPhase.allocations.begin(), stepPhase.allocations.end());
+            if (stepAllocations > 0)
+            {
+                throw runtime_error("Steady-state time step made " + to_string(stepAllocations) + " heap allocations");
+            }
+        }
+
+        // The out-of-core solver on the same text files: the forward pass parses them
+        // and writes the factor file, the backward pass reads it back and writes X.
+        const string factorFilePath = prefix + "factors.bin";
+        const string streamXFilePath = prefix + "X_stream.txt";
+        Phase streamForwardPhase("stream_factor_forward", factorPhase.flops + 2 * n * m + n,
+                                 loadTextPhase.bytes + n * (m + 2) * s);
+        Phase streamBackwardPhase("stream_backward", 2 * n * m, n * (m + 2) * s + 2 * n * s);
+        for (int r = 0; r < options.repeat; ++r)
+        {
+            StreamingLDLTSolver<StorageT, AccumT> streaming(inputFilePath, alFilePath, dFilePath, fFilePath,
+                                                            factorFilePath, streamXFilePath);
+            measure(streamForwardPhase, [&]
+            { streaming.factorAndForward(); });
+            measure(streamBackwardPhase, [&]
+            { streaming.solveBackward(); });
+        }
+        streamBackwardPhase.bytes += fileBytes({streamXFilePath});
+        vector<StorageT> streamed(options.n);
+        parseVectorText(streamXFilePath, streamed.data(), options.n);
+        double streamResidual = original.residualNorms(streamed.data(), original.getVectorF().data()).relative;
+        filesystem::remove(factorFilePath);
+
+        vector<Phase> phases = {generatePhase, writeTextPhase, writeBandPhase, loadTextPhase, loadBandPhase,
+                                factorPhase, forwardPhase, diagonalPhase, backwardPhase, solvePhase, residualPhase,
+                                writeSolutionPhase, stepPhase, streamForwardPhase, streamBackwardPhase};
+        double worst = max(norms.relative, streamResidual);
+
+        // K right-hand sides against one factorization, on the selected backend.
+        if (options.rhs > 0)
+        {
+            const int k = options.rhs;
+            Phase uploadPhase("device_upload", 0, n * (stride + 1) * s);
+            Phase multiPhase("multi_rhs_solve", k * (4 * n * m + n), n * (2 * stride + 1) * s + 4 * k * n * s, double(k));
+
+            Solver system(bandFilePath, xFilePath, false);
+            system.setNumThreads(options.threads);
+            system.setFactorizationKernel(parseKernel(options.kernel));
+            shared_ptr<const typename Solver::Factorization> factors = system.factorize();
+
+            vector<StorageT> rhs(size_t(options.n) * k), x;
+            mt19937 generator(54321u);
+            uniform_real_distribution<double> value(-1.0, 1.0);
+            for (StorageT &entry : rhs)
+            {
+                entry = StorageT(value(generator));
+            }
+
+            auto worstColumn = [&](const vector<StorageT> &solution)
+            {
+                double largest = 0;
+                for (int c = 0; c < k; ++c)
+                {
+                    size_t offset = size_t(c) * options.n;
+                    largest = max(largest, original.residualNorms(solution.data() + offset, rhs.data() + offset).relative);
+                }
+                return largest;
+            };
+
+            unique_ptr<DeviceBandFactorization<StorageT, AccumT>> device;
+            if (options.backend != ComputeBackend::Cpu)
+            {
+                measure(uploadPhase, [&]
+                { device = make_unique<DeviceBandFactorization<StorageT, AccumT>>(*factors); });
+            }
+            for (int r = 0; r < options.repeat; ++r)
+            {
+                x = rhs;
+                measure(multiPhase, [&]
+                {
+                    if (device != nullptr)
+                    {
+                        device->solve(x.data(), k, options.n);
+                    }
+                    else
+                    {
+                        factors->solve(x.data(), k, options.n, *workspace);
+                    }
+                });
+            }
+            double multiResidual = worstColumn(x);
+
+            if (device != nullptr)
+            {
+                x = rhs;
+                factors->solve(x.data(), k, options.n, *workspace);
+                checkAgainstHost<StorageT>(options, multiResidual, worstColumn(x));
+                phases.push_back(uploadPhase);
+            }
+            phases.push_back(multiPhase);
+            worst = max(worst, multiResidual);
+        }
+
+        report(options, phases, worst);
+    }
+
+    template <typename StorageT, typename AccumT>
+    void runBatchBenchmark(const Options &options)
+    {
+        using Batch = BatchedLDLTSolver<StorageT, AccumT>;
+
+        if (options.matrix != "random")
+        {
+            throw invalid_argument("Batched benchmark only supports --matrix random");
+        }
+
+        const int n = options.n, m = options.m;
+        const double systems = options.batch, s = sizeof(StorageT);
+        const double entries = double(n) * (m + 2);
+
+        Phase generatePhase("batch_generate", 0, systems * entries * s, systems);
+        Phase factorPhase("batch_factorization", systems * n * (1.5 * m * m + 3.5 * m), 2 * systems * n * (m + 1) * s, systems);
+        Phase solvePhase("batch_solve", systems * (4.0 * n * m + n), systems * n * (2 * m + 3) * s, systems);
+
+        // Diagonally dominant systems with entries in [-1, 1] off the diagonal.
+        Batch original(options.batch, n, m);
+        measure(generatePhase, [&]
+        {
+            mt19937 generator(12345u);
+            uniform_real_distribution<double> offDiagonal(-1.0, 1.0);
+            for (int i = 0; i < n; ++i)
+            {
+                for (int p = max(0, m - i); p < m; ++p)
+                {
+                    StorageT *entry = original.AL(i, p);
+                    for (int c = 0; c < options.batch; ++c)
+                    {
+                        entry[c] = StorageT(offDiagonal(generator));
+                    }
+                }
+                StorageT *diagonal = original.D(i);
+                StorageT *right = original.F(i);
+                for (int c = 0; c < options.batch; ++c)
+                {
+                    diagonal[c] = StorageT(2.0 * m + 1.0 + offDiagonal(generator));
+                    right[c] = StorageT(offDiagonal(generator));
+                }
+            }
+        });
+
+        // On a device backend the host batch is solved once, untimed, for the check.
+        Batch batch(options.batch, n, m);
+        batch.setNumThreads(options.threads);
+        for (int r = 0; r < (options.backend == ComputeBackend::Cpu ? options.repeat : 1); ++r)
+        {
+            batch = original;
+            measure(factorPhase, [&]
+            { batch.factor(); });
+            measure(solvePhase, [&]
+            { batch.solve(); });
+        }
+
+        // The device pack is uploaded again for every repetition, as factor() works in place.
+        Phase uploadPhase("device_upload", 0, systems * n * (m + 1) * s, systems);
+        Batch deviceResult(0, 0, 0);
+        if (options.backend != ComputeBackend::Cpu)
+        {
+            factorPhase.seconds.clear();
+            solvePhase.seconds.clear();
+            factorPhase.allocations.clear();
+            solvePhase.allocations.clear();
+            for (int r = 0; r < options.repeat; ++r)
+            {
+                deviceResult = original;
+                unique_ptr<DeviceBatchedLDLTSolver<StorageT, AccumT>> device;
+                measure(uploadPhase, [&]
+                { device = make_unique<DeviceBatchedLDLTSolver<StorageT, AccumT>>(original); });
+                measure(factorPhase, [&]
+                { device->factor(); });
+                measure(solvePhase, [&]
+                { device->solve(deviceResult); });
+            }
+        }
+
+        // Largest relative residual over the batch.
+        BandMatrix<StorageT> AL(n, m);
+        vector<StorageT> D(n), F(n), x(n);
+        vector<AccumT> r(n);
+        auto worstSystem = [&](const Batch &solved)
+        {
+            double largest = 0;
+            for (int c = 0; c < options.batch; ++c)
+            {
+                for (int i = 0; i < n; ++i)
+                {
+                    for (int p = 0; p < m; ++p)
+                    {
+                        AL[i][p] = original.AL(i, p)[c];
+                    }
+                    D[i] = original.D(i)[c];
+                    F[i] = original.F(i)[c];
+                }
+                solved.getSolution(c, x.data());
+                largest = max(largest, bandResidual<StorageT, AccumT>(AL, D.data(), x.data(), F.data(), r.data()).relative);
+            }
+            return largest;
+        };
+
+        if (options.backend == ComputeBackend::Cpu)
+        {
+            report(options, {generatePhase, factorPhase, solvePhase}, worstSystem(batch));
+            return;
+        }
+        double worst = worstSystem(deviceResult);
+        checkAgainstHost<StorageT>(options, worst, worstSystem(batch));
+        report(options, {generatePhase, uploadPhase, factorPhase, solvePhase}, worst);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    try
+    {
+        Options options = parseOptions(argc, argv);
+        requireComputeBackend(options.backend);
+        dispatchPrecision(options.precision, [&](auto pair)
+        {
+            using Pair = decltype(pair);
+            if (options.batch > 0)
+            {
+                runBatchBenchmark<typename Pair::Storage, typename Pair::Accum>(options);
+            }
+            else
+            {
+                runBenchmark<typename Pair::Storage, typename Pair::Accum>(options);
+            }
+        });
+    }
+    catch (const exception &e)
+    {
+        cerr << "EROR: " << e.what() << '\n';
+        return 1;
+    }
+
+    return 0;
+}
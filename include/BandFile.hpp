@@ -0,0 +1,200 @@
+/**
+ * @file BandFile.hpp
+ * @brief Binary container for a band system (AL, D and optionally F) that can be memory-mapped.
+ *
+ * Layout of a file:
+ * - a 4096-byte header (BandFileHeader) with the shape, scalar type, layout and checksum;
+ * - the AL section: n rows of BandMatrix<T>::paddedStride(m) elements, row-major;
+ * - the D section: n elements;
+ * - the F section: n elements, present only when offsetF is not zero.
+ *
+ * Every section starts on a page boundary, so a mapped AL section can be used in place
+ * by BandMatrix::attach(). The checksum is FNV-1a (64 bit) over all section bytes.
+ *
+ * A vector file (layout BandLayout::Vector, written by writeVectorFile() or
+ * VectorFileWriter) uses the same header for a lone vector such as a solution:
+ * m, rowStride, offsetAL and offsetD are 0 and the vector is the F section.
+ */
+
+#ifndef BandFile_HPP
+#define BandFile_HPP
+
+#include <bits/stdc++.h>
+#include "BandMatrix.hpp"
+using namespace std;
+
+/// Scalar type codes stored in BandFileHeader::scalarType.
+enum class BandScalarType : uint32_t
+{
+    Float32 = 1,
+    Float64 = 2
+};
+
+/// Layout codes stored in BandFileHeader::layout.
+enum class BandLayout : uint32_t
+{
+    RowMajorLower = 1, ///< Row i holds A(i, j), i - m <= j < i, at position m - i + j
+    Vector = 2         ///< No AL and D sections, the F section holds one vector
+};
+
+/**
+ * @brief On-disk header of a band file.
+ */
+struct BandFileHeader
+{
+    char magic[8];       ///< "LDLTBAND"
+    uint32_t version;    ///< Format version, currently 1
+    uint32_t scalarType; ///< BandScalarType of every section
+    uint64_t n;          ///< Number of equations
+    uint64_t m;          ///< Bandwidth
+    uint32_t layout;     ///< BandLayout of the AL section
+    uint32_t rowStride;  ///< Elements between two rows of the AL section
+    uint64_t offsetAL;   ///< Byte offset of the AL section
+    uint64_t offsetD;    ///< Byte offset of the D section
+    uint64_t offsetF;    ///< Byte offset of the F section, 0 when absent
+    uint64_t fileSize;   ///< Total size of the file in bytes
+    uint64_t checksum;   ///< FNV-1a of all section bytes
+};
+
+constexpr size_t BAND_FILE_PAGE = 4096;      ///< Header size and section alignment
+constexpr uint32_t BAND_FILE_VERSION = 1;    ///< Version written by writeBandFile()
+constexpr char BAND_FILE_MAGIC[8] = {'L', 'D', 'L', 'T', 'B', 'A', 'N', 'D'};
+
+/**
+ * @brief Updates a 64-bit FNV-1a hash with a block of bytes.
+ *
+ * @param data Bytes to hash
+ * @param size Number of bytes
+ * @param hash Running hash value
+ * @return Updated hash value
+ */
+uint64_t fnv1a64(const void *data, size_t size, uint64_t hash = 0xcbf29ce484222325ULL);
+
+/**
+ * @brief Writes a band system to a binary file.
+ *
+ * @tparam T Scalar type stored in the file
+ * @param filePath Output path
+ * @param AL Strictly lower band of A
+ * @param D Diagonal of A
+ * @param F Right-hand side, or nullptr to omit the F section
+ */
+template <typename T>
+void writeBandFile(const string &filePath, const BandMatrix<T> &AL, const vector<T> &D, const vector<T> *F);
+
+/**
+ * @brief Writes one vector to a binary file with layout BandLayout::Vector.
+ *
+ * @tparam T Scalar type stored in the file
+ * @param filePath Output path
+ * @param values Source of n values
+ * @param n Number of values
+ */
+template <typename T>
+void writeVectorFile(const string &filePath, const T *values, size_t n);
+
+/**
+ * @class VectorFileWriter
+ * @brief Writes a vector file (layout BandLayout::Vector) in pieces, e.g. as rows arrive.
+ *
+ * The header page is reserved when the file is opened; close() fills it in with
+ * the checksum of everything appended. writeVectorFile() is one append().
+ *
+ * @tparam T Scalar type stored in the file
+ */
+template <typename T>
+class VectorFileWriter
+{
+private:
+    ofstream file;          ///< Underlying file
+    string path;            ///< Path used in error messages
+    BandFileHeader header;  ///< Header written by close()
+    size_t written;         ///< Values appended so far
+
+public:
+    /**
+     * @brief Creates or truncates a file that will hold n values.
+     *
+     * @param filePath Path to the file
+     * @param n Number of values the file will hold
+     * @throws runtime_error if the file cannot be opened
+     */
+    VectorFileWriter(const string &filePath, size_t n);
+
+    /**
+     * @brief Appends count values after the ones written so far.
+     *
+     * @throws logic_error if this would exceed the n values given to the constructor
+     */
+    void append(const T *values, size_t count);
+
+    /**
+     * @brief Writes the header and closes the file.
+     *
+     * @throws logic_error if fewer than n values were appended
+     * @throws runtime_error if any write failed
+     */
+    void close();
+};
+
+/**
+ * @class MappedBandFile
+ * @brief Read-only view of a band file mapped with mmap.
+ *
+ * The mapping is private and writable, so the sections can be factored in place
+ * without modifying the file: touched pages are copied on write by the kernel.
+ */
+class MappedBandFile
+{
+private:
+    void *base;           ///< Start of the mapping
+    size_t length;        ///< Length of the mapping in bytes
+    BandFileHeader info;  ///< Copy of the validated header
+
+public:
+    /**
+     * @brief Maps a band file and validates its header.
+     *
+     * @param filePath Path to the file
+     * @param verifyChecksum Recompute the checksum over all sections
+     * @throws runtime_error if the file cannot be mapped or is not a valid band file
+     */
+    explicit MappedBandFile(const string &filePath, bool verifyChecksum = true);
+    ~MappedBandFile();
+
+    MappedBandFile(const MappedBandFile &) = delete;
+    MappedBandFile &operator=(const MappedBandFile &) = delete;
+
+    const BandFileHeader &header() const { return info; }
+    BandScalarType scalarType() const { return BandScalarType(info.scalarType); }
+    BandLayout layout() const { return BandLayout(info.layout); }
+    int size() const { return int(info.n); }
+    int bandwidth() const { return int(info.m); }
+    bool hasF() const { return info.offsetF != 0; }
+
+    /**
+     * @brief Returns the start of a section, typed as T.
+     *
+     * @throws runtime_error if T does not match the scalar type of the file
+     */
+    template <typename T>
+    T *section(uint64_t offset) const;
+
+    template <typename T>
+    T *AL() const { return section<T>(info.offsetAL); }
+    template <typename T>
+    T *D() const { return section<T>(info.offsetD); }
+    template <typename T>
+    T *F() const { return hasF() ? section<T>(info.offsetF) : nullptr; }
+};
+
+/**
+ * @brief Maps a band file and returns AL as a BandMatrix view over the mapped pages.
+ *
+ * @param file Shared mapping, kept alive by the returned view
+ * @return Zero-copy view of the AL section
+ */
+template <typename T>
+BandMatrix<T> mapBandMatrix(const shared_ptr<MappedBandFile> &file);
+
+#endif // BandFile_HPP
@@ -0,0 +1,229 @@
+/**
+ * @file BandKernels.hpp
+ * @brief Substitution and multiplication kernels on LDLT factors in band storage.
+ *
+ * The kernels only read the band and the diagonal they are given, so they can be
+ * shared by SLAUSolverLDLT and by immutable factor objects used from many threads.
+ * T is the storage type and Acc the type every reduction accumulates in; the
+ * kernels are instantiated for the pairs listed in Precision.hpp.
+ */
+
+#ifndef BandKernels_HPP
+#define BandKernels_HPP
+
+#include <bits/stdc++.h>
+#include "BandMatrix.hpp"
+#include "Precision.hpp"
+#include "SimdKernels.hpp"
+using namespace std;
+
+/**
+ * @brief Bandwidth from which a single-vector sweep splits every row between threads.
+ *
+ * Each row then costs one or two barriers, which only pays off when the row
+ * holds enough work to hide them; narrower bands run the serial recurrence.
+ */
+constexpr int SWEEP_ROW_PARALLEL_MIN_BANDWIDTH = 1024;
+
+/**
+ * @brief Work n * (m + 1) * k from which a block sweep splits its columns between threads.
+ */
+constexpr double SWEEP_COLUMN_PARALLEL_MIN_WORK = 1 << 20;
+
+/**
+ * @brief Solves L * y = x in place for one vector.
+ *
+ * With threads > 1 and a bandwidth of at least SWEEP_ROW_PARALLEL_MIN_BANDWIDTH,
+ * the dot product of every row is split between the threads. Bandwidths with
+ * hasFixedBandKernel() run fixedBandForwardSubstitution() instead.
+ *
+ * @param L Unit lower triangular factor in band storage
+ * @param x Right-hand side of length L.rows(), overwritten with y
+ * @param threads Number of OpenMP threads
+ */
+template <typename T, typename Acc>
+void bandForwardSubstitution(const BandMatrix<T> &L, T *x, int threads = 1);
+
+/**
+ * @brief Solves D * z = y in place for one vector.
+ *
+ * The solves take the reciprocals of D, stored once per factorization, so every
+ * entry costs a multiplication instead of a division.
+ *
+ * @param inverseD Reciprocals 1 / D(i) of the diagonal factor
+ * @param n Length of the vector
+ * @param x Vector y, overwritten with z
+ */
+template <typename T>
+void bandDiagonalSubstitution(const T *inverseD, int n, T *x);
+
+/**
+ * @brief Solves L^T * x = z in place for one vector.
+ *
+ * Runs over the rows of L from the bottom up: once x(j) is final, row j of L
+ * is subtracted from the leading part of x with one axpy, so L is read along
+ * its rows as in the forward sweep instead of with stride m.
+ *
+ * @param L Unit lower triangular factor in band storage
+ * @param x Vector z, overwritten with x
+ * @param work Scratch of L.rows() partial sums, used when Acc is wider than T;
+ *             allocated by the kernel when null
+ * @param threads Number of OpenMP threads; the axpy of every row is split between
+ *                them from a bandwidth of SWEEP_ROW_PARALLEL_MIN_BANDWIDTH
+ */
+template <typename T, typename Acc>
+void bandBackwardSubstitution(const BandMatrix<T> &L, T *x, Acc *work = nullptr, int threads = 1);
+
+/**
+ * @brief Solves D * L^T * x = y in place for one vector, in a single sweep.
+ *
+ * Entry i is multiplied by 1 / D(i) right before the first row of L that updates it,
+ * so the result is bitwise equal to bandDiagonalSubstitution() followed by
+ * bandBackwardSubstitution(), without the extra pass over x. Both run
+ * fixedBandBackwardSubstitution() for bandwidths with hasFixedBandKernel().
+ *
+ * @param L Unit lower triangular factor in band storage
+ * @param inverseD Reciprocals 1 / D(i) of the diagonal factor
+ * @param x Vector y, overwritten with x
+ * @param work Scratch as in bandBackwardSubstitution()
+ * @param threads Number of OpenMP threads, as in bandBackwardSubstitution()
+ */
+template <typename T, typename Acc>
+void bandDiagonalBackwardSubstitution(const BandMatrix<T> &L, const T *inverseD, T *x, Acc *work = nullptr, int threads = 1);
+
+/**
+ * @brief Solves L * Y = B in place for a column-major block of k vectors.
+ *
+ * Row i of L is loaded once and applied to all k columns before moving on,
+ * so L is streamed from memory once per sweep.
+ *
+ * @param L Unit lower triangular factor in band storage
+ * @param block Column-major n x k block, overwritten with Y
+ * @param k Number of right-hand sides
+ * @param ld Leading dimension of the block (distance between columns, >= n)
+ * @param threads Number of OpenMP threads; the columns are split into one group per
+ *                thread once the work reaches SWEEP_COLUMN_PARALLEL_MIN_WORK
+ */
+template <typename T, typename Acc>
+void bandForwardSubstitution(const BandMatrix<T> &L, T *block, int k, int ld, int threads = 1);
+
+/**
+ * @brief Solves D * Z = Y in place for a column-major block of k vectors.
+ */
+template <typename T>
+void bandDiagonalSubstitution(const T *inverseD, int n, T *block, int k, int ld);
+
+/**
+ * @brief Solves L^T * X = Z in place for a column-major block of k vectors.
+ *
+ * Column i of L is gathered once into a contiguous buffer and applied to all
+ * k columns, so every entry of L is read once per sweep. The buffer holds
+ * L.bandwidth() entries per column group (one group per thread when the columns
+ * are split as in the forward sweep) and is allocated by the kernel when columnL is null.
+ */
+template <typename T, typename Acc>
+void bandBackwardSubstitution(const BandMatrix<T> &L, T *block, int k, int ld, T *columnL = nullptr, int threads = 1);
+
+/**
+ * @brief Solves D * L^T * X = Y in place for a column-major block of k vectors.
+ *
+ * Same sweep as bandBackwardSubstitution(), with entry i of every column multiplied
+ * by 1 / D(i) right before its row of L is applied.
+ */
+template <typename T, typename Acc>
+void bandDiagonalBackwardSubstitution(const BandMatrix<T> &L, const T *inverseD, T *block, int k, int ld,
+                                      T *columnL = nullptr, int threads = 1);
+
+/**
+ * @brief Returns the number of column groups a block sweep of k vectors runs with.
+ *
+ * The block backward sweeps need L.bandwidth() entries of columnL per group.
+ */
+int bandSweepColumnGroups(int n, int m, int k, int threads);
+
+/**
+ * @brief Scratch buffers of the kernels, reused across factorizations and solves.
+ *
+ * A buffer only grows, so once a workspace has seen the largest (n, m) of a
+ * sequence of systems, the kernels that take it run without heap allocations.
+ * One workspace may be shared by solvers that do not run at the same time.
+ */
+template <typename T, typename Acc>
+struct BandWorkspace
+{
+    vector<Acc> sums;  ///< n partial sums: backward sweep in Acc, residual r
+    vector<T> column;  ///< One gathered column of L
+    vector<Acc> panel; ///< Panel W = L * D of the blocked factorization, kept in Acc
+
+    /// Returns sums with room for at least n entries.
+    Acc *sumsFor(int n) { return grow(sums, size_t(n)); }
+
+    /// Returns column with room for at least m entries.
+    T *columnFor(int m) { return grow(column, size_t(m)); }
+
+    /// Returns panel with room for at least size entries.
+    Acc *panelFor(size_t size) { return grow(panel, size); }
+
+    /// Grows every buffer for systems up to size n, bandwidth m and panel width b.
+    void reserve(int n, int m, int b)
+    {
+        sumsFor(n);
+        columnFor(m);
+        panelFor(size_t(m) * b);
+    }
+
+private:
+    template <typename V>
+    static V *grow(vector<V> &buffer, size_t size)
+    {
+        if (buffer.size() < size)
+        {
+            buffer.resize(size);
+        }
+        return buffer.data();
+    }
+};
+
+/**
+ * @brief Norms of a residual r = f - A * x, computed in double.
+ */
+struct ResidualNorms
+{
+    double l2 = 0;       ///< ||r||_2
+    double inf = 0;      ///< ||r||_inf
+    double relative = 0; ///< ||r||_2 / ||f||_2 (||r||_2 when f is zero)
+};
+
+/**
+ * @brief Computes y = A * x for a symmetric band matrix A = AL + D + AL^T.
+ *
+ * Each stored entry is read once, so the cost is O(n * m). Products are
+ * accumulated in Acc. With one thread, row i is applied both as a dot product
+ * (lower part) and as an axpy into y (upper part). With several threads, every
+ * row gathers its upper part from column i instead, so the rows of y can be
+ * split between threads without write conflicts.
+ *
+ * @param AL Strictly lower band of A
+ * @param D Diagonal of A
+ * @param x Input vector of length n
+ * @param y Output vector of length n
+ * @param threads Number of OpenMP threads
+ */
+template <typename T, typename Acc>
+void bandMultiply(const BandMatrix<T> &AL, const T *D, const T *x, Acc *y, int threads = 1);
+
+/**
+ * @brief Computes r = f - A * x and its norms in O(n * m), without any I/O.
+ *
+ * @param AL Strictly lower band of A
+ * @param D Diagonal of A
+ * @param x Solution vector of length n
+ * @param f Right-hand side of length n
+ * @param r Output residual of length n
+ * @param threads Number of OpenMP threads
+ * @return l2, infinity and relative norms of r
+ */
+template <typename T, typename Acc>
+ResidualNorms bandResidual(const BandMatrix<T> &AL, const T *D, const T *x, const T *f, Acc *r, int threads = 1);
+
+#endif // BandKernels_HPP
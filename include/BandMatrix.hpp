@@ -0,0 +1,119 @@
+/**
+ * @file BandMatrix.hpp
+ * @brief Contiguous storage for the lower band of a symmetric matrix.
+ *
+ * All rows of the band live in one cache-line-aligned buffer. Row i keeps the
+ * entries A(i, j) for j in [i - m, i) at position m - i + j, which is the layout
+ * used by the text files in data/ and by every kernel of SLAUSolverLDLT.
+ */
+
+#ifndef BandMatrix_HPP
+#define BandMatrix_HPP
+
+#include <bits/stdc++.h>
+using namespace std;
+
+/**
+ * @class BandMatrix
+ * @brief Row-major band storage with one aligned allocation and padded row stride.
+ *
+ * The row stride is the bandwidth rounded up to the SIMD width (32 bytes) so that
+ * every row starts on a vector boundary. Bandwidths smaller than one SIMD register
+ * are rounded up to the next power of two only, which keeps tridiagonal and
+ * pentadiagonal matrices compact.
+ *
+ * @tparam T Scalar type of the stored entries
+ */
+template <typename T>
+class BandMatrix
+{
+private:
+    T *data;         ///< Aligned buffer holding n rows of stride elements
+    int n;           ///< Number of rows
+    int m;           ///< Bandwidth (number of stored entries per row)
+    int stride;      ///< Distance in elements between two consecutive rows
+    size_t capacity; ///< Number of elements allocated in data (0 for a view)
+    shared_ptr<const void> external; ///< Keeps borrowed storage alive when the matrix is a view
+
+    void release();
+
+public:
+    static constexpr size_t ALIGNMENT = 64;  ///< Alignment of the buffer in bytes (one cache line)
+    static constexpr size_t SIMD_BYTES = 32; ///< Row stride granularity in bytes
+
+    BandMatrix();
+
+    /**
+     * @brief Allocates a zero-filled band matrix.
+     *
+     * @param rows Number of rows
+     * @param bandwidth Number of stored entries per row
+     */
+    BandMatrix(int rows, int bandwidth);
+
+    BandMatrix(const BandMatrix &other);
+    BandMatrix(BandMatrix &&other) noexcept;
+    BandMatrix &operator=(const BandMatrix &other);
+    BandMatrix &operator=(BandMatrix &&other) noexcept;
+    ~BandMatrix();
+
+    /**
+     * @brief Computes the padded row stride used for a given bandwidth.
+     *
+     * @param bandwidth Number of stored entries per row
+     * @return Row stride in elements
+     */
+    static int paddedStride(int bandwidth);
+
+    /**
+     * @brief Changes the shape of the matrix and fills it with zeros.
+     *
+     * The owned buffer is reused whenever it holds rows * paddedStride(bandwidth)
+     * elements; it only grows, and a view always gets owned storage.
+     *
+     * @param rows Number of rows
+     * @param bandwidth Number of stored entries per row
+     */
+    void resize(int rows, int bandwidth);
+
+    /**
+     * @brief Turns the matrix into a view of storage it does not own.
+     *
+     * The storage must use the layout of paddedStride(bandwidth) and be aligned to
+     * ALIGNMENT bytes, e.g. the AL section of a memory-mapped band file.
+     * A later resize() or copy assignment allocates owned storage again.
+     *
+     * @param storage First element of row 0
+     * @param rows Number of rows
+     * @param bandwidth Number of stored entries per row
+     * @param owner Object that keeps storage alive for the lifetime of the view
+     */
+    void attach(T *storage, int rows, int bandwidth, shared_ptr<const void> owner);
+
+    /**
+     * @brief Tells whether the matrix borrows its storage through attach().
+     */
+    bool isView() const { return external != nullptr; }
+
+    /**
+     * @brief Sets every stored entry, padding included, to zero.
+     */
+    void fillZero();
+
+    /**
+     * @brief Returns a pointer to the first stored entry of row i.
+     *
+     * Entry A(i, j) of the band is at operator[](i)[m - i + j].
+     */
+    T *operator[](int i) { return data + size_t(i) * stride; }
+    const T *operator[](int i) const { return data + size_t(i) * stride; }
+
+    int rows() const { return n; }
+    int bandwidth() const { return m; }
+    int rowStride() const { return stride; }
+
+    T *raw() { return data; }
+    const T *raw() const { return data; }
+};
+
+#endif // BandMatrix_HPP
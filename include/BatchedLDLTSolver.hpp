@@ -0,0 +1,122 @@
+/**
+ * @file BatchedLDLTSolver.hpp
+ * @brief LDLT factorization and solve of many small band systems at once.
+ *
+ * Codes that assemble one small band system per mesh cell need the throughput of
+ * the whole batch, not the latency of one system. All systems of a batch share
+ * the size n and the bandwidth m and are stored structure-of-arrays: every band
+ * entry is a row of the pack holding that entry for all systems, so the kernels
+ * vectorize across systems and split the batch into chunks across OpenMP threads.
+ */
+
+#ifndef BatchedLDLTSolver_HPP
+#define BatchedLDLTSolver_HPP
+
+#include <bits/stdc++.h>
+#include <omp.h>
+#include "BandMatrix.hpp"
+#include "Precision.hpp"
+using namespace std;
+
+/**
+ * @class BatchedLDLTSolver
+ * @brief Structure-of-arrays pack of band systems with batched factor and solve.
+ *
+ * Entry A(i, j) of system s, j in [i - m, i), is at AL(i, m - i + j)[s], the
+ * diagonal at D(i)[s] and the right-hand side at F(i)[s]; each of these rows is
+ * aligned and padded like a BandMatrix row. factor() replaces AL and D with L and D
+ * of each system, solve() replaces F with the solution. The pack is allocated once
+ * by the constructor, neither call allocates.
+ *
+ * @tparam StorageT Scalar type of the pack
+ * @tparam AccumT Type the dot products accumulate in
+ */
+template <typename StorageT, typename AccumT>
+class BatchedLDLTSolver
+{
+public:
+    using floatingPointType = StorageT;
+    using sum = AccumT;
+
+    static constexpr int CHUNK = 64; ///< Systems processed together by one thread
+
+private:
+    int count;                            ///< Number of systems
+    int n;                                ///< Size of every system
+    int m;                                ///< Bandwidth of every system
+    BandMatrix<floatingPointType> packAL; ///< n * m rows of count entries, row i * m + p holds AL(i, p)
+    BandMatrix<floatingPointType> packD;  ///< n rows of count entries holding the diagonal
+    BandMatrix<floatingPointType> packF;  ///< n rows of count entries holding F, then X
+    int numThreads;                       ///< Number of threads used by factor() and solve()
+
+public:
+    /**
+     * @brief Allocates a zero-filled pack.
+     *
+     * @param systems Number of systems in the batch
+     * @param size Size n of every system
+     * @param bandwidth Bandwidth m of every system
+     */
+    BatchedLDLTSolver(int systems, int size, int bandwidth);
+
+    int systems() const { return count; }
+    int size() const { return n; }
+    int bandwidth() const { return m; }
+
+    /// Elements between two rows of the AL, D and F packs, the count rounded up to the row alignment.
+    int packStride() const { return packD.rowStride(); }
+
+    /**
+     * @brief Sets the number of OpenMP threads used across chunks of systems.
+     */
+    void setNumThreads(int threads);
+
+    /**
+     * @brief Returns the entries AL(i, p) of all systems, p = m - i + j.
+     */
+    floatingPointType *AL(int i, int p) { return packAL[i * m + p]; }
+    const floatingPointType *AL(int i, int p) const { return packAL[i * m + p]; }
+
+    /**
+     * @brief Returns the diagonal entries D(i) of all systems.
+     */
+    floatingPointType *D(int i) { return packD[i]; }
+    const floatingPointType *D(int i) const { return packD[i]; }
+
+    /**
+     * @brief Returns the entries F(i) of all systems.
+     */
+    floatingPointType *F(int i) { return packF[i]; }
+    const floatingPointType *F(int i) const { return packF[i]; }
+
+    /**
+     * @brief Copies one system from band storage into the pack.
+     *
+     * @param s Index of the system in the batch
+     * @param AL Strictly lower band of A, n rows of m entries
+     * @param D Diagonal of A, n entries
+     * @param F Right-hand side, n entries
+     */
+    void setSystem(int s, const BandMatrix<floatingPointType> &AL, const floatingPointType *D,
+                   const floatingPointType *F);
+
+    /**
+     * @brief Copies the solution of one system out of the pack.
+     *
+     * @param s Index of the system in the batch
+     * @param x Output of n entries
+     */
+    void getSolution(int s, floatingPointType *x) const;
+
+    /**
+     * @brief Factors every system of the pack in place into L and D.
+     */
+    void factor();
+
+    /**
+     * @brief Solves every factored system in place, F is overwritten with X.
+     */
+    void solve();
+};
+
+#endif // BatchedLDLTSolver_HPP
@@ -0,0 +1,161 @@
+/**
+ * @file DeviceBackend.hpp
+ * @brief Optional GPU backend (CUDA or HIP) for batched and multi-right-hand-side band solves.
+ *
+ * The device classes keep the band storage and the factors resident in device
+ * memory; a solve moves only the right-hand sides in and the solutions out.
+ * DeviceBatchedLDLTSolver runs one thread per system on the structure-of-arrays
+ * pack of BatchedLDLTSolver, so neighbouring threads read neighbouring entries.
+ * DeviceBandFactorization runs one block per right-hand side over the factors of
+ * one large system, its threads sharing the dot product of every row. It pays off
+ * with many right-hand sides and wide bands, since every column still walks the n
+ * rows in order.
+ *
+ * The kernels are in DeviceKernels.cu and are compiled by 'make CUDA=1' (nvcc)
+ * or 'make HIP=1' (hipcc). Every other build gets the same classes with
+ * constructors that throw, so callers can select the backend at run time.
+ */
+
+#ifndef DeviceBackend_HPP
+#define DeviceBackend_HPP
+
+#include <bits/stdc++.h>
+#include "BatchedLDLTSolver.hpp"
+#include "LDLTFactorization.hpp"
+using namespace std;
+
+/// Where the batched and multi-right-hand-side solves run.
+enum class ComputeBackend
+{
+    Cpu,  ///< The OpenMP and SIMD kernels of the host
+    Cuda, ///< DeviceKernels.cu built with nvcc
+    Hip   ///< DeviceKernels.cu built with hipcc
+};
+
+/**
+ * @brief Parses "cpu", "cuda" or "hip".
+ *
+ * @throws invalid_argument for any other name
+ */
+ComputeBackend parseComputeBackend(const string &name);
+
+const char *computeBackendName(ComputeBackend backend);
+
+/// The device backend this binary was built with, Cpu if none.
+ComputeBackend builtDeviceBackend();
+
+/**
+ * @brief Checks that a backend can run in this process.
+ *
+ * @throws runtime_error if the backend was not built in or no device is visible
+ */
+void requireComputeBackend(ComputeBackend backend);
+
+/**
+ * @class DeviceBatchedLDLTSolver
+ * @brief Device copy of a BatchedLDLTSolver pack with batched factor and solve.
+ *
+ * @tparam StorageT Scalar type of the pack
+ * @tparam AccumT Type the dot products accumulate in
+ */
+template <typename StorageT, typename AccumT>
+class DeviceBatchedLDLTSolver
+{
+public:
+    using floatingPointType = StorageT;
+    using sum = AccumT;
+    using Batch = BatchedLDLTSolver<StorageT, AccumT>;
+
+private:
+    int count;                         ///< Number of systems
+    int n;                             ///< Size of every system
+    int m;                             ///< Bandwidth of every system
+    size_t stride;                     ///< Elements between two rows of the pack, as on the host
+    floatingPointType *deviceAL;       ///< n * m rows of the pack, then L
+    floatingPointType *deviceD;        ///< n rows of the pack, then D
+    floatingPointType *deviceF;        ///< n rows of right-hand sides, then solutions
+
+public:
+    /**
+     * @brief Allocates the device pack and copies AL and D of every system to it.
+     *
+     * @param batch Host pack; its F rows are not copied
+     * @throws runtime_error if the backend is not built in or the device runs out of memory
+     */
+    explicit DeviceBatchedLDLTSolver(const Batch &batch);
+    ~DeviceBatchedLDLTSolver();
+
+    DeviceBatchedLDLTSolver(const DeviceBatchedLDLTSolver &) = delete;
+    DeviceBatchedLDLTSolver &operator=(const DeviceBatchedLDLTSolver &) = delete;
+
+    int systems() const { return count; }
+    int size() const { return n; }
+    int bandwidth() const { return m; }
+
+    /**
+     * @brief Factors every system in device memory, with the order of operations of BatchedLDLTSolver::factor().
+     */
+    void factor();
+
+    /**
+     * @brief Copies the F rows of a host pack in, solves every system and copies the solutions back to F.
+     *
+     * @param batch Host pack of the same shape; only its F rows are read and written
+     * @throws invalid_argument if the shape does not match
+     */
+    void solve(Batch &batch);
+};
+
+/**
+ * @class DeviceBandFactorization
+ * @brief Device copy of the factors of one band system for multi-right-hand-side solves.
+ *
+ * @tparam StorageT Scalar type of the factors
+ * @tparam AccumT Type the substitutions accumulate in
+ */
+template <typename StorageT, typename AccumT>
+class DeviceBandFactorization
+{
+public:
+    using floatingPointType = StorageT;
+    using sum = AccumT;
+    using Factorization = LDLTFactorization<StorageT, AccumT>;
+
+private:
+    int n;                              ///< Size of the system
+    int m;                              ///< Bandwidth of the system
+    size_t stride;                      ///< Elements between two rows of L, as on the host
+    floatingPointType *deviceL;         ///< L in band storage
+    floatingPointType *deviceInverseD;  ///< 1 / D(i)
+    floatingPointType *deviceBlock;     ///< Column-major right-hand sides, solved in place
+    int capacityColumns;                ///< Right-hand sides deviceBlock holds
+
+    /// Grows the right-hand side buffer to k columns.
+    void reserveColumns(int k);
+
+public:
+    /**
+     * @brief Copies L and 1 / D to the device.
+     *
+     * @throws runtime_error if the backend is not built in or the device runs out of memory
+     */
+    explicit DeviceBandFactorization(const Factorization &factors);
+    ~DeviceBandFactorization();
+
+    DeviceBandFactorization(const DeviceBandFactorization &) = delete;
+    DeviceBandFactorization &operator=(const DeviceBandFactorization &) = delete;
+
+    int size() const { return n; }
+    int bandwidth() const { return m; }
+
+    /**
+     * @brief Solves A * X = B for a column-major host block, like LDLTFactorization::solve(block, k, ld).
+     *
+     * @param block Column-major n x k block, overwritten with X
+     * @param k Number of right-hand sides
+     * @param ld Leading dimension of the block (>= n)
+     */
+    void solve(floatingPointType *block, int k, int ld);
+};
+
+#endif // DeviceBackend_HPP
@@ -0,0 +1,185 @@
+/**
+ * @file DistributedLDLTSolver.hpp
+ * @brief Distributed-memory LDLT solver that splits a band system into one row block per MPI rank.
+ *
+ * The rows are cut into p contiguous blocks. Rank r keeps its rows [begin, end);
+ * for r < p - 1 the last m of them form the separator S_r and the rest the
+ * interior I_r. Interiors of different ranks are more than m rows apart, so after
+ * ordering all interiors before all separators A has the arrow shape
+ *
+ *     | A_I   C   |
+ *     | C^T  A_S  |,   A_I = diag(A_I0, ..., A_I(p-1)),
+ *
+ * where C_r couples I_r only to S_(r-1) and S_r. The solve is SPIKE-style on a
+ * symmetric partition:
+ *
+ * 1. Every rank factors A_Ir = L D L^T with the band kernels of SLAUSolverLDLT and
+ *    solves for the spikes Y_r = A_Ir^-1 C_r (at most 2m columns).
+ * 2. Rank 0 gathers C_r^T Y_r and factors the Schur complement
+ *    A_S - sum C_r^T Y_r, a band system of order (p - 1) m and bandwidth 2m - 1.
+ * 3. A solve gathers C_r^T A_Ir^-1 F_Ir, solves the reduced system on rank 0,
+ *    broadcasts the separator unknowns and finishes x_Ir = A_Ir^-1 F_Ir - Y_r x_S
+ *    on every rank at once.
+ *
+ * Every rank maps the band file and touches only the pages of its own rows; the
+ * separator rows reach rank 0 inside the Schur contributions, so no rank holds
+ * the whole matrix. The spikes cost about twice the memory of the local band and
+ * four times the flops of the local factorization; the interface system costs
+ * O(p m^3) on rank 0.
+ *
+ * Built only with LDLT_USE_MPI ('make mpi').
+ */
+
+#ifndef DistributedLDLTSolver_HPP
+#define DistributedLDLTSolver_HPP
+
+#ifdef LDLT_USE_MPI
+
+#include <mpi.h>
+#include <bits/stdc++.h>
+#include "BandFile.hpp"
+#include "LDLTFactorization.hpp"
+#include "SLAUSolverLDLT.hpp"
+using namespace std;
+
+/**
+ * @brief Wall-clock seconds of the phases of a distributed solve, the maximum over all ranks.
+ */
+struct DistributedStats
+{
+    int ranks = 0;                 ///< Number of row blocks
+    int reducedSize = 0;           ///< Order (p - 1) m of the interface system
+    double localFactorSeconds = 0; ///< Factorization of the interior blocks
+    double spikeSeconds = 0;       ///< Spike solves and the local Schur contributions
+    double reducedSeconds = 0;     ///< Gather, assembly and factorization of the interface system
+    double solveSeconds = 0;       ///< Last solve(): reduction, interface solve and back-substitution
+};
+
+/**
+ * @class DistributedLDLTSolver
+ * @brief Factors and solves a band system from a band file on all ranks of a communicator.
+ *
+ * All member functions except the accessors are collective: every rank of the
+ * communicator must call them in the same order. An exception thrown on one rank
+ * leaves the others waiting, so callers should abort the communicator on error.
+ *
+ * @tparam StorageT Scalar type of the band file, the factors and the solution
+ * @tparam AccumT Type every reduction accumulates in
+ */
+template <typename StorageT, typename AccumT>
+class DistributedLDLTSolver
+{
+public:
+    using floatingPointType = StorageT;
+    using sum = AccumT;
+    using Solver = SLAUSolverLDLT<StorageT, AccumT>;
+    using Factorization = LDLTFactorization<StorageT, AccumT>;
+
+private:
+    MPI_Comm comm;
+    int rank;
+    int ranks;
+
+    shared_ptr<MappedBandFile> file; ///< Mapping of the whole file; only this rank's rows are read
+    int n;                           ///< Order of the global system
+    int m;                           ///< Bandwidth of the global system
+    int begin;                       ///< First row of this rank
+    int end;                         ///< One past the last row of this rank
+    int interiorEnd;                 ///< First separator row of this rank (end on the last rank)
+    int leftColumns;                 ///< Spike columns coupled to S_(r-1): m, or 0 on rank 0
+    int rightColumns;                ///< Spike columns coupled to S_r: m, or 0 on the last rank
+
+    shared_ptr<const Factorization> interior; ///< Factors of A_Ir
+    vector<floatingPointType> couplingLeft;   ///< C_r rows [begin, begin + m) x S_(r-1), column-major m x m
+    vector<floatingPointType> couplingRight;  ///< C_r rows [interiorEnd - m, interiorEnd) x S_r, column-major m x m
+    vector<floatingPointType> spikes;         ///< Y_r = A_Ir^-1 C_r, column-major (interiorEnd - begin) x columns
+    shared_ptr<const Factorization> reduced;  ///< Factors of the interface system, rank 0 only
+
+    vector<floatingPointType> solution; ///< x of rows [begin, end) after solve()
+    int numThreads;
+    DistributedStats timings;
+
+    /// Row i of A from the mapped file: the band at positions m - i + j, and A(i, i).
+    const floatingPointType *bandRow(int i) const;
+    floatingPointType diagonal(int i) const;
+
+    /// First row of rank r.
+    int blockBegin(int r) const { return int(int64_t(n) * r / ranks); }
+
+    /// C_r^T v for a vector v over the interior rows, in spike column order.
+    vector<sum> couplingTransposeTimes(const floatingPointType *v) const;
+
+    /// Gathers the 2m x 2m Schur contributions on rank 0 and factors the interface system there.
+    void factorReduced(const vector<sum> &schur);
+
+    /// Sums the 2m right-hand side contributions on rank 0, solves there and broadcasts x_S.
+    vector<floatingPointType> solveReduced(const vector<sum> &rhs) const;
+
+    /// Maximum of a per-rank time over all ranks.
+    double slowestRank(double seconds) const;
+
+public:
+    /**
+     * @brief Maps the band file on every rank and assigns the row blocks.
+     *
+     * @param communicator Ranks that share the system, one row block each
+     * @param bandFile Path to the band file, readable by every rank
+     * @param verifyChecksum Let every rank recompute the checksum over the whole file
+     * @throws invalid_argument if a block would have fewer than 2m rows
+     */
+    DistributedLDLTSolver(MPI_Comm communicator, const string &bandFile, bool verifyChecksum = false);
+
+    /**
+     * @brief Threads of the local factorization and solves on every rank.
+     *
+     * @param threads Thread count; 0 selects omp_get_max_threads()
+     */
+    void setNumThreads(int threads);
+
+    /**
+     * @brief Factors the interior blocks, computes the spikes and factors the interface system.
+     */
+    void factorize();
+
+    /**
+     * @brief Solves A * x = F for the F section of the band file.
+     *
+     * @throws runtime_error if the file has no F section
+     * @throws logic_error if factorize() has not run
+     */
+    void solve();
+
+    /**
+     * @brief Solves A * x = F for this rank's rows of F.
+     *
+     * @param localF F(i) for i in [firstRow(), lastRow())
+     * @throws logic_error if factorize() has not run
+     */
+    void solve(const floatingPointType *localF);
+
+    /**
+     * @brief Writes the solution of all ranks to one file; rank 0 writes, the others send their rows.
+     *
+     * Rank 0 keeps one block of rows in memory at a time.
+     *
+     * @param filePath Output path on rank 0
+     * @param format Text (one value per line) or a binary vector file
+     */
+    void writeSolution(const string &filePath, SolutionFormat format) const;
+
+    /// Rows of this rank are [firstRow(), lastRow()).
+    int firstRow() const { return begin; }
+    int lastRow() const { return end; }
+    int size() const { return n; }
+    int bandwidth() const { return m; }
+
+    /// x(i) for i in [firstRow(), lastRow()) after solve().
+    const vector<floatingPointType> &localSolution() const { return solution; }
+
+    /// Phase times of the last factorize() and solve(), identical on every rank.
+    const DistributedStats &stats() const { return timings; }
+};
+
+#endif // LDLT_USE_MPI
+
+#endif // DistributedLDLTSolver_HPP
@@ -0,0 +1,67 @@
+/**
+ * @file FixedBandKernels.hpp
+ * @brief Factorization and substitution kernels with the bandwidth as a compile-time constant.
+ *
+ * For the narrow bands that dominate in practice (tridiagonal, pentadiagonal,
+ * ...) the generic kernels spend more on the max(0, i - m) bounds and index
+ * arithmetic than on the arithmetic itself. These kernels take m as a template
+ * parameter: the leading m rows run with bounds, every later row runs fully
+ * unrolled loops, and the last m rows of L, D and the partial sums are carried
+ * in registers from row to row. m = 1 uses the Thomas recurrences.
+ *
+ * Every entry sees the same operations in the same order as in the generic
+ * kernels, so the results are bitwise equal for m <= 4. For m = 8 the generic
+ * kernels switch to SIMD dot products, which sum in a different order.
+ */
+
+#ifndef FixedBandKernels_HPP
+#define FixedBandKernels_HPP
+
+#include <bits/stdc++.h>
+#include "BandMatrix.hpp"
+#include "NumericalHealth.hpp"
+#include "Precision.hpp"
+using namespace std;
+
+/**
+ * @brief Whether the bandwidth has a specialized kernel (1, 2, 3, 4 or 8).
+ */
+constexpr bool hasFixedBandKernel(int m)
+{
+    return m == 1 || m == 2 || m == 3 || m == 4 || m == 8;
+}
+
+/**
+ * @brief Factors the rows [firstRow, n) of A = L * D * L^T in place, left-looking.
+ *
+ * Rows before firstRow must already hold their L and D.
+ *
+ * @param AL Strictly lower band of A, overwritten with L
+ * @param D Diagonal of A, overwritten with D
+ * @param firstRow First row to factor
+ * @param pivots Monitor that sees every new pivot and may stop the factorization after it, or nullptr
+ * @throws invalid_argument if hasFixedBandKernel(AL.bandwidth()) is false
+ */
+template <typename T, typename Acc>
+void fixedBandFactorization(BandMatrix<T> &AL, T *D, int firstRow = 0, PivotMonitor *pivots = nullptr);
+
+/**
+ * @brief Solves L * y = x in place for one vector.
+ *
+ * @throws invalid_argument if hasFixedBandKernel(L.bandwidth()) is false
+ */
+template <typename T, typename Acc>
+void fixedBandForwardSubstitution(const BandMatrix<T> &L, T *x);
+
+/**
+ * @brief Solves L^T * x = z, or D * L^T * x = y when inverseD is given, in place for one vector.
+ *
+ * @param L Unit lower triangular factor in band storage
+ * @param inverseD Reciprocals 1 / D(i) of the diagonal factor, or nullptr
+ * @param x Right-hand side, overwritten with x
+ * @throws invalid_argument if hasFixedBandKernel(L.bandwidth()) is false
+ */
+template <typename T, typename Acc>
+void fixedBandBackwardSubstitution(const BandMatrix<T> &L, const T *inverseD, T *x);
+
+#endif // FixedBandKernels_HPP
@@ -0,0 +1,127 @@
+/**
+ * @file Instrumentation.hpp
+ * @brief Per-phase timers with analytic FLOP and byte counters for the hot paths.
+ *
+ * The solver marks its phases (parsing, factorization, each sweep, writing the
+ * solution) with LDLT_PHASE. When the code is built with -DLDLT_INSTRUMENT, every
+ * marked scope adds its wall time, floating-point operations and bytes touched to
+ * a process-wide table; otherwise the macro expands to nothing and its arguments
+ * are not evaluated. Builds with -DLDLT_USE_ITT additionally open an ITT task per
+ * phase (VTune), and user hooks can forward the phase boundaries to any other tool,
+ * e.g. the control FIFO of perf record or LIKWID markers.
+ */
+
+#ifndef Instrumentation_HPP
+#define Instrumentation_HPP
+
+#include <bits/stdc++.h>
+using namespace std;
+
+/**
+ * @brief Accumulated counters of one phase.
+ */
+struct PhaseRecord
+{
+    string name;        ///< Phase name
+    size_t calls = 0;   ///< Number of times the phase ran
+    double seconds = 0; ///< Total wall time
+    double flops = 0;   ///< Total floating-point operations (analytic)
+    double bytes = 0;   ///< Total bytes read and written (analytic)
+};
+
+/**
+ * @class Instrumentation
+ * @brief Process-wide table of phase counters.
+ *
+ * Phases are recorded in the order they first run. Recording takes a lock once
+ * per phase, never inside a kernel loop; phases may run on several threads.
+ */
+class Instrumentation
+{
+public:
+    /// Called with the phase name when a phase begins or ends.
+    using PhaseHook = void (*)(const char *name);
+
+    /**
+     * @brief Whether the build records phases (-DLDLT_INSTRUMENT).
+     */
+    static constexpr bool enabled()
+    {
+#ifdef LDLT_INSTRUMENT
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    /**
+     * @brief Adds one run of a phase to the table.
+     */
+    static void record(const char *name, double seconds, double flops, double bytes);
+
+    /**
+     * @brief Returns a copy of the table.
+     */
+    static vector<PhaseRecord> phases();
+
+    /**
+     * @brief Clears the table.
+     */
+    static void reset();
+
+    /**
+     * @brief Writes the table as JSON, with GFLOP/s and GB/s per phase.
+     */
+    static void writeJson(ostream &out);
+
+    /**
+     * @brief Installs callbacks run at the boundaries of every phase; null removes them.
+     */
+    static void setPhaseHooks(PhaseHook begin, PhaseHook end);
+
+    /**
+     * @brief Returns the size of a file in bytes, or 0 if it cannot be queried.
+     */
+    static double fileBytes(const string &filePath);
+
+private:
+    friend class ScopedPhase;
+
+    static atomic<PhaseHook> beginHook;
+    static atomic<PhaseHook> endHook;
+};
+
+/**
+ * @class ScopedPhase
+ * @brief Times the enclosing scope and records it on destruction.
+ */
+class ScopedPhase
+{
+private:
+    const char *name;
+    double flops;
+    double bytes;
+    chrono::steady_clock::time_point start;
+
+public:
+    ScopedPhase(const char *phaseName, double phaseFlops, double phaseBytes);
+    ~ScopedPhase();
+
+    ScopedPhase(const ScopedPhase &) = delete;
+    ScopedPhase &operator=(const ScopedPhase &) = delete;
+
+    /// Replaces the byte count, for phases whose traffic is only known at the end.
+    void setBytes(double phaseBytes) { bytes = phaseBytes; }
+};
+
+#ifdef LDLT_INSTRUMENT
+/// Records the rest of the enclosing scope as one run of the phase.
+#define LDLT_PHASE(name, flops, bytes) ScopedPhase ldltPhase((name), double(flops), double(bytes))
+/// Replaces the byte count of the phase opened by LDLT_PHASE in this scope.
+#define LDLT_PHASE_BYTES(bytes) ldltPhase.setBytes(double(bytes))
+#else
+#define LDLT_PHASE(name, flops, bytes) ((void)0)
+#define LDLT_PHASE_BYTES(bytes) ((void)0)
+#endif
+
+#endif // Instrumentation_HPP
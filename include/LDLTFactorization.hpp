@@ -0,0 +1,137 @@
+/**
+ * @file LDLTFactorization.hpp
+ * @brief Immutable LDLT factors of a symmetric band matrix.
+ *
+ * A factorization is produced once by SLAUSolverLDLT::factorize() and can then be
+ * shared between threads. Every solve works on a workspace owned by the caller,
+ * so concurrent solves never touch shared mutable state.
+ */
+
+#ifndef LDLTFactorization_HPP
+#define LDLTFactorization_HPP
+
+#include <bits/stdc++.h>
+#include "BandKernels.hpp"
+#include "BandMatrix.hpp"
+#include "Precision.hpp"
+using namespace std;
+
+/**
+ * @class LDLTFactorization
+ * @brief Read-only L and D factors, optionally with a copy of the original matrix A.
+ *
+ * @tparam StorageT Scalar type of the factors
+ * @tparam AccumT Type the solves and residuals accumulate in
+ */
+template <typename StorageT, typename AccumT>
+class LDLTFactorization
+{
+public:
+    using floatingPointType = StorageT;
+    using sum = AccumT;
+    using Workspace = BandWorkspace<StorageT, AccumT>;
+
+private:
+    BandMatrix<floatingPointType> factorL;   ///< Unit lower triangular factor in band storage
+    vector<floatingPointType> factorD;       ///< Diagonal factor
+    vector<floatingPointType> inverseD;      ///< 1 / D(i), used by the solves
+    BandMatrix<floatingPointType> originalAL; ///< Strictly lower band of A (empty unless kept)
+    vector<floatingPointType> originalD;     ///< Diagonal of A (empty unless kept)
+    bool originalKept;                       ///< Whether originalAL and originalD hold A
+
+    /// Fills inverseD from factorD.
+    void invertDiagonal();
+
+public:
+    /**
+     * @brief Takes ownership of the factors without a copy of A.
+     *
+     * @param L Unit lower triangular factor in band storage
+     * @param D Diagonal factor
+     */
+    LDLTFactorization(BandMatrix<floatingPointType> &&L, vector<floatingPointType> &&D);
+
+    /**
+     * @brief Takes ownership of the factors and of a copy of A for residual checks.
+     *
+     * @param L Unit lower triangular factor in band storage
+     * @param D Diagonal factor
+     * @param AL Strictly lower band of A
+     * @param AD Diagonal of A
+     */
+    LDLTFactorization(BandMatrix<floatingPointType> &&L, vector<floatingPointType> &&D,
+                      BandMatrix<floatingPointType> &&AL, vector<floatingPointType> &&AD);
+
+    int size() const { return factorL.rows(); }
+    int bandwidth() const { return factorL.bandwidth(); }
+    bool hasOriginal() const { return originalKept; }
+
+    const BandMatrix<floatingPointType> &L() const { return factorL; }
+    const vector<floatingPointType> &D() const { return factorD; }
+
+    /**
+     * @brief Whether the kept copy of A equals the given matrix entry by entry.
+     *
+     * @param AL Strictly lower band of a matrix, compared over all m positions of every row
+     * @param AD Diagonal of the matrix
+     * @throws logic_error if the factorization was created without the original matrix
+     */
+    bool matchesOriginal(const BandMatrix<floatingPointType> &AL, const vector<floatingPointType> &AD) const;
+
+    /**
+     * @brief Solves A * x = f in place.
+     *
+     * @param x Workspace of length size() holding f, overwritten with x
+     */
+    void solve(floatingPointType *x) const;
+
+    /**
+     * @brief Solves A * x = f in place with the scratch of a caller-owned workspace.
+     *
+     * Does not allocate once the workspace has grown to size(), which the
+     * float-double backward sweep needs for its partial sums.
+     *
+     * @param x Vector of length size() holding f, overwritten with x
+     * @param workspace Scratch owned by the calling thread
+     */
+    void solve(floatingPointType *x, Workspace &workspace) const;
+
+    /**
+     * @brief Solves A * x = f in place.
+     *
+     * @param x Workspace holding f, overwritten with x
+     */
+    void solve(vector<floatingPointType> &x) const;
+
+    /**
+     * @brief Solves A * X = B in place for a column-major block of k right-hand sides.
+     *
+     * @param block Column-major n x k block, overwritten with X
+     * @param k Number of right-hand sides
+     * @param ld Leading dimension of the block (>= n)
+     */
+    void solve(floatingPointType *block, int k, int ld) const;
+
+    /**
+     * @brief Solves A * X = B in place with the scratch of a caller-owned workspace.
+     *
+     * @param block Column-major n x k block, overwritten with X
+     * @param k Number of right-hand sides
+     * @param ld Leading dimension of the block (>= n)
+     * @param workspace Scratch owned by the calling thread
+     */
+    void solve(floatingPointType *block, int k, int ld, Workspace &workspace) const;
+
+    /**
+     * @brief Computes the residual r = f - A * x with the kept copy of A.
+     *
+     * @param x Solution vector
+     * @param f Right-hand side
+     * @param r Output residual of length size()
+     * @return l2, infinity and relative norms of r
+     * @throws logic_error if the factorization was created without the original matrix
+     */
+    ResidualNorms residual(const floatingPointType *x, const floatingPointType *f, sum *r) const;
+};
+
+#endif // LDLTFactorization_HPP
@@ -0,0 +1,127 @@
+/**
+ * @file NumericalHealth.hpp
+ * @brief Pivot monitoring during the factorization and a 1-norm condition estimator.
+ *
+ * A zero, negative or tiny pivot D(i) does not stop the factorization by itself;
+ * it turns later rows and the solution into inf/NaN. The factorization kernels
+ * therefore hand every final pivot to a PivotMonitor while it is still in a
+ * register, which keeps min |D| and max |D| and can stop the kernel at the first
+ * pivot at or below a threshold. estimateSymmetricOneNorm() is the Hager / Higham
+ * estimator used for ||A^-1||_1: a handful of solves with the existing factors,
+ * O(n * m) in total.
+ */
+
+#ifndef NumericalHealth_HPP
+#define NumericalHealth_HPP
+
+#include <bits/stdc++.h>
+using namespace std;
+
+/**
+ * @brief Pivot statistics of a factorization.
+ */
+struct PivotReport
+{
+    int rowsChecked = 0;                                     ///< Pivots seen
+    double minAbsPivot = numeric_limits<double>::infinity(); ///< Smallest |D(i)|
+    double maxAbsPivot = 0;                                  ///< Largest |D(i)|
+    int badPivots = 0;                                       ///< Pivots at or below the threshold, or NaN
+    int firstBadPivot = -1;                                  ///< Row of the first bad pivot, -1 if none
+
+    /// Whether no pivot was at or below the threshold.
+    bool healthy() const { return badPivots == 0; }
+
+    /// max |D| / min |D|, a cheap lower bound on the condition number of D.
+    double pivotRatio() const { return minAbsPivot > 0 ? maxAbsPivot / minAbsPivot : numeric_limits<double>::infinity(); }
+};
+
+/**
+ * @class PivotMonitor
+ * @brief Collects a PivotReport pivot by pivot and decides when to stop.
+ *
+ * A pivot is bad when it is not greater than the threshold (NaN included).
+ * The default threshold 0 flags the pivots that make A not positive definite.
+ */
+class PivotMonitor
+{
+private:
+    double threshold = 0;
+    bool abortOnBadPivot = false;
+    PivotReport stats;
+
+public:
+    PivotMonitor() = default;
+
+    /**
+     * @param minimumPivot Pivots <= minimumPivot count as bad
+     * @param abort Whether the factorization stops at the first bad pivot
+     */
+    PivotMonitor(double minimumPivot, bool abort) : threshold(minimumPivot), abortOnBadPivot(abort) {}
+
+    /**
+     * @brief Records the final pivot D(row).
+     *
+     * @return true when the factorization should stop here
+     */
+    template <typename T>
+    bool observe(int row, T pivot)
+    {
+        double value = double(pivot);
+        double magnitude = fabs(value);
+        ++stats.rowsChecked;
+        stats.minAbsPivot = min(stats.minAbsPivot, magnitude);
+        stats.maxAbsPivot = max(stats.maxAbsPivot, magnitude);
+        if (value > threshold)
+        {
+            return false;
+        }
+        ++stats.badPivots;
+        if (stats.firstBadPivot < 0 || row < stats.firstBadPivot)
+        {
+            stats.firstBadPivot = row;
+        }
+        return abortOnBadPivot;
+    }
+
+    /// Adds the pivots seen by another monitor, e.g. one per thread.
+    void merge(const PivotMonitor &other);
+
+    /// Clears the statistics and keeps the threshold and the abort setting.
+    void reset() { stats = PivotReport(); }
+
+    /// Whether the factorization was stopped at a bad pivot.
+    bool stopped() const { return abortOnBadPivot && stats.badPivots > 0; }
+
+    double minimumPivot() const { return threshold; }
+    bool abortsOnBadPivot() const { return abortOnBadPivot; }
+    const PivotReport &report() const { return stats; }
+};
+
+/**
+ * @brief 1-norm condition estimate kappa_1(A) = ||A||_1 * ||A^-1||_1.
+ */
+struct ConditionEstimate
+{
+    double normA = 0;        ///< ||A||_1
+    double normInverse = 0;  ///< Estimate of ||A^-1||_1 (a lower bound, usually within a factor of 3)
+    double condition = 0;    ///< normA * normInverse
+    bool exactNormA = false; ///< Whether normA was computed from A itself rather than estimated from the factors
+
+    /// Decimal digits a solve in the given unit roundoff can be expected to get right.
+    double expectedDigits(double unitRoundoff) const { return -log10(condition * unitRoundoff); }
+};
+
+/**
+ * @brief Estimates ||B||_1 of a symmetric operator from products with B (Higham, 1988).
+ *
+ * Runs at most five power-like steps with sign vectors plus one extra probe with an
+ * alternating vector, so apply is called at most 11 times.
+ *
+ * @param n Order of B
+ * @param apply Overwrites its argument x of length n with B * x
+ * @return A lower bound on ||B||_1
+ */
+template <typename T>
+double estimateSymmetricOneNorm(int n, const function<void(T *)> &apply);
+
+#endif // NumericalHealth_HPP
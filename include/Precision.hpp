@@ -0,0 +1,92 @@
+/**
+ * @file Precision.hpp
+ * @brief Storage / accumulator pairs the solver is instantiated for, and their runtime selection.
+ *
+ * Every solver class is a template on a storage type (matrix and vectors) and an
+ * accumulator type (every reduction). Three pairs are instantiated: float/float,
+ * double/double and float/double. One binary contains all three, and
+ * dispatchPrecision() calls the instantiation chosen at run time.
+ */
+
+#ifndef Precision_HPP
+#define Precision_HPP
+
+#include <bits/stdc++.h>
+using namespace std;
+
+/// Storage / accumulator pairs available at run time.
+enum class Precision
+{
+    Float,      ///< float storage, float accumulation
+    Double,     ///< double storage, double accumulation
+    FloatDouble ///< float storage, double accumulation
+};
+
+/// Significant decimal digits printed for a storage type.
+template <typename T>
+constexpr int precisionDigits = is_same_v<T, float> ? 7 : 15;
+
+/// Type tag passed by dispatchPrecision() to the selected callback.
+template <typename StorageT, typename AccumT>
+struct PrecisionPair
+{
+    using Storage = StorageT;
+    using Accum = AccumT;
+};
+
+/**
+ * @brief Parses "float", "double" or "float_double" (also "ff", "dd", "fd").
+ *
+ * @throws invalid_argument for any other name
+ */
+inline Precision parsePrecision(const string &name)
+{
+    if (name == "float" || name == "ff")
+    {
+        return Precision::Float;
+    }
+    if (name == "double" || name == "dd")
+    {
+        return Precision::Double;
+    }
+    if (name == "float_double" || name == "fd")
+    {
+        return Precision::FloatDouble;
+    }
+    throw invalid_argument("Unknown precision '" + name + "' (expected float, double or float_double)");
+}
+
+inline const char *precisionName(Precision precision)
+{
+    switch (precision)
+    {
+    case Precision::Float:
+        return "float";
+    case Precision::Double:
+        return "double";
+    default:
+        return "float_double";
+    }
+}
+
+/**
+ * @brief Calls f(PrecisionPair<Storage, Accum>{}) for the selected precision.
+ *
+ * Each branch is a separate, fully specialized instantiation of f, so the
+ * dispatch costs one switch per call and nothing inside the kernels.
+ */
+template <typename F>
+decltype(auto) dispatchPrecision(Precision precision, F &&f)
+{
+    switch (precision)
+    {
+    case Precision::Float:
+        return f(PrecisionPair<float, float>{});
+    case Precision::Double:
+        return f(PrecisionPair<double, double>{});
+    default:
+        return f(PrecisionPair<float, double>{});
+    }
+}
+
+#endif // Precision_HPP
@@ -11,31 +11,77 @@
 
 #include <bits/stdc++.h>
 #include <omp.h>
+#include "BandFile.hpp"
+#include "BandKernels.hpp"
+#include "BandMatrix.hpp"
+#include "FixedBandKernels.hpp"
+#include "Instrumentation.hpp"
+#include "LDLTFactorization.hpp"
+#include "NumericalHealth.hpp"
+#include "Precision.hpp"
+#include "SimdKernels.hpp"
+#include "TextParser.hpp"
 using namespace std;
 
-#if defined(FF)
-typedef float floatingPointType;
-typedef float sum;
-constexpr int PRECISION_DIGITS = 7;
-#elif defined(DD)
-typedef double floatingPointType;
-typedef double sum;
-constexpr int PRECISION_DIGITS = 15;
-#elif defined(FD)
-typedef float floatingPointType;
-typedef double sum;
-constexpr int PRECISION_DIGITS = 7;
-#endif
+/**
+ * @brief Factorization kernels selectable through SLAUSolverLDLT::setFactorizationKernel().
+ */
+enum class FactorizationKernel
+{
+    Auto,      ///< Fixed for m = 1, 2, 3, 4, 8, Blocked for wide bands, Wavefront with several threads, Serial otherwise
+    Serial,    ///< performLDLtDecompositionSerial()
+    Wavefront, ///< performLDLtDecompositionWavefront()
+    Blocked,   ///< performLDLtDecompositionBlocked()
+    Fixed      ///< fixedBandFactorization(), only for bandwidths with hasFixedBandKernel()
+};
+
+/**
+ * @brief File formats of the solution written by SLAUSolverLDLT::writeVectorFToFile().
+ */
+enum class SolutionFormat
+{
+    Text,  ///< One value per line in fixed notation (TextRowWriter)
+    Binary ///< Raw vector in a band file with layout BandLayout::Vector
+};
+
+/**
+ * @brief Parses "text" or "binary".
+ *
+ * @throws invalid_argument for any other name
+ */
+SolutionFormat parseSolutionFormat(const string &name);
+
+/**
+ * @brief Outcome of SLAUSolverLDLT::solveWithRefinement().
+ */
+struct RefinementReport
+{
+    int iterations = 0;            ///< Correction steps in the returned solution after the initial float solve
+    double residualNorm = 0;       ///< ||F - A * x||_2 of the returned solution, computed in double
+    double relativeResidual = 0;   ///< residualNorm / ||F||_2
+    bool converged = false;        ///< Whether relativeResidual reached the tolerance
+};
 
 /**
  * @class SLAUSolverLDLT
  * @brief A class for solving SLAE using LDLT decomposition with a banded matrix format.
+ *
+ * @tparam StorageT Scalar type of the matrix and vectors (float or double)
+ * @tparam AccumT Type every reduction accumulates in (same as StorageT, or double for float storage)
  */
+template <typename StorageT, typename AccumT>
 class SLAUSolverLDLT
 {
+public:
+    using floatingPointType = StorageT; ///< Storage type of the matrix and vectors
+    using sum = AccumT;                 ///< Accumulator type of every reduction
+    using Factorization = LDLTFactorization<StorageT, AccumT>;
+    using Workspace = BandWorkspace<StorageT, AccumT>;
+
 private:
-    vector<vector<floatingPointType>> matrixAL; ///< The lower triangular matrix in banded form (L)
+    BandMatrix<floatingPointType> matrixAL;     ///< The lower triangular matrix in banded form (L)
     vector<floatingPointType> diagD;            ///< The diagonal matrix (D)
+    vector<floatingPointType> inverseD;         ///< 1 / D(i) of the factored rows, used by the solves
     vector<floatingPointType> vectorF;          ///< Vector used for solving the system
 
     int n; ///< The size of the system (number of equations)
@@ -44,11 +90,73 @@ private:
     string solveFilePath; ///< Path to the file for output results
     string AlFilePath;    ///< Path to the file containing matrix A (banded part)
     string DFilePath;     ///< Path to the file containing diagonal matrix D
+    string bandFilePath;  ///< Path to the binary band file, if the system was loaded from one
+
+    BandMatrix<floatingPointType> snapshotAL; ///< Copy of the band of A taken before factoring
+    vector<floatingPointType> snapshotD;       ///< Copy of the diagonal of A taken before factoring
+    bool keepSnapshot = false;                 ///< Take the snapshot in performLDLtDecomposition()
+    bool snapshotValid = false;                ///< snapshotAL and snapshotD hold the current A
+    bool factored = false;                     ///< matrixAL and diagD hold L and D instead of A
+    int factoredRows = 0;                      ///< Leading rows whose L and D match the current A
+    bool handedOver = false;                   ///< factorize() moved matrixAL and diagD out; returnMatix() restores them
+
+    int numThreads = 1;                                   ///< Number of OpenMP threads used by the factorization
+    FactorizationKernel kernel = FactorizationKernel::Auto; ///< Kernel run by performLDLtDecomposition()
+    int blockSize = 32;                                   ///< Panel width of the blocked kernel
+    PivotMonitor pivots;                                  ///< Pivot statistics of the last factorization
+    shared_ptr<Workspace> workspace = make_shared<Workspace>(); ///< Scratch of the kernels, kept across systems
+
+    SolutionFormat solutionFormat = SolutionFormat::Text; ///< Format of writeVectorFToFile()
+    vector<floatingPointType> pendingSolution;            ///< Copy of F being written in the background
+    future<void> pendingWrite;                            ///< Background write, joined before the next write
+
+    /// Smallest bandwidth for which the Auto kernel selects the blocked factorization.
+    /// The serial kernel runs full-length SIMD row dots, which match the blocked
+    /// kernel's bandDot4() updates up to m = 256 and lose from about m = 512.
+    static constexpr int BLOCKED_MIN_BANDWIDTH = 512;
+
+    template <typename, typename>
+    friend class SLAUSolverLDLT;
+
+    /// Marks A as replaced: it is no longer factored and any snapshot is stale.
+    void matrixChanged();
+
+    /**
+     * @brief Checks that matrixAL and diagD still belong to the solver.
+     *
+     * @throws logic_error after factorize() until returnMatix() or a new system refills them
+     */
+    void requireOwnStorage() const;
+
+    /// Band of A: matrixAL, or the snapshot once matrixAL holds L.
+    const BandMatrix<floatingPointType> &originalAL() const;
+
+    /// Diagonal of A: diagD, or the snapshot once diagD holds D.
+    const vector<floatingPointType> &originalD() const;
+
+    /// Computes row j of L and D(j) left-looking, from rows [j - m, j) of the factors.
+    void factorRow(int j);
+
+    /// Recomputes inverseD for the rows [first, last) after their D changed.
+    void invertDiagonal(int first, int last);
+
+    /// Clears the pivot report and records the stored pivots of rows [0, rows).
+    void restartPivotReport(int rows);
+
+    /// After a kernel returned: throws runtime_error if it stopped at a bad pivot, keeping the rows before it.
+    void checkPivotAbort(int firstRow);
+
+    /// Writes count values of x to solveFilePath in solutionFormat; safe on the background thread.
+    void writeSolution(const floatingPointType *x, size_t count) const;
 
 public:
     /**
      * @brief Initializes the matrix size and allocates memory.
      *
+     * matrixAL, diagD and vectorF are zero-filled. Their storage is kept when the
+     * new system is not larger than the previous one, so a time-stepping loop that
+     * re-initializes the same solver runs without heap allocations.
+     *
      * @param a Number of equations (matrix size)
      * @param b Matrix bandwidth
      */
@@ -69,6 +177,46 @@ public:
                    const string &fFilePath,
                    const string &outputFilePath);
 
+    /**
+     * @brief Constructor that allocates an empty n x n system with bandwidth m.
+     *
+     * The system is meant to be filled by one of the generators, e.g. HilbertBandMatrix().
+     *
+     * @param a Number of equations (matrix size)
+     * @param b Matrix bandwidth
+     * @param outputFilePath Path to the file for saving the solution
+     */
+    SLAUSolverLDLT(int a, int b, const string &outputFilePath);
+
+    /**
+     * @brief Constructor that maps a binary band file (see BandFile.hpp).
+     *
+     * matrixAL becomes a view of the mapped AL section, so no parsing or copying
+     * of the band takes place. The mapping is private: factorization modifies
+     * pages in memory only, never the file.
+     *
+     * @param bandFile Path to the binary band file
+     * @param outputFilePath Path to the file for saving the solution
+     * @param verifyChecksum Recompute the checksum of the file before using it
+     */
+    SLAUSolverLDLT(const string &bandFile, const string &outputFilePath, bool verifyChecksum = true);
+
+    /**
+     * @brief Maps AL and D (and F when loadF is set) from a binary band file.
+     *
+     * @param filePath Path to the binary band file
+     * @param loadF Also copy the F section into vectorF
+     * @param verifyChecksum Recompute the checksum of the file before using it
+     */
+    void loadFromBandFile(const string &filePath, bool loadF, bool verifyChecksum = true);
+
+    /**
+     * @brief Writes matrixAL, diagD and vectorF to a binary band file.
+     *
+     * @param filePath Output path
+     */
+    void saveToBandFile(const string &filePath) const;
+
     /**
      * @brief Loads matrix dimensions from a file.
      *
@@ -84,7 +232,7 @@ public:
      * @param filePath Path to the file containing the matrix
      * @param matrix Reference to the matrix where data will be stored
      */
-    void loadFromFile(const string &filePath, vector<vector<floatingPointType>> &matrix);
+    void loadFromFile(const string &filePath, BandMatrix<floatingPointType> &matrix);
 
     /**
      * @brief Loads a vector from a file.
@@ -100,9 +248,238 @@ public:
      * Decomposes the matrix A into L, D, and L^T where:
      * L - Lower triangular matrix
      * D - Diagonal matrix A
+     *
+     * Runs the kernel chosen with setFactorizationKernel(). The Auto kernel uses
+     * fixedBandFactorization() when hasFixedBandKernel(m), otherwise
+     * performLDLtDecompositionBlocked() when m >= BLOCKED_MIN_BANDWIDTH (with any
+     * number of threads, since its trailing update is split by rows),
+     * performLDLtDecompositionWavefront() when more than one thread is configured,
+     * and performLDLtDecompositionSerial() otherwise.
+     *
+     * @throws invalid_argument if the Fixed kernel is selected for an unsupported m
      */
     void performLDLtDecomposition();
 
+    /**
+     * @brief Keeps a copy of A in memory so it can be restored without I/O.
+     *
+     * When enabled, performLDLtDecomposition() copies matrixAL and diagD into a
+     * snapshot buffer before it factors them in place. returnMatix() then restores A
+     * with a memory copy instead of reparsing the text files, and multiply() and
+     * residualNorms() work on the snapshot while the solver is factored. The
+     * snapshot costs as much memory as A itself. A system mapped from a band file
+     * takes no snapshot: the mapping is private, so remapping the file already
+     * restores the pristine pages without parsing.
+     *
+     * @param enabled Whether to take the snapshot
+     */
+    void setKeepSnapshot(bool enabled);
+
+    /**
+     * @brief Tells whether matrixAL and diagD currently hold the factors instead of A.
+     */
+    bool isFactored() const { return factored; }
+
+    /**
+     * @brief Returns the number of leading rows whose L and D match the current A.
+     *
+     * Equals n after a factorization and drops to i when setRow() changes row i.
+     */
+    int getFactoredRows() const { return factoredRows; }
+
+    /**
+     * @brief Replaces row i of A.
+     *
+     * Before the first factorization the row is written to matrixAL and diagD. Once
+     * the solver is factored, the row is written to the snapshot and rows [i, n)
+     * of the factors become stale until refactor() or refactorFrom() runs.
+     *
+     * @param i Row index
+     * @param band Entries A(i, j), j in [i - m, i), at position m - i + j; positions
+     *             left of column 0 must be zero
+     * @param diagonal Entry A(i, i)
+     * @throws logic_error if the solver is factored and has no snapshot of A
+     */
+    void setRow(int i, const floatingPointType *band, floatingPointType diagonal);
+
+    /**
+     * @brief Refactors rows [k, n) and keeps L and D of rows [0, k).
+     *
+     * The band pattern is fixed, so the symbolic part of the factorization never
+     * changes; only the numeric rows after a change need recomputing. L(j, i) and
+     * D(j) depend on rows 0..j of A only, which makes the factors of rows [0, k)
+     * still valid when only later rows of A changed. Rows [k, n) are reloaded from
+     * the snapshot and factored row by row, with fixedBandFactorization() when
+     * hasFixedBandKernel(m) and otherwise with the wavefront kernel when more
+     * than one thread is configured. The cost is O((n - k) * m^2) instead of
+     * O(n * m^2). k is lowered to getFactoredRows() if it is larger. The factors are
+     * bitwise identical to those of the serial and wavefront kernels. An unfactored
+     * solver is factored completely.
+     *
+     * @param k First row to refactor
+     * @throws logic_error if the solver is factored and has no snapshot of A
+     */
+    void refactorFrom(int k);
+
+    /**
+     * @brief Refactors the rows made stale by setRow(), i.e. refactorFrom(getFactoredRows()).
+     */
+    void refactor();
+
+    /**
+     * @brief Replaces A with A + alpha * sum_c v_c * v_c^T, updating L and D in place.
+     *
+     * Every v_c is nonzero only in rows [first, first + length), with length <= m + 1,
+     * so the new matrix has the same band. On a factored solver the factors are
+     * modified by one pass of the Gill-Golub-Murray-Saunders recurrence per column:
+     * D(j) and column j of L change for j >= first, and each pass costs O((n - first) * m)
+     * instead of the O(n * m^2) of a new factorization. alpha > 0 updates and
+     * alpha < 0 downdates. On an unfactored solver A itself is updated. The
+     * snapshot, if any, is kept equal to the new A either way.
+     *
+     * A downdate that turns a positive pivot into a zero or negative one, i.e. makes
+     * A singular or indefinite, stops with the factors valid for rows [0, first)
+     * only (getFactoredRows() == first). With a snapshot, refactor() then factors
+     * the new A, reporting its pivots as usual.
+     *
+     * @param V Column-major length x k block holding v_c(first + r) at V[c * ld + r]
+     * @param k Rank of the update (number of columns of V)
+     * @param first First row in which the v_c may be nonzero
+     * @param length Number of rows in which the v_c may be nonzero
+     * @param ld Leading dimension of V (>= length)
+     * @param alpha Scale of the update, negative to downdate
+     * @throws invalid_argument if the rows do not fit in the system or in the band
+     * @throws logic_error if rows made stale by setRow() were not refactored yet, or
+     *         if the factors were handed over by factorize()
+     * @throws runtime_error if a downdate makes A indefinite (see above)
+     */
+    void rankUpdate(const floatingPointType *V, int k, int first, int length, int ld, sum alpha);
+
+    /**
+     * @brief Replaces A with A + alpha * v * v^T; see rankUpdate().
+     *
+     * @param v Entries v(first), ..., v(first + length - 1)
+     * @param first First row in which v may be nonzero
+     * @param length Number of rows in which v may be nonzero (<= m + 1)
+     * @param alpha Scale of the update, negative to downdate
+     */
+    void rankOneUpdate(const floatingPointType *v, int first, int length, sum alpha);
+
+    /**
+     * @brief Reference LDLT decomposition, column by column on a single core.
+     */
+    void performLDLtDecompositionSerial();
+
+    /**
+     * @brief Parallel LDLT decomposition scheduled as a wavefront over rows.
+     *
+     * Rows are dealt out cyclically to the threads. Row j computes L(j, i) as soon
+     * as row i is finished, so up to m consecutive rows are in flight at once.
+     * Every entry is computed with the same operations in the same order as in
+     * performLDLtDecompositionSerial(), so both paths give bitwise identical factors.
+     *
+     * @param firstRow Rows [0, firstRow) already hold their final L and D and are kept
+     */
+    void performLDLtDecompositionWavefront(int firstRow = 0);
+
+    /**
+     * @brief Blocked LDLT decomposition working on panels of blockSize columns.
+     *
+     * Each panel is factored left-looking, then its contribution
+     * L21 * D1 * L21^T is subtracted from the at most m trailing rows it touches.
+     * The trailing update is a set of contiguous dot products of length blockSize,
+     * computed four columns at a time by the SIMD bandDot4() micro-kernel, which
+     * loads each row of L once for the four columns. W = L * D is kept in the
+     * accumulation type, so float storage with double accumulation does not round it to float.
+     *
+     * This is a matrix-vector style kernel, not a tiled GEMM: each update reads
+     * W from cache once per row, so it stays memory-bound and does not reach
+     * DGEMM efficiency. It beats the serial kernel only for very wide bands
+     * (see BLOCKED_MIN_BANDWIDTH).
+     *
+     * Cost: n / b panels, each with O(m * b^2) panel work and O(m^2 * b) update
+     * work, so O(n * m^2) flops in total for any block size b <= m.
+     * The update is split across numThreads threads by rows.
+     */
+    void performLDLtDecompositionBlocked();
+
+    /**
+     * @brief Selects the kernel used by performLDLtDecomposition().
+     *
+     * @param selected Kernel to use
+     * @param panelWidth Panel width of the blocked kernel
+     */
+    void setFactorizationKernel(FactorizationKernel selected, int panelWidth = 32);
+
+    /**
+     * @brief Sets which pivots count as bad and whether they stop the factorization.
+     *
+     * Every kernel hands each final pivot D(i) to a PivotMonitor while it is still
+     * in a register, so pivotReport() costs no pass of its own. With abort, the
+     * factorization or refactorization stops at the first pivot <= minimumPivot
+     * (or NaN) and throws runtime_error before anything divides by it. The rows
+     * before it keep their factors and getFactoredRows() points at the bad row:
+     * restore A with returnMatix(), or fix the rows with setRow() and call
+     * refactor() when a snapshot is kept.
+     *
+     * @param minimumPivot Pivots at or below this value are bad; 0 flags non-positive pivots
+     * @param abort Whether to stop at the first bad pivot
+     */
+    void setPivotCheck(double minimumPivot = 0, bool abort = false);
+
+    /**
+     * @brief Pivot statistics of the last factorization, refactorization or rank update.
+     *
+     * A rank update only records the pivots, it never aborts.
+     */
+    const PivotReport &pivotReport() const { return pivots.report(); }
+
+    /**
+     * @brief Estimates the 1-norm condition number of A from the factors.
+     *
+     * ||A^-1||_1 comes from estimateSymmetricOneNorm(), i.e. at most 11 solves with
+     * L and D. ||A||_1 is exact while A is available (not factored, or a snapshot
+     * is kept) and otherwise estimated the same way from products with L * D * L^T.
+     * The cost is O(n * m), against O(n * m^2) for the factorization, so a float
+     * run can check up front whether condition * 2^-24 leaves enough digits.
+     *
+     * @throws logic_error if the system is not completely factored
+     */
+    ConditionEstimate estimateCondition() const;
+
+    /**
+     * @brief Factors the matrix and hands the factors over to an immutable object.
+     *
+     * matrixAL and diagD are moved into the returned factorization. Until the
+     * solver is refilled with returnMatix() or a new system, factoring, the
+     * solves, setRow(), refactorFrom(), rankUpdate(), multiply(), residualNorms()
+     * and the other functions that read A or its factors throw logic_error.
+     * The returned object can be shared by any number of threads solving at once.
+     *
+     * @param keepOriginal Keep a copy of A in the factorization for residual checks
+     * @return Shared read-only factorization
+     */
+    shared_ptr<const Factorization> factorize(bool keepOriginal = false);
+
+    /**
+     * @brief Sets the number of threads used by the factorization.
+     *
+     * @param threads Thread count; 0 selects omp_get_max_threads()
+     */
+    void setNumThreads(int threads);
+
+    /**
+     * @brief Replaces the scratch buffers of the kernels with a caller-owned workspace.
+     *
+     * The workspace grows to the largest system it is used with and then stays
+     * allocated, so solvers that are created and destroyed step after step can
+     * share one workspace instead of allocating their own. It must not be used by
+     * two solvers at the same time.
+     *
+     * @param shared Workspace to use from now on
+     */
+    void setWorkspace(shared_ptr<Workspace> shared);
+
     /**
      * @brief Solves the system using forward substitution for L * y = b.
      *
@@ -131,53 +508,226 @@ public:
      * @brief Solves the full linear system using LDLT decomposition.
      *
      * This method combines forward substitution, diagonal substitution, and backward
-     * substitution to find the solution of the system of linear equations.
+     * substitution to find the solution of the system of linear equations. The
+     * diagonal step is fused into the backward sweep, and both sweeps use the
+     * threads of setNumThreads() on wide bands (see SWEEP_ROW_PARALLEL_MIN_BANDWIDTH).
+     * The result is bitwise equal to calling the three steps one after another.
      */
     void solveLinearSystem();
 
+    /**
+     * @brief Forward substitution L * Y = B for a column-major block of right-hand sides.
+     *
+     * Row i of L is loaded once and applied to all k columns before moving on,
+     * so L is streamed from memory once per sweep.
+     *
+     * @param block Column-major n x k block, overwritten with Y
+     * @param k Number of right-hand sides
+     * @param ld Leading dimension of the block (distance between columns, >= n)
+     */
+    void solveForwardSubstitution(floatingPointType *block, int k, int ld);
+
+    /**
+     * @brief Diagonal substitution D * Z = Y for a column-major block of right-hand sides.
+     *
+     * @param block Column-major n x k block, overwritten with Z
+     * @param k Number of right-hand sides
+     * @param ld Leading dimension of the block (>= n)
+     */
+    void solveDiagonalSubstitution(floatingPointType *block, int k, int ld);
+
+    /**
+     * @brief Backward substitution L^T * X = Z for a column-major block of right-hand sides.
+     *
+     * Column i of L is gathered once into a contiguous buffer and applied to all
+     * k columns, so every entry of L is read once per sweep.
+     *
+     * @param block Column-major n x k block, overwritten with X
+     * @param k Number of right-hand sides
+     * @param ld Leading dimension of the block (>= n)
+     */
+    void solveBackwardSubstitution(floatingPointType *block, int k, int ld);
+
+    /**
+     * @brief Solves A * X = B for k right-hand sides with the current factorization.
+     *
+     * performLDLtDecomposition() must have been called. vectorF is not touched.
+     * With several threads and enough work (see SWEEP_COLUMN_PARALLEL_MIN_WORK),
+     * the columns are split into one group per thread.
+     *
+     * @param block Column-major n x k block of right-hand sides, overwritten with X
+     * @param k Number of right-hand sides
+     * @param ld Leading dimension of the block (>= n)
+     */
+    void solveLinearSystem(floatingPointType *block, int k, int ld);
+
+    /**
+     * @brief Solves A * X = B for k right-hand sides stored contiguously (ld = n).
+     *
+     * @param block Column-major block of n * k values, overwritten with X
+     * @param k Number of right-hand sides
+     */
+    void solveLinearSystem(vector<floatingPointType> &block, int k);
+
+    /**
+     * @brief Solves A * x = F by mixed-precision iterative refinement.
+     *
+     * A is copied to float and factored once with the configured kernel. Each
+     * iteration then computes the residual r = F - A * x in double with the band
+     * multiply, solves for a correction with the float factors and adds it to x,
+     * until ||r||_2 / ||F||_2 <= tolerance. The factorization and every solve move
+     * float data only, so x reaches double accuracy at about float memory traffic,
+     * provided A is well enough conditioned for the float factors to contract the
+     * error (roughly cond(A) < 1e7). Refinement stops early when the residual no
+     * longer halves; x is then the iterate with the smallest residual, which the
+     * report describes.
+     *
+     * matrixAL and diagD keep A; vectorF receives x.
+     *
+     * @param tolerance Target relative residual
+     * @param maxIterations Maximum number of correction steps
+     * @return Iteration count and residual norm of the returned x
+     * @throws logic_error if the storage type is not double
+     */
+    RefinementReport solveWithRefinement(double tolerance = 1e-14, int maxIterations = 30);
+
     /**
      * @brief Writes the solution vector F to a file.
      *
-     * Saves the solution of the system to the specified file.
+     * Saves the solution of the system to the specified file, in the format
+     * chosen with setSolutionFormat(). Waits for a pending background write first.
      */
     void writeVectorFToFile();
 
     /**
-     * @brief Prints the vector F to the console.
+     * @brief Writes the solution vector F to a file on a background thread.
+     *
+     * F is copied into a buffer that is kept across calls, so the next system
+     * can be loaded and solved while the previous solution is flushed. Errors
+     * are reported by waitForWrite() or by the next write.
+     */
+    void writeVectorFToFileAsync();
+
+    /**
+     * @brief Waits for the write started by writeVectorFToFileAsync(), if any.
+     *
+     * @throws runtime_error if the background write failed
+     */
+    void waitForWrite();
+
+    /**
+     * @brief Selects the file format of the solution.
+     */
+    void setSolutionFormat(SolutionFormat format) { solutionFormat = format; }
+
+    /**
+     * @brief Prints the vector F.
      *
      * Outputs the current state of the vector F, which contains the solution.
+     * Like the other print helpers, it is a diagnostic: the text is formatted in a
+     * local buffer with the precision of the storage type and handed to out in one
+     * write, so the state of out is not changed.
+     *
+     * @param out Destination stream
      */
-    void printvectorF();
+    void printvectorF(ostream &out = cout) const;
 
     /**
      * @brief Reloads the matrix and diagonal values from files.
      *
-     * Re-initializes matrixAL and diagD by loading their values from files.
+     * Re-initializes matrixAL and diagD from the snapshot when setKeepSnapshot() is
+     * enabled, otherwise by loading their values from files. Storage handed over by
+     * factorize() is allocated again. A system loaded from a binary band file is
+     * mapped again, which restores the pristine pages without parsing.
      */
     void returnMatix();
 
+    /**
+     * @brief Computes y = A * x in O(n * m) with numThreads threads, without I/O.
+     *
+     * Uses the snapshot of A while the solver is factored (see setKeepSnapshot()).
+     *
+     * @param x Input vector of length n
+     * @param y Output vector of length n
+     * @throws logic_error if A was factored in place without a snapshot
+     */
+    void multiply(const floatingPointType *x, sum *y) const;
+
+    /**
+     * @brief Returns A * vectorF, e.g. A * x after a solve and returnMatix().
+     */
+    vector<sum> multiplyMatrixToVector() const;
+
+    /**
+     * @brief Computes the norms of the residual f - A * x in O(n * m), without I/O.
+     *
+     * As for multiply(), A comes from the snapshot while the solver is factored.
+     *
+     * @param x Solution vector of length n
+     * @param f Right-hand side of length n
+     * @return l2, infinity and relative (to ||f||_2) norms of the residual
+     */
+    ResidualNorms residualNorms(const floatingPointType *x, const floatingPointType *f) const;
+
+    /**
+     * @brief FNV-1a hash of n, m, the band of A (with its row padding) and the diagonal of A.
+     *
+     * As for multiply(), A comes from the snapshot while the solver is factored.
+     * Equal matrices loaded from text or from a band file hash equally.
+     */
+    uint64_t contentHash() const;
+
+    /**
+     * @brief Whether factors were computed from the current A, compared with the copy of A they keep.
+     *
+     * A hash collision in contentHash() is told apart this way. As for multiply(),
+     * A comes from the snapshot while the solver is factored.
+     *
+     * @param factors Factorization created by factorize(true)
+     * @throws logic_error if the factors keep no copy of A
+     */
+    bool matches(const Factorization &factors) const;
+
+    /**
+     * @brief Returns vectorF: the right-hand side before a solve, the solution after it.
+     */
+    const vector<floatingPointType> &getVectorF() const { return vectorF; }
+
+    /**
+     * @brief Copies a new right-hand side into vectorF.
+     *
+     * @param f Right-hand side of length n
+     */
+    void setVectorF(const floatingPointType *f);
+
     /**
      * @brief Multiplies the restored matrix (A = L + D) by the solution vector and prints the result.
      *
-     * Computes the product of matrix A and vector X, where matrix A is reconstructed from
-     * its banded format representation, and prints the resulting vector.
+     * The product comes from multiplyMatrixToVector(); this method only formats it,
+     * one line per entry.
+     *
+     * @param out Destination stream
      */
-    void printMultiplyMatrixToVector();
+    void printMultiplyMatrixToVector(ostream &out = cout) const;
 
     /**
-     * @brief Prints the fully restored matrix (A = L + D) to the console.
+     * @brief Prints the fully restored matrix (A = L + D).
      *
      * Reconstructs and prints the original matrix A, which is the sum of the lower triangular
      * matrix L and the diagonal matrix D, from the banded format.
+     *
+     * @param out Destination stream
      */
-    void printRestoredMatrix();
+    void printRestoredMatrix(ostream &out = cout) const;
 
     /**
      * @brief Prints the lower triangular matrix (L) stored in banded format.
      *
-     * Outputs the matrixAL to the console, showing the banded lower triangular part of the matrix.
+     * Outputs the matrixAL, showing the banded lower triangular part of the matrix.
+     *
+     * @param out Destination stream
      */
-    void printMatrixAL();
+    void printMatrixAL(ostream &out = cout) const;
 
     /**
      * @brief Generates a Hilbert matrix in banded format and initializes vector F.
@@ -190,9 +740,42 @@ public:
     /**
      * @brief Restores the Hilbert matrix in banded format after modifications.
      *
-     * Recalculates the matrixAL and diagD using values from a Hilbert matrix.
+     * Copies the snapshot back when one was taken, otherwise recalculates
+     * matrixAL and diagD using values from a Hilbert matrix.
      */
     void returnMatixAfterHilbert();
+
+    /**
+     * @brief Generates a random diagonally dominant band matrix and vector F.
+     *
+     * Off-diagonal entries are uniform in [-1, 1] and each diagonal entry exceeds the
+     * sum of the magnitudes in its row, so the matrix is symmetric positive definite.
+     *
+     * @param seed Seed of the random generator
+     */
+    void DiagonallyDominantBandMatrix(unsigned seed);
+
+    /**
+     * @brief Generates a Laplacian stencil in banded format and vector F.
+     *
+     * For m = 1 this is the 1D second difference (2, -1). For m > 1 it is the 2D
+     * five-point Laplacian on a grid with m points per line (4, -1 to the left
+     * within the line, -1 to the line below), whose bandwidth is m.
+     */
+    void LaplacianBandMatrix();
+
+    /**
+     * @brief Writes the system in the text layout read by the file constructor.
+     *
+     * @param inputFilePath Path to the file for n and m
+     * @param alFilePath Path to the file for matrix A (banded part)
+     * @param dFilePath Path to the file for matrix D
+     * @param fFilePath Path to the file for the vector F
+     */
+    void saveToFile(const string &inputFilePath,
+                    const string &alFilePath,
+                    const string &dFilePath,
+                    const string &fFilePath) const;
 };
 
 #endif // SLAUSolverLDLT_HPP
@@ -0,0 +1,119 @@
+/**
+ * @file SimdKernels.hpp
+ * @brief Explicit SIMD kernels for the band dot products and axpy updates.
+ *
+ * Each kernel exists as a scalar version, an AVX2/FMA and an AVX-512 version on
+ * x86-64, and a NEON version on AArch64. simdKernels() picks the widest version
+ * the running CPU supports the first time it is called, so one binary runs
+ * everywhere without -march flags.
+ *
+ * T is the storage type and Acc the accumulator type; the kernels are
+ * instantiated for the pairs listed in Precision.hpp. For float storage with
+ * double accumulation they widen every float lane to double before multiplying.
+ */
+
+#ifndef SimdKernels_HPP
+#define SimdKernels_HPP
+
+#include <bits/stdc++.h>
+using namespace std;
+
+/**
+ * @brief Table of kernels for one storage / accumulator combination.
+ */
+template <typename T, typename Acc>
+struct SimdKernels
+{
+    /// Returns sum a[i] * b[i] for i < len.
+    Acc (*dot)(const T *a, const T *b, int len);
+
+    /// Returns sum a[i] * b[i] * d[i] for i < len.
+    Acc (*dotScaled)(const T *a, const T *b, const T *d, int len);
+
+    /// Computes y[i] += alpha * x[i] for i < len.
+    void (*axpy)(Acc *y, Acc alpha, const T *x, int len);
+
+    /// Computes out[j] = sum a[i] * w[j * ldw + i] for j < 4 and i < len, loading a once for all four.
+    void (*dot4)(const T *a, const Acc *w, int ldw, int len, Acc *out);
+
+    /// Name of the selected instruction set ("scalar", "avx2", "avx512", "neon").
+    const char *isa;
+};
+
+/**
+ * @brief Returns the kernels selected for the running CPU.
+ */
+template <typename T, typename Acc>
+const SimdKernels<T, Acc> &simdKernels();
+
+/// Shorter rows are handled inline, where the call overhead would dominate.
+constexpr int SIMD_MIN_LENGTH = 8;
+
+template <typename T, typename Acc>
+inline Acc bandDot(const T *a, const T *b, int len)
+{
+    if (len < SIMD_MIN_LENGTH)
+    {
+        Acc result = 0;
+        for (int i = 0; i < len; ++i)
+        {
+            result += Acc(a[i]) * b[i];
+        }
+        return result;
+    }
+    return simdKernels<T, Acc>().dot(a, b, len);
+}
+
+template <typename T, typename Acc>
+inline Acc bandDotScaled(const T *a, const T *b, const T *d, int len)
+{
+    if (len < SIMD_MIN_LENGTH)
+    {
+        Acc result = 0;
+        for (int i = 0; i < len; ++i)
+        {
+            result += Acc(a[i]) * b[i] * d[i];
+        }
+        return result;
+    }
+    return simdKernels<T, Acc>().dotScaled(a, b, d, len);
+}
+
+template <typename T, typename Acc>
+inline void bandAxpy(Acc *y, Acc alpha, const T *x, int len)
+{
+    if (len < SIMD_MIN_LENGTH)
+    {
+        for (int i = 0; i < len; ++i)
+        {
+            y[i] += alpha * x[i];
+        }
+        return;
+    }
+    simdKernels<T, Acc>().axpy(y, alpha, x, len);
+}
+
+template <typename T, typename Acc>
+inline void bandDot4(const T *a, const Acc *w, int ldw, int len, Acc *out)
+{
+    if (len < SIMD_MIN_LENGTH)
+    {
+        Acc s0 = 0, s1 = 0, s2 = 0, s3 = 0;
+        for (int i = 0; i < len; ++i)
+        {
+            Acc x = a[i];
+            s0 += x * w[i];
+            s1 += x * w[ldw + i];
+            s2 += x * w[2 * ldw + i];
+            s3 += x * w[3 * ldw + i];
+        }
+        out[0] = s0;
+        out[1] = s1;
+        out[2] = s2;
+        out[3] = s3;
+        return;
+    }
+    simdKernels<T, Acc>().dot4(a, w, ldw, len, out);
+}
+
+#endif // SimdKernels_HPP
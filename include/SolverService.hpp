@@ -0,0 +1,184 @@
+/**
+ * @file SolverService.hpp
+ * @brief Long-lived solver process that answers a queue of jobs and caches factorizations.
+ *
+ * Every job names a matrix (text files or a band file), a right-hand side and an
+ * output file. The factors of recent matrices are kept in an LRU cache keyed by
+ * SLAUSolverLDLT::contentHash(), so a job on a matrix seen before costs one solve
+ * instead of a parse and a factorization. A hit is only used after the parsed
+ * matrix compared equal to the copy of A kept with the factors. The matrix files
+ * are also remembered by path, size and modification time, which lets a repeat
+ * job on the same cached factors skip the parse too.
+ *
+ * Protocol: one request per line, one response line per request.
+ *
+ *     solve [id=<tag>] input=<size file> al=<AL file> d=<D file> f=<F file> x=<output>
+ *     solve [id=<tag>] band=<band file> [f=<F file>] x=<output>
+ *     stats
+ *     quit
+ *
+ * A solve answers "ok id=<tag> cache=hit|miss parsed=0|1 n=<n> m=<m> seconds=<t>"
+ * or "error id=<tag> <message>"; stats answers with the counters of ServiceStats.
+ * The F section of the band file is used when f= is missing; a band file without
+ * one needs f=. The solution is
+ * written in the service's SolutionFormat.
+ */
+
+#ifndef SolverService_HPP
+#define SolverService_HPP
+
+#include <bits/stdc++.h>
+#include "LDLTFactorization.hpp"
+#include "SLAUSolverLDLT.hpp"
+using namespace std;
+
+/**
+ * @brief Counters of a FactorCache and the jobs that used it.
+ */
+struct ServiceStats
+{
+    size_t jobs = 0;       ///< solve requests received
+    size_t failed = 0;     ///< solve requests answered with an error
+    size_t hits = 0;       ///< Jobs answered from cached factors
+    size_t misses = 0;     ///< Jobs that had to factor
+    size_t parseSkips = 0; ///< Hits that also skipped reading the matrix files
+    size_t evictions = 0;  ///< Factorizations dropped to stay within the byte budget
+
+    /// hits / (hits + misses), 0 before the first lookup.
+    double hitRate() const { return hits + misses > 0 ? double(hits) / double(hits + misses) : 0.0; }
+};
+
+/**
+ * @class FactorCache
+ * @brief Least-recently-used cache of factorizations within a byte budget.
+ *
+ * Keys are 64-bit content hashes that include n and m. The factorizations keep a
+ * copy of A, so SolverService compares the matrix of a job with it before a hit
+ * is used and a hash collision becomes a miss.
+ */
+template <typename StorageT, typename AccumT>
+class FactorCache
+{
+public:
+    using Factorization = LDLTFactorization<StorageT, AccumT>;
+
+private:
+    using Entry = pair<uint64_t, shared_ptr<const Factorization>>;
+
+    size_t capacityBytes;                                          ///< Budget for the factors of all entries
+    size_t usedBytes = 0;                                          ///< Bytes of the cached factors
+    list<Entry> order;                                             ///< Most recently used first
+    unordered_map<uint64_t, typename list<Entry>::iterator> index; ///< Key to position in order
+    size_t evicted = 0;                                            ///< Entries dropped so far
+
+public:
+    /**
+     * @param capacity Byte budget; a factorization larger than it is never cached
+     */
+    explicit FactorCache(size_t capacity) : capacityBytes(capacity) {}
+
+    /// Bytes a factorization occupies: L with its row padding, D and 1 / D, and the kept copy of A.
+    static size_t bytesOf(const Factorization &factors);
+
+    /**
+     * @brief Returns the factors for key and marks them most recently used, or null.
+     */
+    shared_ptr<const Factorization> find(uint64_t key);
+
+    /**
+     * @brief Adds the factors under key, evicting least recently used entries to make room.
+     */
+    void insert(uint64_t key, shared_ptr<const Factorization> factors);
+
+    size_t entries() const { return order.size(); }
+    size_t bytes() const { return usedBytes; }
+    size_t evictions() const { return evicted; }
+};
+
+/**
+ * @class SolverService
+ * @brief Answers solve jobs line by line, from a stream or a Unix domain socket.
+ *
+ * Jobs run one after the other; the factorization of a cache miss uses the
+ * configured thread count.
+ */
+template <typename StorageT, typename AccumT>
+class SolverService
+{
+public:
+    using floatingPointType = StorageT;
+    using Solver = SLAUSolverLDLT<StorageT, AccumT>;
+    using Factorization = LDLTFactorization<StorageT, AccumT>;
+
+private:
+    /// Size and modification time of the matrix files of a job, to detect edits.
+    struct FileStamp
+    {
+        vector<pair<uintmax_t, filesystem::file_time_type>> files;
+        bool operator==(const FileStamp &other) const { return files == other.files; }
+    };
+
+    /// Content hash and factors of the matrix last read from a set of files.
+    struct KnownMatrix
+    {
+        FileStamp stamp;
+        uint64_t hash;
+        weak_ptr<const Factorization> factors; ///< Expires when the cache drops them
+        size_t lastJob;                        ///< Number of the last job on these files
+    };
+
+    static constexpr size_t MAX_KNOWN_FILE_SETS = 4096; ///< File sets remembered for parse skips
+
+    FactorCache<StorageT, AccumT> cache;
+    map<string, KnownMatrix> knownFiles; ///< Matrix file paths of a job to the matrix they held, while cached
+    SolutionFormat format;
+    int numThreads;
+    ServiceStats counters;
+    typename Factorization::Workspace workspace;
+
+    /// Runs one solve request; the keys are the key=value tokens of the line.
+    string solve(const map<string, string> &keys);
+
+public:
+    /**
+     * @param cacheBytes Byte budget of the factor cache
+     * @param solutionFormat Format of the solution files
+     * @param threads Threads of the factorization; 0 selects omp_get_max_threads()
+     */
+    SolverService(size_t cacheBytes, SolutionFormat solutionFormat = SolutionFormat::Text, int threads = 1);
+
+    /**
+     * @brief Answers one request line; errors become "error ..." responses.
+     *
+     * @param line Request without the trailing newline
+     * @param quit Set to true by a quit request
+     * @return Response without the trailing newline
+     */
+    string handle(const string &line, bool &quit);
+
+    /**
+     * @brief Answers requests from in until end of input or quit, flushing after every response.
+     */
+    void serve(istream &in, ostream &out);
+
+    /**
+     * @brief Listens on a Unix domain socket and answers one connection at a time.
+     *
+     * Each connection sends request lines and reads the responses, as with serve().
+     * Returns after a quit request; the socket file is removed.
+     *
+     * @throws runtime_error if the socket cannot be created
+     */
+    void serveSocket(const string &socketPath);
+
+    /// File sets whose factors are remembered for parse skips.
+    size_t knownFileSets() const { return knownFiles.size(); }
+
+    /// Counters including the current cache state.
+    ServiceStats stats() const;
+
+    /// The stats response line.
+    string statsLine() const;
+};
+
+#endif // SolverService_HPP
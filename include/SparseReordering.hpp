@@ -0,0 +1,141 @@
+/**
+ * @file SparseReordering.hpp
+ * @brief Reverse Cuthill-McKee front-end turning a general sparse symmetric matrix into a band system.
+ *
+ * The cost of the band factorization grows with m^2, and the bandwidth of a
+ * sparse matrix depends on the numbering of its unknowns. The front-end reads
+ * the matrix in compressed sparse row (CSR) or coordinate (COO) form, renumbers
+ * the unknowns with Reverse Cuthill-McKee, assembles the permuted matrix straight
+ * into the band storage of an SLAUSolverLDLT and permutes F and X on the way in
+ * and out, so the caller only ever sees the original numbering.
+ */
+
+#ifndef SparseReordering_HPP
+#define SparseReordering_HPP
+
+#include <bits/stdc++.h>
+#include "SLAUSolverLDLT.hpp"
+using namespace std;
+
+/**
+ * @struct SparseMatrix
+ * @brief Symmetric sparse matrix in CSR form.
+ *
+ * Row i holds the entries columns[k], values[k] for k in [rowStart[i], rowStart[i + 1]).
+ * Either the full matrix or only its lower triangle may be stored: the ordering
+ * uses the symmetrized pattern, the assembly only the entries with column <= row.
+ * Duplicate entries are summed.
+ *
+ * @tparam T Scalar type of the values
+ */
+template <typename T>
+struct SparseMatrix
+{
+    int n = 0;            ///< Number of rows and columns
+    vector<int> rowStart; ///< n + 1 offsets into columns and values
+    vector<int> columns;  ///< Column index of every stored entry
+    vector<T> values;     ///< Value of every stored entry
+
+    /**
+     * @brief Builds a CSR matrix from coordinate triplets.
+     *
+     * @param size Number of rows and columns
+     * @param rows Row index of every entry
+     * @param cols Column index of every entry
+     * @param entries Value of every entry
+     * @throws invalid_argument if the arrays differ in length or an index is out of range
+     */
+    static SparseMatrix fromCoo(int size, const vector<int> &rows, const vector<int> &cols, const vector<T> &entries);
+
+    /**
+     * @brief Reads a coordinate file: "n nnz" on the first line, then nnz lines "i j value".
+     *
+     * Indices are 0-based.
+     *
+     * @param filePath Path to the file
+     * @throws runtime_error if the file is malformed
+     */
+    static SparseMatrix loadCoo(const string &filePath);
+};
+
+/**
+ * @brief Computes a Reverse Cuthill-McKee ordering of a symmetric pattern.
+ *
+ * Each connected component is numbered breadth-first from a pseudo-peripheral
+ * vertex (found as in George and Liu), visiting neighbours by increasing degree,
+ * and the whole order is reversed at the end.
+ *
+ * @param n Number of vertices
+ * @param rowStart CSR row offsets of the pattern
+ * @param columns CSR column indices of the pattern
+ * @return order[k] = original index of the unknown numbered k
+ */
+vector<int> reverseCuthillMcKee(int n, const vector<int> &rowStart, const vector<int> &columns);
+
+/**
+ * @brief Returns the bandwidth max |position[i] - position[j]| over the stored entries.
+ *
+ * @param n Number of vertices
+ * @param rowStart CSR row offsets of the pattern
+ * @param columns CSR column indices of the pattern
+ * @param position position[i] = new index of unknown i, or empty for the identity
+ */
+int patternBandwidth(int n, const vector<int> &rowStart, const vector<int> &columns, const vector<int> &position = {});
+
+/**
+ * @class ReorderedBandSolver
+ * @brief Band LDLT solver for a sparse symmetric matrix renumbered with RCM.
+ *
+ * @tparam StorageT Scalar type of the band storage
+ * @tparam AccumT Type every reduction accumulates in
+ */
+template <typename StorageT, typename AccumT>
+class ReorderedBandSolver
+{
+public:
+    using floatingPointType = StorageT;
+    using sum = AccumT;
+    using Solver = SLAUSolverLDLT<StorageT, AccumT>;
+
+private:
+    vector<int> order;                  ///< order[k] = original index of band row k
+    int bandwidthBefore;                ///< Bandwidth of the matrix in the original numbering
+    int bandwidthAfter;                 ///< Bandwidth of the band system
+    unique_ptr<Solver> system;          ///< Band system in the new numbering
+    vector<floatingPointType> permuted; ///< F and X in the new numbering
+
+public:
+    /**
+     * @brief Orders the matrix and assembles it into band storage.
+     *
+     * @param A Sparse symmetric matrix
+     * @param reorder Apply RCM; false keeps the original numbering
+     * @param outputFilePath Path used by the band solver for writeVectorFToFile()
+     */
+    ReorderedBandSolver(const SparseMatrix<floatingPointType> &A, bool reorder = true, const string &outputFilePath = "");
+
+    int size() const { return int(order.size()); }
+    int originalBandwidth() const { return bandwidthBefore; }
+    int bandwidth() const { return bandwidthAfter; }
+    const vector<int> &permutation() const { return order; }
+
+    /**
+     * @brief Returns the band system in the new numbering (e.g. to set threads or the kernel).
+     */
+    Solver &solver() { return *system; }
+
+    /**
+     * @brief Factors the band system.
+     */
+    void factor();
+
+    /**
+     * @brief Solves A * x = f with the factors, both vectors in the original numbering.
+     *
+     * @param f Right-hand side of length size()
+     * @param x Solution of length size(); may alias f
+     */
+    void solve(const floatingPointType *f, floatingPointType *x);
+};
+
+#endif // SparseReordering_HPP
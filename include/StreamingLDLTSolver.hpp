@@ -0,0 +1,110 @@
+/**
+ * @file StreamingLDLTSolver.hpp
+ * @brief Out-of-core LDLT solver for band systems larger than main memory.
+ *
+ * Row j of L depends only on row j of A and on rows j - m .. j - 1 of L, so the
+ * factorization can move through the matrix with a window of m + 1 rows:
+ *
+ * 1. The forward pass reads AL, D and F row by row, factors each row, applies the
+ *    forward and diagonal substitution to it and appends the finished L row, D
+ *    entry and z entry to a binary factor file.
+ * 2. The backward pass reads the factor file from the end and runs the backward
+ *    substitution in row-oriented (axpy) form, so only m pending sums are kept.
+ *
+ * Peak memory is O(m^2) for the window plus fixed-size I/O buffers, whatever n is.
+ */
+
+#ifndef StreamingLDLTSolver_HPP
+#define StreamingLDLTSolver_HPP
+
+#include <bits/stdc++.h>
+#include "Precision.hpp"
+#include "TextParser.hpp"
+using namespace std;
+
+/**
+ * @brief Header of the factor file written by the forward pass.
+ *
+ * It is followed by n records of m + 2 values each: row j of L (positions m - j + i,
+ * as in BandMatrix), D(j) and z(j) = (L D)^-1 F at row j.
+ */
+struct StreamingFactorHeader
+{
+    char magic[8];       ///< "LDLTFACT"
+    uint32_t version;    ///< Format version, currently 1
+    uint32_t scalarSize; ///< sizeof(StorageT)
+    uint64_t n;          ///< Number of equations
+    uint64_t m;          ///< Bandwidth
+};
+
+/**
+ * @class StreamingLDLTSolver
+ * @brief Solves A * x = F in two streaming passes over the files.
+ *
+ * @tparam StorageT Scalar type of the factor file and the window
+ * @tparam AccumT Type every reduction accumulates in
+ */
+template <typename StorageT, typename AccumT>
+class StreamingLDLTSolver
+{
+public:
+    using floatingPointType = StorageT;
+    using sum = AccumT;
+
+private:
+    int n; ///< The size of the system (number of equations)
+    int m; ///< The bandwidth of the matrix
+
+    string AlFilePath;     ///< Path to the text file with the band of A
+    string DFilePath;      ///< Path to the text file with the diagonal of A
+    string FFilePath;      ///< Path to the text file with the right-hand side
+    string factorFilePath; ///< Path to the binary factor file
+    string solveFilePath;  ///< Path to the text file for the solution
+
+    size_t recordsPerBlock; ///< Factor records moved per read or write call
+
+public:
+    /**
+     * @brief Reads the system size and remembers the file paths.
+     *
+     * @param inputFilePath Path to the input file with system size
+     * @param alFilePath Path to the file with matrix A (banded part)
+     * @param dFilePath Path to the file with matrix D
+     * @param fFilePath Path to the file with the vector F
+     * @param factorFile Path of the binary factor file written by the forward pass
+     * @param outputFilePath Path to the file for saving the solution
+     * @param blockBytes Approximate size of the factor file I/O buffer
+     */
+    StreamingLDLTSolver(const string &inputFilePath,
+                        const string &alFilePath,
+                        const string &dFilePath,
+                        const string &fFilePath,
+                        const string &factorFile,
+                        const string &outputFilePath,
+                        size_t blockBytes = size_t(1) << 24);
+
+    /**
+     * @brief Factors A row by row and runs the forward and diagonal substitution in the same pass.
+     */
+    void factorAndForward();
+
+    /**
+     * @brief Reads the factor file backwards, finishes the solve and writes the solution.
+     */
+    void solveBackward();
+
+    /**
+     * @brief Runs factorAndForward() followed by solveBackward().
+     */
+    void solve();
+
+    /**
+     * @brief Returns the number of bytes held by the sliding window and the I/O buffers.
+     */
+    size_t workingSetBytes() const;
+
+    int size() const { return n; }
+    int bandwidth() const { return m; }
+};
+
+#endif // StreamingLDLTSolver_HPP
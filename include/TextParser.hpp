@@ -0,0 +1,179 @@
+/**
+ * @file TextParser.hpp
+ * @brief Fast parser for the legacy text files (input.txt, AL.txt, D.txt, F.txt) and writer for X.txt.
+ *
+ * The file is read in blocks of 16 MiB. Each block is cut after its last newline
+ * and split at line boundaries into one chunk per thread; the unfinished line
+ * moves on to the next block. Each chunk first counts its rows, then parses them
+ * with std::from_chars straight into the destination storage.
+ *
+ * One row of the matrix or vector is one line of the file; blank lines are
+ * skipped. The original operator>> reader accepted any whitespace layout, so a
+ * file that wraps a row over several lines is now an error.
+ *
+ * Malformed input raises runtime_error with the position of the first problem,
+ * formatted as "path:line:column: message" with 1-based line and column.
+ */
+
+#ifndef TextParser_HPP
+#define TextParser_HPP
+
+#include <bits/stdc++.h>
+#include "BandMatrix.hpp"
+using namespace std;
+
+/**
+ * @brief Reads a whole file into memory; used for the small size file.
+ *
+ * @param filePath Path to the file
+ * @return File contents
+ * @throws runtime_error if the file cannot be read completely
+ */
+string readTextFile(const string &filePath);
+
+/**
+ * @brief Parses the system size file ("n m").
+ *
+ * @param filePath Path to the file
+ * @param n Receives the number of equations
+ * @param m Receives the bandwidth
+ */
+void parseSizeText(const string &filePath, int &n, int &m);
+
+/**
+ * @brief Returns the optional precision token after n and m in the size file.
+ *
+ * A size file may read "n m float", "n m double" or "n m float_double";
+ * parseSizeText() ignores the third token.
+ *
+ * @param filePath Path to the file
+ * @return The third token, or an empty string when there is none
+ */
+string parsePrecisionText(const string &filePath);
+
+/**
+ * @brief Parses a band matrix with one row of m values per line.
+ *
+ * @param filePath Path to the file
+ * @param matrix Destination, already sized to n rows and bandwidth m
+ * @param threads Number of threads; 0 selects omp_get_max_threads()
+ */
+template <typename T>
+void parseBandText(const string &filePath, BandMatrix<T> &matrix, int threads = 0);
+
+/**
+ * @brief Parses a vector with one value per line.
+ *
+ * @param filePath Path to the file
+ * @param values Destination of n values
+ * @param n Number of values expected
+ * @param threads Number of threads; 0 selects omp_get_max_threads()
+ */
+template <typename T>
+void parseVectorText(const string &filePath, T *values, int n, int threads = 0);
+
+/**
+ * @class TextRowReader
+ * @brief Sequential reader returning one row (line) of a text file at a time.
+ *
+ * The file is read in blocks of a few megabytes, so memory use does not depend
+ * on the size of the file. Used by the streaming solver, which must not load
+ * whole files.
+ */
+class TextRowReader
+{
+private:
+    ifstream file;        ///< Underlying file
+    string path;          ///< Path used in error messages
+    vector<char> buffer;  ///< Block of the file being parsed
+    size_t begin;         ///< First unparsed byte in buffer
+    size_t end;           ///< One past the last valid byte in buffer
+    size_t line;          ///< Number of lines consumed so far
+    bool eof;             ///< Whether the whole file has been read into buffer
+
+    bool fill();
+
+public:
+    /**
+     * @brief Opens a file for sequential row reading.
+     *
+     * @param filePath Path to the file
+     * @param blockSize Size of the read buffer in bytes
+     */
+    explicit TextRowReader(const string &filePath, size_t blockSize = size_t(1) << 22);
+
+    /**
+     * @brief Parses the next non-blank line into width values.
+     *
+     * @param values Destination of width values
+     * @param width Number of values expected on the line
+     * @throws runtime_error if the line is malformed or the file ends early
+     */
+    template <typename T>
+    void readRow(T *values, int width);
+};
+
+/**
+ * @class TextRowWriter
+ * @brief Buffered writer of one value per line in fixed notation.
+ *
+ * Values are formatted with std::to_chars into a block of a few megabytes that
+ * is written out whenever it fills up. The text is the same as that of an
+ * ofstream with fixed and setprecision(digits), without the per-value cost of
+ * the stream machinery.
+ */
+class TextRowWriter
+{
+private:
+    ofstream file;        ///< Underlying file
+    string path;          ///< Path used in error messages
+    vector<char> buffer;  ///< Block of formatted text not yet written
+    size_t used;          ///< Number of bytes used in buffer
+    int digits;           ///< Digits after the decimal point
+
+    void flush();
+
+public:
+    /// Room kept free in the buffer for one formatted value and its newline.
+    static constexpr size_t MAX_VALUE_CHARS = 512;
+
+    /**
+     * @brief Creates or truncates a file for writing.
+     *
+     * @param filePath Path to the file
+     * @param precision Digits after the decimal point
+     * @param blockSize Size of the write buffer in bytes
+     */
+    TextRowWriter(const string &filePath, int precision, size_t blockSize = size_t(1) << 22);
+
+    /**
+     * @brief Flushes what is left; errors are only reported by close().
+     */
+    ~TextRowWriter();
+
+    /**
+     * @brief Appends one value and a newline.
+     */
+    template <typename T>
+    void writeValue(T value);
+
+    /**
+     * @brief Flushes the buffer and closes the file.
+     *
+     * @throws runtime_error if any write failed
+     */
+    void close();
+};
+
+/**
+ * @brief Writes a vector with one value per line in fixed notation.
+ *
+ * @param filePath Path to the file
+ * @param values Source of n values
+ * @param n Number of values
+ * @param precision Digits after the decimal point
+ */
+template <typename T>
+void writeVectorText(const string &filePath, const T *values, size_t n, int precision);
+
+#endif // TextParser_HPP
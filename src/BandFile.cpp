@@ -0,0 +1,321 @@
+/**
+ * @file BandFile.cpp
+ * @brief Implementation of the binary band file writer and the mmap-based reader.
+ */
+#include "BandFile.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace
+{
+    size_t alignToPage(size_t offset)
+    {
+        return (offset + BAND_FILE_PAGE - 1) / BAND_FILE_PAGE * BAND_FILE_PAGE;
+    }
+
+    template <typename T>
+    BandScalarType scalarTypeOf();
+
+    template <>
+    BandScalarType scalarTypeOf<float>() { return BandScalarType::Float32; }
+
+    template <>
+    BandScalarType scalarTypeOf<double>() { return BandScalarType::Float64; }
+
+    /// Tells whether size bytes starting at offset end at or before limit, without overflowing.
+    bool sectionFits(uint64_t offset, uint64_t size, uint64_t limit)
+    {
+        return offset <= limit && size <= limit - offset;
+    }
+
+    /// Row stride the writer uses for bandwidth m, by scalar type.
+    uint64_t expectedRowStride(uint32_t scalarType, uint64_t m)
+    {
+        return uint64_t(scalarType == uint32_t(BandScalarType::Float32) ? BandMatrix<float>::paddedStride(int(m))
+                                                                          : BandMatrix<double>::paddedStride(int(m)));
+    }
+
+    void writePadding(ofstream &file, size_t target)
+    {
+        static const char zeros[BAND_FILE_PAGE] = {};
+        size_t position = size_t(file.tellp());
+        while (position < target)
+        {
+            size_t chunk = min(target - position, BAND_FILE_PAGE);
+            file.write(zeros, streamsize(chunk));
+            position += chunk;
+        }
+    }
+}
+
+uint64_t fnv1a64(const void *data, size_t size, uint64_t hash)
+{
+    const unsigned char *bytes = static_cast<const unsigned char *>(data);
+    for (size_t i = 0; i < size; ++i)
+    {
+        hash ^= bytes[i];
+        hash *= 0x100000001b3ULL;
+    }
+    return hash;
+}
+
+template <typename T>
+void writeBandFile(const string &filePath, const BandMatrix<T> &AL, const vector<T> &D, const vector<T> *F)
+{
+    const size_t n = size_t(AL.rows());
+    if (D.size() != n || (F != nullptr && F->size() != n))
+    {
+        throw invalid_argument("writeBandFile: D and F must have one entry per row");
+    }
+
+    const size_t bytesAL = n * AL.rowStride() * sizeof(T);
+    const size_t bytesVector = n * sizeof(T);
+
+    BandFileHeader header = {};
+    copy(begin(BAND_FILE_MAGIC), end(BAND_FILE_MAGIC), header.magic);
+    header.version = BAND_FILE_VERSION;
+    header.scalarType = uint32_t(scalarTypeOf<T>());
+    header.n = n;
+    header.m = uint64_t(AL.bandwidth());
+    header.layout = uint32_t(BandLayout::RowMajorLower);
+    header.rowStride = uint32_t(AL.rowStride());
+    header.offsetAL = BAND_FILE_PAGE;
+    header.offsetD = alignToPage(header.offsetAL + bytesAL);
+    header.offsetF = F != nullptr ? alignToPage(header.offsetD + bytesVector) : 0;
+    header.fileSize = (F != nullptr ? header.offsetF : header.offsetD) + bytesVector;
+
+    uint64_t checksum = fnv1a64(AL.raw(), bytesAL);
+    checksum = fnv1a64(D.data(), bytesVector, checksum);
+    if (F != nullptr)
+    {
+        checksum = fnv1a64(F->data(), bytesVector, checksum);
+    }
+    header.checksum = checksum;
+
+    ofstream file(filePath, ios::binary | ios::trunc);
+    if (!file.is_open())
+    {
+        throw runtime_error("Could not open file: " + filePath);
+    }
+
+    file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    writePadding(file, header.offsetAL);
+    file.write(reinterpret_cast<const char *>(AL.raw()), streamsize(bytesAL));
+    writePadding(file, header.offsetD);
+    file.write(reinterpret_cast<const char *>(D.data()), streamsize(bytesVector));
+    if (F != nullptr)
+    {
+        writePadding(file, header.offsetF);
+        file.write(reinterpret_cast<const char *>(F->data()), streamsize(bytesVector));
+    }
+
+    if (!file)
+    {
+        throw runtime_error("Could not write file: " + filePath);
+    }
+    file.close();
+}
+
+template <typename T>
+void writeVectorFile(const string &filePath, const T *values, size_t n)
+{
+    VectorFileWriter<T> writer(filePath, n);
+    writer.append(values, n);
+    writer.close();
+}
+
+template <typename T>
+VectorFileWriter<T>::VectorFileWriter(const string &filePath, size_t n)
+    : file(filePath, ios::binary | ios::trunc), path(filePath), header(), written(0)
+{
+    if (!file.is_open())
+    {
+        throw runtime_error("Could not open file: " + filePath);
+    }
+    copy(begin(BAND_FILE_MAGIC), end(BAND_FILE_MAGIC), header.magic);
+    header.version = BAND_FILE_VERSION;
+    header.scalarType = uint32_t(scalarTypeOf<T>());
+    header.n = n;
+    header.layout = uint32_t(BandLayout::Vector);
+    header.offsetF = BAND_FILE_PAGE;
+    header.fileSize = header.offsetF + n * sizeof(T);
+    header.checksum = fnv1a64(nullptr, 0);
+    writePadding(file, header.offsetF);
+}
+
+template <typename T>
+void VectorFileWriter<T>::append(const T *values, size_t count)
+{
+    if (count > header.n - written)
+    {
+        throw logic_error("VectorFileWriter: more than " + to_string(header.n) + " values appended to " + path);
+    }
+    file.write(reinterpret_cast<const char *>(values), streamsize(count * sizeof(T)));
+    header.checksum = fnv1a64(values, count * sizeof(T), header.checksum);
+    written += count;
+}
+
+template <typename T>
+void VectorFileWriter<T>::close()
+{
+    if (written != header.n)
+    {
+        throw logic_error("VectorFileWriter: " + to_string(written) + " of " + to_string(header.n) +
+                          " values appended to " + path);
+    }
+    file.seekp(0);
+    file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    file.close();
+    if (!file)
+    {
+        throw runtime_error("Could not write file: " + path);
+    }
+}
+
+MappedBandFile::MappedBandFile(const string &filePath, bool verifyChecksum) : base(nullptr), length(0)
+{
+    int fd = ::open(filePath.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        throw runtime_error("Could not open file: " + filePath);
+    }
+
+    struct stat status;
+    if (fstat(fd, &status) != 0 || size_t(status.st_size) < sizeof(BandFileHeader))
+    {
+        ::close(fd);
+        throw runtime_error("Not a band file: " + filePath);
+    }
+
+    length = size_t(status.st_size);
+    base = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (base == MAP_FAILED)
+    {
+        base = nullptr;
+        throw runtime_error("Could not map file: " + filePath);
+    }
+
+    memcpy(&info, base, sizeof(info));
+
+    const uint64_t scalarSize = info.scalarType == uint32_t(BandScalarType::Float32) ? sizeof(float) : sizeof(double);
+    uint64_t bytesVector = 0;
+    uint64_t bytesAL = 0;
+    const bool sizesOverflow = __builtin_mul_overflow(info.n, scalarSize, &bytesVector) ||
+                               __builtin_mul_overflow(info.n, uint64_t(info.rowStride), &bytesAL) ||
+                               __builtin_mul_overflow(bytesAL, scalarSize, &bytesAL);
+    string problem;
+    if (!equal(begin(BAND_FILE_MAGIC), end(BAND_FILE_MAGIC), info.magic))
+    {
+        problem = "bad magic";
+    }
+    else if (info.version != BAND_FILE_VERSION)
+    {
+        problem = "unsupported version " + to_string(info.version);
+    }
+    else if (info.scalarType != uint32_t(BandScalarType::Float32) && info.scalarType != uint32_t(BandScalarType::Float64))
+    {
+        problem = "unknown scalar type";
+    }
+    else if (info.layout != uint32_t(BandLayout::RowMajorLower) && info.layout != uint32_t(BandLayout::Vector))
+    {
+        problem = "unknown layout";
+    }
+    else if (info.layout == uint32_t(BandLayout::Vector))
+    {
+        if (info.n > uint64_t(numeric_limits<int>::max()) || info.m != 0 || info.rowStride != 0 ||
+            info.offsetAL != 0 || info.offsetD != 0 || info.offsetF == 0 || info.offsetF % BAND_FILE_PAGE != 0 ||
+            info.fileSize != length || sizesOverflow || !sectionFits(info.offsetF, bytesVector, length))
+        {
+            problem = "inconsistent section table";
+        }
+        else if (verifyChecksum && fnv1a64(static_cast<const char *>(base) + info.offsetF, bytesVector) != info.checksum)
+        {
+            problem = "checksum mismatch";
+        }
+    }
+    else if (info.n > uint64_t(numeric_limits<int>::max()) || info.m > info.n ||
+             info.rowStride != expectedRowStride(info.scalarType, info.m))
+    {
+        problem = "row stride " + to_string(info.rowStride) + " does not match bandwidth " + to_string(info.m);
+    }
+    else if (info.fileSize != length || sizesOverflow ||
+             info.offsetAL % BAND_FILE_PAGE != 0 || info.offsetD % BAND_FILE_PAGE != 0 ||
+             info.offsetF % BAND_FILE_PAGE != 0 ||
+             !sectionFits(info.offsetAL, bytesAL, info.offsetD) ||
+             !sectionFits(info.offsetD, bytesVector, length) ||
+             (info.offsetF != 0 && !sectionFits(info.offsetF, bytesVector, length)))
+    {
+        problem = "inconsistent section table";
+    }
+    else if (verifyChecksum)
+    {
+        const char *bytes = static_cast<const char *>(base);
+        uint64_t checksum = fnv1a64(bytes + info.offsetAL, bytesAL);
+        checksum = fnv1a64(bytes + info.offsetD, bytesVector, checksum);
+        if (info.offsetF != 0)
+        {
+            checksum = fnv1a64(bytes + info.offsetF, bytesVector, checksum);
+        }
+        if (checksum != info.checksum)
+        {
+            problem = "checksum mismatch";
+        }
+    }
+
+    if (!problem.empty())
+    {
+        munmap(base, length);
+        base = nullptr;
+        throw runtime_error("Invalid band file " + filePath + ": " + problem);
+    }
+}
+
+MappedBandFile::~MappedBandFile()
+{
+    if (base != nullptr)
+    {
+        munmap(base, length);
+    }
+}
+
+template <typename T>
+T *MappedBandFile::section(uint64_t offset) const
+{
+    if (scalarTypeOf<T>() != scalarType())
+    {
+        throw runtime_error("Band file scalar type does not match the requested precision");
+    }
+    return reinterpret_cast<T *>(static_cast<char *>(base) + offset);
+}
+
+template <typename T>
+BandMatrix<T> mapBandMatrix(const shared_ptr<MappedBandFile> &file)
+{
+    if (file->layout() != BandLayout::RowMajorLower)
+    {
+        throw runtime_error("Band file holds a vector, not a band system");
+    }
+    if (int(file->header().rowStride) != BandMatrix<T>::paddedStride(file->bandwidth()))
+    {
+        throw runtime_error("Band file row stride does not match the in-memory layout");
+    }
+
+    BandMatrix<T> view;
+    view.attach(file->AL<T>(), file->size(), file->bandwidth(), file);
+    return view;
+}
+
+template void writeBandFile<float>(const string &, const BandMatrix<float> &, const vector<float> &, const vector<float> *);
+template void writeBandFile<double>(const string &, const BandMatrix<double> &, const vector<double> &, const vector<double> *);
+template void writeVectorFile<float>(const string &, const float *, size_t);
+template void writeVectorFile<double>(const string &, const double *, size_t);
+template class VectorFileWriter<float>;
+template class VectorFileWriter<double>;
+template float *MappedBandFile::section<float>(uint64_t) const;
+template double *MappedBandFile::section<double>(uint64_t) const;
+template BandMatrix<float> mapBandMatrix<float>(const shared_ptr<MappedBandFile> &);
+template BandMatrix<double> mapBandMatrix<double>(const shared_ptr<MappedBandFile> &);
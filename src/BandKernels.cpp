@@ -0,0 +1,422 @@
+/**
+ * @file BandKernels.cpp
+ * @brief Implementation of the substitution and multiplication kernels on band storage.
+ */
+#include "BandKernels.hpp"
+#include "FixedBandKernels.hpp"
+
+#include <omp.h>
+
+namespace
+{
+    /// Upper bound on the threads that share one row in the wide-band sweeps.
+    constexpr int MAX_ROW_THREADS = 64;
+
+    /// One partial sum per thread, padded to a cache line so threads do not share lines.
+    template <typename Acc>
+    struct alignas(64) PartialSum
+    {
+        Acc value;
+    };
+
+    /// Piece t of [begin, end) split into parts nearly equal contiguous pieces.
+    inline pair<int, int> piece(int begin, int end, int t, int parts)
+    {
+        long long length = end - begin;
+        return {begin + int(length * t / parts), begin + int(length * (t + 1) / parts)};
+    }
+
+    template <typename T, typename Acc>
+    void forwardSerial(const BandMatrix<T> &L, T *x)
+    {
+        const int n = L.rows();
+        const int m = L.bandwidth();
+
+        for (int i = 0; i < n; ++i)
+        {
+            int jBegin = max(0, i - m);
+            Acc sumF = bandDot<T, Acc>(L[i] + (m - i) + jBegin, x + jBegin, i - jBegin);
+            x[i] = T(x[i] - sumF);
+        }
+    }
+
+    /// Forward sweep with every row dot product split between the threads.
+    template <typename T, typename Acc>
+    void forwardWide(const BandMatrix<T> &L, T *x, int threads)
+    {
+        const int n = L.rows();
+        const int m = L.bandwidth();
+        PartialSum<Acc> partial[MAX_ROW_THREADS];
+
+#pragma omp parallel num_threads(min(threads, MAX_ROW_THREADS))
+        {
+            const int t = omp_get_thread_num();
+            const int parts = omp_get_num_threads();
+
+            for (int i = 0; i < n; ++i)
+            {
+                auto [jBegin, jEnd] = piece(max(0, i - m), i, t, parts);
+                partial[t].value = bandDot<T, Acc>(L[i] + (m - i) + jBegin, x + jBegin, jEnd - jBegin);
+#pragma omp barrier
+#pragma omp single
+                {
+                    Acc sumF = 0;
+                    for (int p = 0; p < parts; ++p)
+                    {
+                        sumF += partial[p].value;
+                    }
+                    x[i] = T(x[i] - sumF);
+                }
+            }
+        }
+    }
+
+    template <typename T, typename Acc>
+    void forwardBlock(const BandMatrix<T> &L, T *block, int k, int ld)
+    {
+        const int n = L.rows();
+        const int m = L.bandwidth();
+
+        for (int i = 0; i < n; ++i)
+        {
+            int jBegin = max(0, i - m);
+            int len = i - jBegin;
+            const T *row = L[i] + (m - i) + jBegin;
+
+            for (int c = 0; c < k; ++c)
+            {
+                T *column = block + size_t(c) * ld;
+                Acc sumF = bandDot<T, Acc>(row, column + jBegin, len);
+                column[i] = T(column[i] - sumF);
+            }
+        }
+    }
+
+    /**
+     * Row-oriented backward sweep. With inverseD, entry i is scaled by 1 / D(i) right before
+     * the first row that updates it, which is row min(n - 1, i + m); every entry
+     * therefore sees the same operations as in a separate diagonal pass.
+     */
+    template <typename T, typename Acc>
+    void backwardSerial(const BandMatrix<T> &L, const T *inverseD, T *x, Acc *work)
+    {
+        const int n = L.rows();
+        const int m = L.bandwidth();
+
+        if constexpr (is_same_v<Acc, T>)
+        {
+            work = x;
+        }
+        else
+        {
+            // Partial sums are kept in the wider type and rounded once per entry.
+            copy(x, x + n, work);
+        }
+
+        if (inverseD != nullptr)
+        {
+            for (int i = max(0, n - 1 - m); i < n; ++i)
+            {
+                work[i] = Acc(T(x[i] * inverseD[i]));
+            }
+        }
+        for (int j = n - 1; j >= 0; --j)
+        {
+            int iBegin = max(0, j - m);
+            if (inverseD != nullptr && j < n - 1 && j - m >= 0)
+            {
+                work[j - m] = Acc(T(x[j - m] * inverseD[j - m]));
+            }
+            x[j] = T(work[j]);
+            bandAxpy<T, Acc>(work + iBegin, -Acc(x[j]), L[j] + (m - j) + iBegin, j - iBegin);
+        }
+    }
+
+    /// Backward sweep with every row axpy split between the threads, one barrier per row.
+    template <typename T, typename Acc>
+    void backwardWide(const BandMatrix<T> &L, const T *inverseD, T *x, Acc *work, int threads)
+    {
+        const int n = L.rows();
+        const int m = L.bandwidth();
+
+        if constexpr (is_same_v<Acc, T>)
+        {
+            work = x;
+        }
+        else
+        {
+            copy(x, x + n, work);
+        }
+
+#pragma omp parallel num_threads(min(threads, MAX_ROW_THREADS))
+        {
+            const int t = omp_get_thread_num();
+            const int parts = omp_get_num_threads();
+
+            if (inverseD != nullptr)
+            {
+#pragma omp for schedule(static)
+                for (int i = max(0, n - 1 - m); i < n; ++i)
+                {
+                    work[i] = Acc(T(x[i] * inverseD[i]));
+                }
+            }
+
+            for (int j = n - 1; j >= 0; --j)
+            {
+                // Every thread reads the final x(j); only the first one stores it.
+                T xj = T(work[j]);
+                auto [iBegin, iEnd] = piece(max(0, j - m), j, t, parts);
+                if (inverseD != nullptr && j < n - 1 && j - m >= 0 && iBegin == j - m && iEnd > iBegin)
+                {
+                    work[j - m] = Acc(T(x[j - m] * inverseD[j - m]));
+                }
+                bandAxpy<T, Acc>(work + iBegin, -Acc(xj), L[j] + (m - j) + iBegin, iEnd - iBegin);
+#pragma omp barrier
+                if (t == 0)
+                {
+                    x[j] = xj;
+                }
+            }
+        }
+    }
+
+    /// Gathered-column backward sweep on a block, with an optional fused scaling by 1 / D.
+    template <typename T, typename Acc>
+    void backwardBlock(const BandMatrix<T> &L, const T *inverseD, T *block, int k, int ld, T *columnL)
+    {
+        const int n = L.rows();
+        const int m = L.bandwidth();
+
+        for (int i = n - 1; i >= 0; --i)
+        {
+            int jEnd = min(n - 1, i + m);
+            int len = jEnd - i;
+            for (int j = i + 1; j <= jEnd; ++j)
+            {
+                columnL[j - i - 1] = L[j][m - j + i];
+            }
+
+            for (int c = 0; c < k; ++c)
+            {
+                T *column = block + size_t(c) * ld;
+                Acc sumF = bandDot<T, Acc>(columnL, column + i + 1, len);
+                T zi = inverseD != nullptr ? T(column[i] * inverseD[i]) : column[i];
+                column[i] = T(zi - sumF);
+            }
+        }
+    }
+
+    /// Runs backwardBlock() on contiguous groups of columns, one group per thread.
+    template <typename T, typename Acc>
+    void backwardBlockDispatch(const BandMatrix<T> &L, const T *inverseD, T *block, int k, int ld, T *columnL, int threads)
+    {
+        const int m = L.bandwidth();
+        const int groups = bandSweepColumnGroups(L.rows(), m, k, threads);
+
+        vector<T> owned;
+        if (columnL == nullptr)
+        {
+            owned.resize(size_t(max(m, 1)) * groups);
+            columnL = owned.data();
+        }
+
+#pragma omp parallel for schedule(static, 1) num_threads(groups) if (groups > 1)
+        for (int g = 0; g < groups; ++g)
+        {
+            auto [c0, c1] = piece(0, k, g, groups);
+            backwardBlock<T, Acc>(L, inverseD, block + size_t(c0) * ld, c1 - c0, ld, columnL + size_t(max(m, 1)) * g);
+        }
+    }
+
+    template <typename T, typename Acc>
+    bool splitRows(const BandMatrix<T> &L, int threads)
+    {
+        return threads > 1 && L.bandwidth() >= SWEEP_ROW_PARALLEL_MIN_BANDWIDTH;
+    }
+}
+
+int bandSweepColumnGroups(int n, int m, int k, int threads)
+{
+    bool split = threads > 1 && k > 1 && double(n) * (m + 1) * k >= SWEEP_COLUMN_PARALLEL_MIN_WORK;
+    return split ? min(threads, k) : 1;
+}
+
+template <typename T, typename Acc>
+void bandForwardSubstitution(const BandMatrix<T> &L, T *x, int threads)
+{
+    if (hasFixedBandKernel(L.bandwidth()))
+    {
+        fixedBandForwardSubstitution<T, Acc>(L, x);
+    }
+    else if (splitRows<T, Acc>(L, threads))
+    {
+        forwardWide<T, Acc>(L, x, threads);
+    }
+    else
+    {
+        forwardSerial<T, Acc>(L, x);
+    }
+}
+
+template <typename T>
+void bandDiagonalSubstitution(const T *inverseD, int n, T *x)
+{
+    for (int i = 0; i < n; ++i)
+    {
+        x[i] *= inverseD[i];
+    }
+}
+
+template <typename T, typename Acc>
+void bandBackwardSubstitution(const BandMatrix<T> &L, T *x, Acc *work, int threads)
+{
+    bandDiagonalBackwardSubstitution<T, Acc>(L, nullptr, x, work, threads);
+}
+
+template <typename T, typename Acc>
+void bandDiagonalBackwardSubstitution(const BandMatrix<T> &L, const T *inverseD, T *x, Acc *work, int threads)
+{
+    if (hasFixedBandKernel(L.bandwidth()))
+    {
+        // The open partial sums fit in registers, so work is not needed.
+        fixedBandBackwardSubstitution<T, Acc>(L, inverseD, x);
+        return;
+    }
+
+    vector<Acc> owned;
+    if (!is_same_v<Acc, T> && work == nullptr)
+    {
+        owned.resize(L.rows());
+        work = owned.data();
+    }
+
+    if (splitRows<T, Acc>(L, threads))
+    {
+        backwardWide<T, Acc>(L, inverseD, x, work, threads);
+    }
+    else
+    {
+        backwardSerial<T, Acc>(L, inverseD, x, work);
+    }
+}
+
+template <typename T, typename Acc>
+void bandForwardSubstitution(const BandMatrix<T> &L, T *block, int k, int ld, int threads)
+{
+    const int groups = bandSweepColumnGroups(L.rows(), L.bandwidth(), k, threads);
+
+#pragma omp parallel for schedule(static, 1) num_threads(groups) if (groups > 1)
+    for (int g = 0; g < groups; ++g)
+    {
+        auto [c0, c1] = piece(0, k, g, groups);
+        forwardBlock<T, Acc>(L, block + size_t(c0) * ld, c1 - c0, ld);
+    }
+}
+
+template <typename T>
+void bandDiagonalSubstitution(const T *inverseD, int n, T *block, int k, int ld)
+{
+    for (int c = 0; c < k; ++c)
+    {
+        T *column = block + size_t(c) * ld;
+        for (int i = 0; i < n; ++i)
+        {
+            column[i] *= inverseD[i];
+        }
+    }
+}
+
+template <typename T, typename Acc>
+void bandBackwardSubstitution(const BandMatrix<T> &L, T *block, int k, int ld, T *columnL, int threads)
+{
+    backwardBlockDispatch<T, Acc>(L, nullptr, block, k, ld, columnL, threads);
+}
+
+template <typename T, typename Acc>
+void bandDiagonalBackwardSubstitution(const BandMatrix<T> &L, const T *inverseD, T *block, int k, int ld, T *columnL, int threads)
+{
+    backwardBlockDispatch<T, Acc>(L, inverseD, block, k, ld, columnL, threads);
+}
+
+template <typename T, typename Acc>
+void bandMultiply(const BandMatrix<T> &AL, const T *D, const T *x, Acc *y, int threads)
+{
+    const int n = AL.rows();
+    const int m = AL.bandwidth();
+
+    if (threads > 1)
+    {
+#pragma omp parallel for schedule(static) num_threads(threads)
+        for (int i = 0; i < n; ++i)
+        {
+            int jBegin = max(0, i - m);
+            int kEnd = min(n - 1, i + m);
+            Acc result = Acc(D[i]) * x[i] + bandDot<T, Acc>(AL[i] + (m - i) + jBegin, x + jBegin, i - jBegin);
+            for (int k = i + 1; k <= kEnd; ++k)
+            {
+                result += Acc(AL[k][m - k + i]) * x[k];
+            }
+            y[i] = result;
+        }
+        return;
+    }
+
+    for (int i = 0; i < n; ++i)
+    {
+        y[i] = Acc(D[i]) * x[i];
+    }
+
+    for (int i = 0; i < n; ++i)
+    {
+        int jBegin = max(0, i - m);
+        const T *row = AL[i] + (m - i) + jBegin;
+        y[i] += bandDot<T, Acc>(row, x + jBegin, i - jBegin);
+        bandAxpy<T, Acc>(y + jBegin, Acc(x[i]), row, i - jBegin);
+    }
+}
+
+template <typename T, typename Acc>
+ResidualNorms bandResidual(const BandMatrix<T> &AL, const T *D, const T *x, const T *f, Acc *r, int threads)
+{
+    const int n = AL.rows();
+    bandMultiply(AL, D, x, r, threads);
+
+    double squares = 0, squaresF = 0, largest = 0;
+#pragma omp parallel for schedule(static) num_threads(max(threads, 1)) if (threads > 1) \
+    reduction(+ : squares, squaresF) reduction(max : largest)
+    for (int i = 0; i < n; ++i)
+    {
+        r[i] = Acc(f[i]) - r[i];
+        double ri = double(r[i]);
+        squares += ri * ri;
+        squaresF += double(f[i]) * double(f[i]);
+        largest = max(largest, fabs(ri));
+    }
+
+    ResidualNorms norms;
+    norms.l2 = sqrt(squares);
+    norms.inf = largest;
+    norms.relative = squaresF > 0 ? norms.l2 / sqrt(squaresF) : norms.l2;
+    return norms;
+}
+
+#define INSTANTIATE_BAND_KERNELS(T, Acc)                                                                             \
+    template void bandForwardSubstitution<T, Acc>(const BandMatrix<T> &, T *, int);                                  \
+    template void bandBackwardSubstitution<T, Acc>(const BandMatrix<T> &, T *, Acc *, int);                          \
+    template void bandDiagonalBackwardSubstitution<T, Acc>(const BandMatrix<T> &, const T *, T *, Acc *, int);       \
+    template void bandForwardSubstitution<T, Acc>(const BandMatrix<T> &, T *, int, int, int);                        \
+    template void bandBackwardSubstitution<T, Acc>(const BandMatrix<T> &, T *, int, int, T *, int);                  \
+    template void bandDiagonalBackwardSubstitution<T, Acc>(const BandMatrix<T> &, const T *, T *, int, int, T *,     \
+                                                           int);                                                     \
+    template void bandMultiply<T, Acc>(const BandMatrix<T> &, const T *, const T *, Acc *, int);                     \
+    template ResidualNorms bandResidual<T, Acc>(const BandMatrix<T> &, const T *, const T *, const T *, Acc *, int);
+
+INSTANTIATE_BAND_KERNELS(float, float)
+INSTANTIATE_BAND_KERNELS(double, double)
+INSTANTIATE_BAND_KERNELS(float, double)
+
+template void bandDiagonalSubstitution<float>(const float *, int, float *);
+template void bandDiagonalSubstitution<double>(const double *, int, double *);
+template void bandDiagonalSubstitution<float>(const float *, int, float *, int, int);
+template void bandDiagonalSubstitution<double>(const double *, int, double *, int, int);
@@ -0,0 +1,156 @@
+/**
+ * @file BandMatrix.cpp
+ * @brief Implementation of the contiguous band storage used by SLAUSolverLDLT.
+ */
+#include "BandMatrix.hpp"
+
+template <typename T>
+BandMatrix<T>::BandMatrix() : data(nullptr), n(0), m(0), stride(0), capacity(0)
+{
+}
+
+template <typename T>
+BandMatrix<T>::BandMatrix(int rows, int bandwidth) : BandMatrix()
+{
+    resize(rows, bandwidth);
+}
+
+template <typename T>
+BandMatrix<T>::BandMatrix(const BandMatrix &other) : BandMatrix()
+{
+    *this = other;
+}
+
+template <typename T>
+BandMatrix<T>::BandMatrix(BandMatrix &&other) noexcept
+    : data(other.data), n(other.n), m(other.m), stride(other.stride), capacity(other.capacity),
+      external(std::move(other.external))
+{
+    other.data = nullptr;
+    other.n = other.m = other.stride = 0;
+    other.capacity = 0;
+}
+
+template <typename T>
+BandMatrix<T> &BandMatrix<T>::operator=(const BandMatrix &other)
+{
+    if (this != &other)
+    {
+        resize(other.n, other.m);
+        copy(other.data, other.data + size_t(n) * stride, data);
+    }
+    return *this;
+}
+
+template <typename T>
+BandMatrix<T> &BandMatrix<T>::operator=(BandMatrix &&other) noexcept
+{
+    if (this != &other)
+    {
+        release();
+        data = other.data;
+        n = other.n;
+        m = other.m;
+        stride = other.stride;
+        capacity = other.capacity;
+        external = std::move(other.external);
+        other.data = nullptr;
+        other.n = other.m = other.stride = 0;
+        other.capacity = 0;
+    }
+    return *this;
+}
+
+template <typename T>
+BandMatrix<T>::~BandMatrix()
+{
+    release();
+}
+
+template <typename T>
+void BandMatrix<T>::release()
+{
+    if (data != nullptr && external == nullptr)
+    {
+        ::operator delete[](data, align_val_t(ALIGNMENT));
+    }
+    data = nullptr;
+    external.reset();
+    capacity = 0;
+}
+
+template <typename T>
+int BandMatrix<T>::paddedStride(int bandwidth)
+{
+    const int lanes = int(SIMD_BYTES / sizeof(T));
+    if (bandwidth <= 0)
+    {
+        return 0;
+    }
+    if (bandwidth < lanes)
+    {
+        int width = 1;
+        while (width < bandwidth)
+        {
+            width <<= 1;
+        }
+        return width;
+    }
+    return (bandwidth + lanes - 1) / lanes * lanes;
+}
+
+template <typename T>
+void BandMatrix<T>::resize(int rows, int bandwidth)
+{
+    if (rows < 0 || bandwidth < 0)
+    {
+        throw invalid_argument("BandMatrix: negative dimensions");
+    }
+
+    n = rows;
+    m = bandwidth;
+    stride = paddedStride(m);
+
+    // Owned storage that is large enough is kept, so reshaping to the same or a
+    // smaller system does not touch the heap.
+    size_t required = size_t(n) * stride;
+    if (required > capacity || external != nullptr)
+    {
+        release();
+        if (required > 0)
+        {
+            data = static_cast<T *>(::operator new[](required * sizeof(T), align_val_t(ALIGNMENT)));
+            capacity = required;
+        }
+    }
+    fillZero();
+}
+
+template <typename T>
+void BandMatrix<T>::attach(T *storage, int rows, int bandwidth, shared_ptr<const void> owner)
+{
+    if (reinterpret_cast<uintptr_t>(storage) % ALIGNMENT != 0)
+    {
+        throw invalid_argument("BandMatrix: attached storage is not aligned");
+    }
+    if (owner == nullptr)
+    {
+        throw invalid_argument("BandMatrix: attached storage needs an owner");
+    }
+
+    release();
+    data = storage;
+    n = rows;
+    m = bandwidth;
+    stride = paddedStride(m);
+    external = std::move(owner);
+}
+
+template <typename T>
+void BandMatrix<T>::fillZero()
+{
+    fill(data, data + size_t(n) * stride, T(0));
+}
+
+template class BandMatrix<float>;
+template class BandMatrix<double>;
@@ -0,0 +1,228 @@
+/**
+ * @file BatchedLDLTSolver.cpp
+ * @brief Implementation of the batched structure-of-arrays band LDLT solver.
+ */
+#include "BatchedLDLTSolver.hpp"
+
+// The chunk kernels are compiled once per instruction set and picked by the loader,
+// so the lanes use the widest vectors of the machine without -march.
+#if defined(__x86_64__) && defined(__GNUC__) && !defined(__clang__)
+#define LDLT_BATCH_CLONES __attribute__((target_clones("arch=skylake-avx512", "arch=haswell", "default")))
+#else
+#define LDLT_BATCH_CLONES
+#endif
+
+namespace
+{
+    constexpr int LANES = BatchedLDLTSolver<double, double>::CHUNK;
+
+    /**
+     * @brief Factors the systems [s0, s0 + w) with the order of operations of the serial kernel.
+     */
+    template <typename T, typename Acc>
+    LDLT_BATCH_CLONES void factorChunk(BandMatrix<T> &AL, BandMatrix<T> &D, int n, int m, int s0, int w)
+    {
+        Acc acc[LANES];
+
+        for (int i = 0; i < n; ++i)
+        {
+            int kBeginI = max(0, i - m);
+            T *di = D[i] + s0;
+
+#pragma omp simd
+            for (int l = 0; l < w; ++l)
+            {
+                acc[l] = 0;
+            }
+            for (int k = kBeginI; k < i; ++k)
+            {
+                const T *lik = AL[i * m + m - i + k] + s0;
+                const T *dk = D[k] + s0;
+#pragma omp simd
+                for (int l = 0; l < w; ++l)
+                {
+                    acc[l] += Acc(lik[l]) * lik[l] * dk[l];
+                }
+            }
+#pragma omp simd
+            for (int l = 0; l < w; ++l)
+            {
+                di[l] = T(di[l] - acc[l]);
+            }
+
+            for (int j = i + 1; j <= i + m && j < n; ++j)
+            {
+#pragma omp simd
+                for (int l = 0; l < w; ++l)
+                {
+                    acc[l] = 0;
+                }
+                for (int k = max(0, j - m); k < i; ++k)
+                {
+                    const T *ljk = AL[j * m + m - j + k] + s0;
+                    const T *lik = AL[i * m + m - i + k] + s0;
+                    const T *dk = D[k] + s0;
+#pragma omp simd
+                    for (int l = 0; l < w; ++l)
+                    {
+                        acc[l] += Acc(ljk[l]) * lik[l] * dk[l];
+                    }
+                }
+
+                T *lji = AL[j * m + m - j + i] + s0;
+#pragma omp simd
+                for (int l = 0; l < w; ++l)
+                {
+                    lji[l] = T((lji[l] - acc[l]) / di[l]);
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief Solves the systems [s0, s0 + w); the diagonal step is fused into the backward sweep.
+     */
+    template <typename T, typename Acc>
+    LDLT_BATCH_CLONES void solveChunk(const BandMatrix<T> &L, const BandMatrix<T> &D, BandMatrix<T> &X,
+                                      int n, int m, int s0, int w)
+    {
+        Acc acc[LANES];
+
+        for (int i = 0; i < n; ++i)
+        {
+#pragma omp simd
+            for (int l = 0; l < w; ++l)
+            {
+                acc[l] = 0;
+            }
+            for (int j = max(0, i - m); j < i; ++j)
+            {
+                const T *lij = L[i * m + m - i + j] + s0;
+                const T *xj = X[j] + s0;
+#pragma omp simd
+                for (int l = 0; l < w; ++l)
+                {
+                    acc[l] += Acc(lij[l]) * xj[l];
+                }
+            }
+            T *xi = X[i] + s0;
+#pragma omp simd
+            for (int l = 0; l < w; ++l)
+            {
+                xi[l] = T(xi[l] - acc[l]);
+            }
+        }
+
+        for (int i = n - 1; i >= 0; --i)
+        {
+#pragma omp simd
+            for (int l = 0; l < w; ++l)
+            {
+                acc[l] = 0;
+            }
+            for (int j = i + 1; j <= i + m && j < n; ++j)
+            {
+                const T *lji = L[j * m + m - j + i] + s0;
+                const T *xj = X[j] + s0;
+#pragma omp simd
+                for (int l = 0; l < w; ++l)
+                {
+                    acc[l] += Acc(lji[l]) * xj[l];
+                }
+            }
+            T *xi = X[i] + s0;
+            const T *di = D[i] + s0;
+#pragma omp simd
+            for (int l = 0; l < w; ++l)
+            {
+                xi[l] = T(T(xi[l] / di[l]) - acc[l]);
+            }
+        }
+    }
+}
+
+template <typename StorageT, typename AccumT>
+BatchedLDLTSolver<StorageT, AccumT>::BatchedLDLTSolver(int systems, int size, int bandwidth)
+    : count(systems), n(size), m(bandwidth), numThreads(1)
+{
+    if (systems < 0 || size < 0 || bandwidth < 0)
+    {
+        throw invalid_argument("Batch size, system size and bandwidth must be non-negative");
+    }
+    packAL.resize(n * m, count);
+    packD.resize(n, count);
+    packF.resize(n, count);
+}
+
+template <typename StorageT, typename AccumT>
+void BatchedLDLTSolver<StorageT, AccumT>::setNumThreads(int threads)
+{
+    numThreads = threads > 0 ? threads : omp_get_max_threads();
+}
+
+template <typename StorageT, typename AccumT>
+void BatchedLDLTSolver<StorageT, AccumT>::setSystem(int s, const BandMatrix<floatingPointType> &AL,
+                                                    const floatingPointType *D, const floatingPointType *F)
+{
+    if (s < 0 || s >= count)
+    {
+        throw invalid_argument("System index is outside the batch");
+    }
+    if (AL.rows() != n || AL.bandwidth() != m)
+    {
+        throw invalid_argument("System shape does not match the batch");
+    }
+
+    for (int i = 0; i < n; ++i)
+    {
+        for (int p = 0; p < m; ++p)
+        {
+            packAL[i * m + p][s] = AL[i][p];
+        }
+        packD[i][s] = D[i];
+        packF[i][s] = F[i];
+    }
+}
+
+template <typename StorageT, typename AccumT>
+void BatchedLDLTSolver<StorageT, AccumT>::getSolution(int s, floatingPointType *x) const
+{
+    if (s < 0 || s >= count)
+    {
+        throw invalid_argument("System index is outside the batch");
+    }
+    for (int i = 0; i < n; ++i)
+    {
+        x[i] = packF[i][s];
+    }
+}
+
+template <typename StorageT, typename AccumT>
+void BatchedLDLTSolver<StorageT, AccumT>::factor()
+{
+    const int chunks = (count + CHUNK - 1) / CHUNK;
+
+#pragma omp parallel for schedule(static) num_threads(numThreads) if (numThreads > 1)
+    for (int c = 0; c < chunks; ++c)
+    {
+        int s0 = c * CHUNK;
+        factorChunk<floatingPointType, sum>(packAL, packD, n, m, s0, min(CHUNK, count - s0));
+    }
+}
+
+template <typename StorageT, typename AccumT>
+void BatchedLDLTSolver<StorageT, AccumT>::solve()
+{
+    const int chunks = (count + CHUNK - 1) / CHUNK;
+
+#pragma omp parallel for schedule(static) num_threads(numThreads) if (numThreads > 1)
+    for (int c = 0; c < chunks; ++c)
+    {
+        int s0 = c * CHUNK;
+        solveChunk<floatingPointType, sum>(packAL, packD, packF, n, m, s0, min(CHUNK, count - s0));
+    }
+}
+
+template class BatchedLDLTSolver<float, float>;
+template class BatchedLDLTSolver<double, double>;
+template class BatchedLDLTSolver<float, double>;
@@ -0,0 +1,137 @@
+/**
+ * @file DeviceBackend.cpp
+ * @brief Backend selection, and the device classes of a build without a GPU backend.
+ *
+ * With LDLT_USE_CUDA or LDLT_USE_HIP the device classes and deviceCount() come
+ * from DeviceKernels.cu instead.
+ */
+#include "DeviceBackend.hpp"
+
+#if defined(LDLT_USE_CUDA) || defined(LDLT_USE_HIP)
+/// Number of visible devices, defined in DeviceKernels.cu.
+int deviceCount();
+#endif
+
+ComputeBackend parseComputeBackend(const string &name)
+{
+    if (name == "cpu")
+    {
+        return ComputeBackend::Cpu;
+    }
+    if (name == "cuda")
+    {
+        return ComputeBackend::Cuda;
+    }
+    if (name == "hip")
+    {
+        return ComputeBackend::Hip;
+    }
+    throw invalid_argument("Unknown backend '" + name + "' (expected cpu, cuda or hip)");
+}
+
+const char *computeBackendName(ComputeBackend backend)
+{
+    switch (backend)
+    {
+    case ComputeBackend::Cuda:
+        return "cuda";
+    case ComputeBackend::Hip:
+        return "hip";
+    default:
+        return "cpu";
+    }
+}
+
+ComputeBackend builtDeviceBackend()
+{
+#if defined(LDLT_USE_CUDA)
+    return ComputeBackend::Cuda;
+#elif defined(LDLT_USE_HIP)
+    return ComputeBackend::Hip;
+#else
+    return ComputeBackend::Cpu;
+#endif
+}
+
+void requireComputeBackend(ComputeBackend backend)
+{
+    if (backend == ComputeBackend::Cpu)
+    {
+        return;
+    }
+    if (backend != builtDeviceBackend())
+    {
+        throw runtime_error(string("The ") + computeBackendName(backend) + " backend is not built in; rebuild with 'make clean && make " +
+                            (backend == ComputeBackend::Cuda ? "CUDA=1" : "HIP=1") + "'");
+    }
+#if defined(LDLT_USE_CUDA) || defined(LDLT_USE_HIP)
+    if (deviceCount() == 0)
+    {
+        throw runtime_error(string("The ") + computeBackendName(backend) + " backend found no device");
+    }
+#endif
+}
+
+#if !defined(LDLT_USE_CUDA) && !defined(LDLT_USE_HIP)
+
+namespace
+{
+    [[noreturn]] void noDeviceBackend()
+    {
+        throw runtime_error("Built without a GPU backend; rebuild with 'make clean && make CUDA=1' or 'make clean && make HIP=1'");
+    }
+}
+
+template <typename StorageT, typename AccumT>
+DeviceBatchedLDLTSolver<StorageT, AccumT>::DeviceBatchedLDLTSolver(const Batch &)
+    : count(0), n(0), m(0), stride(0), deviceAL(nullptr), deviceD(nullptr), deviceF(nullptr)
+{
+    noDeviceBackend();
+}
+
+template <typename StorageT, typename AccumT>
+DeviceBatchedLDLTSolver<StorageT, AccumT>::~DeviceBatchedLDLTSolver() = default;
+
+template <typename StorageT, typename AccumT>
+void DeviceBatchedLDLTSolver<StorageT, AccumT>::factor()
+{
+    noDeviceBackend();
+}
+
+template <typename StorageT, typename AccumT>
+void DeviceBatchedLDLTSolver<StorageT, AccumT>::solve(Batch &)
+{
+    noDeviceBackend();
+}
+
+template <typename StorageT, typename AccumT>
+DeviceBandFactorization<StorageT, AccumT>::DeviceBandFactorization(const Factorization &)
+    : n(0), m(0), stride(0), deviceL(nullptr), deviceInverseD(nullptr), deviceBlock(nullptr), capacityColumns(0)
+{
+    noDeviceBackend();
+}
+
+template <typename StorageT, typename AccumT>
+DeviceBandFactorization<StorageT, AccumT>::~DeviceBandFactorization() = default;
+
+template <typename StorageT, typename AccumT>
+void DeviceBandFactorization<StorageT, AccumT>::reserveColumns(int)
+{
+    noDeviceBackend();
+}
+
+template <typename StorageT, typename AccumT>
+void DeviceBandFactorization<StorageT, AccumT>::solve(floatingPointType *, int, int)
+{
+    noDeviceBackend();
+}
+
+template class DeviceBatchedLDLTSolver<float, float>;
+template class DeviceBatchedLDLTSolver<double, double>;
+template class DeviceBatchedLDLTSolver<float, double>;
+
+template class DeviceBandFactorization<float, float>;
+template class DeviceBandFactorization<double, double>;
+template class DeviceBandFactorization<float, double>;
+
+#endif // !LDLT_USE_CUDA && !LDLT_USE_HIP
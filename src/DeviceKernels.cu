@@ -0,0 +1,420 @@
+/**
+ * @file DeviceKernels.cu
+ * @brief CUDA / HIP kernels and device memory of the GPU backend.
+ *
+ * The same source is compiled by nvcc with LDLT_USE_CUDA and by 'hipcc -x hip'
+ * with LDLT_USE_HIP; LDLT_GPU(Name) expands to cudaName or hipName. The batched
+ * kernels repeat the order of operations of BatchedLDLTSolver.cpp per system, so
+ * the device results differ from the host ones only by contraction into FMAs.
+ * The multi-right-hand-side solve reduces every row in a tree instead, so it
+ * matches the host solve to rounding only.
+ *
+ * Kernels are started with LDLT_LAUNCH(blocks, threads, kernel)(arguments). The
+ * host emulation of tests/device/cuda_runtime.h defines it to run the kernels on
+ * CPU threads, which lets 'make test' check them without a GPU.
+ */
+#include "DeviceBackend.hpp"
+
+#if defined(LDLT_USE_HIP)
+#include <hip/hip_runtime.h>
+#define LDLT_GPU(name) hip##name
+#else
+#include <cuda_runtime.h>
+#define LDLT_GPU(name) cuda##name
+#endif
+
+#ifndef LDLT_LAUNCH
+#define LDLT_LAUNCH(blocks, threads, ...) __VA_ARGS__<<<blocks, threads>>>
+#endif
+
+namespace
+{
+    constexpr int THREADS_PER_BLOCK = 128;
+
+    void check(LDLT_GPU(Error_t) status, const char *what)
+    {
+        if (status != LDLT_GPU(Success))
+        {
+            throw runtime_error(string(what) + ": " + LDLT_GPU(GetErrorString)(status));
+        }
+    }
+
+    template <typename T>
+    T *deviceAllocate(size_t elements)
+    {
+        void *pointer = nullptr;
+        if (elements > 0)
+        {
+            check(LDLT_GPU(Malloc)(&pointer, elements * sizeof(T)), "Device allocation");
+        }
+        return static_cast<T *>(pointer);
+    }
+
+    void deviceRelease(void *pointer)
+    {
+        if (pointer != nullptr)
+        {
+            LDLT_GPU(Free)(pointer);
+        }
+    }
+
+    template <typename T>
+    void copyToDevice(T *destination, const T *source, size_t elements)
+    {
+        if (elements > 0)
+        {
+            check(LDLT_GPU(Memcpy)(destination, source, elements * sizeof(T), LDLT_GPU(MemcpyHostToDevice)),
+                  "Copy to the device");
+        }
+    }
+
+    template <typename T>
+    void copyToHost(T *destination, const T *source, size_t elements)
+    {
+        if (elements > 0)
+        {
+            check(LDLT_GPU(Memcpy)(destination, source, elements * sizeof(T), LDLT_GPU(MemcpyDeviceToHost)),
+                  "Copy to the host");
+        }
+    }
+
+    unsigned blocksFor(size_t threads)
+    {
+        return unsigned((threads + THREADS_PER_BLOCK - 1) / THREADS_PER_BLOCK);
+    }
+
+    /// Threads that share the rows of one right-hand side: a power of two from 32 up to THREADS_PER_BLOCK.
+    unsigned rowThreadsFor(int m)
+    {
+        unsigned threads = 32;
+        while (threads < unsigned(m) && threads < unsigned(THREADS_PER_BLOCK))
+        {
+            threads *= 2;
+        }
+        return threads;
+    }
+
+    /// Reports a failed launch or a fault inside the kernel.
+    void finishKernel(const char *kernel)
+    {
+        check(LDLT_GPU(GetLastError)(), kernel);
+        check(LDLT_GPU(DeviceSynchronize)(), kernel);
+    }
+
+    /// Entry of system s in row `row` of a structure-of-arrays pack.
+    template <typename T>
+    __device__ inline T &packEntry(T *pack, size_t stride, int row, int s)
+    {
+        return pack[size_t(row) * stride + s];
+    }
+
+    /**
+     * @brief One thread per system; factorChunk() of BatchedLDLTSolver.cpp for a single lane.
+     */
+    template <typename T, typename Acc>
+    __global__ void factorBatchKernel(T *AL, T *D, int n, int m, int count, size_t stride)
+    {
+        const int s = int(blockIdx.x * blockDim.x + threadIdx.x);
+        if (s >= count)
+        {
+            return;
+        }
+
+        for (int i = 0; i < n; ++i)
+        {
+            Acc acc = 0;
+            for (int k = i > m ? i - m : 0; k < i; ++k)
+            {
+                T lik = packEntry(AL, stride, i * m + m - i + k, s);
+                acc += Acc(lik) * lik * packEntry(D, stride, k, s);
+            }
+            T di = T(packEntry(D, stride, i, s) - acc);
+            packEntry(D, stride, i, s) = di;
+
+            for (int j = i + 1; j <= i + m && j < n; ++j)
+            {
+                acc = 0;
+                for (int k = j > m ? j - m : 0; k < i; ++k)
+                {
+                    acc += Acc(packEntry(AL, stride, j * m + m - j + k, s)) * packEntry(AL, stride, i * m + m - i + k, s) *
+                           packEntry(D, stride, k, s);
+                }
+                T &lji = packEntry(AL, stride, j * m + m - j + i, s);
+                lji = T((lji - acc) / di);
+            }
+        }
+    }
+
+    /**
+     * @brief One thread per system; solveChunk() of BatchedLDLTSolver.cpp for a single lane.
+     */
+    template <typename T, typename Acc>
+    __global__ void solveBatchKernel(const T *L, const T *D, T *X, int n, int m, int count, size_t stride)
+    {
+        const int s = int(blockIdx.x * blockDim.x + threadIdx.x);
+        if (s >= count)
+        {
+            return;
+        }
+
+        for (int i = 0; i < n; ++i)
+        {
+            Acc acc = 0;
+            for (int j = i > m ? i - m : 0; j < i; ++j)
+            {
+                acc += Acc(L[size_t(i * m + m - i + j) * stride + s]) * X[size_t(j) * stride + s];
+            }
+            T &xi = packEntry(X, stride, i, s);
+            xi = T(xi - acc);
+        }
+
+        for (int i = n - 1; i >= 0; --i)
+        {
+            Acc acc = 0;
+            for (int j = i + 1; j <= i + m && j < n; ++j)
+            {
+                acc += Acc(L[size_t(j * m + m - j + i) * stride + s]) * X[size_t(j) * stride + s];
+            }
+            T &xi = packEntry(X, stride, i, s);
+            xi = T(T(xi / D[size_t(i) * stride + s]) - acc);
+        }
+    }
+
+    /**
+     * @brief Sum of value over the threads of the block, returned to every thread.
+     *
+     * partial holds blockDim.x entries; blockDim.x must be a power of two. The
+     * caller synchronizes before partial is used again.
+     */
+    template <typename Acc>
+    __device__ inline Acc blockSum(Acc *partial, Acc value)
+    {
+        partial[threadIdx.x] = value;
+        __syncthreads();
+        for (unsigned half = blockDim.x / 2; half > 0; half /= 2)
+        {
+            if (threadIdx.x < half)
+            {
+                partial[threadIdx.x] += partial[threadIdx.x + half];
+            }
+            __syncthreads();
+        }
+        return partial[0];
+    }
+
+    /**
+     * @brief One block per right-hand side: forward sweep, then the backward sweep with 1 / D fused in.
+     *
+     * The threads of a block split the band of every row; neighbouring threads read
+     * neighbouring entries of L in the forward sweep and of x in both sweeps. The
+     * rows still follow each other, so a block does O(n) reductions of at most m
+     * products each.
+     */
+    template <typename T, typename Acc>
+    __global__ void solveColumnsKernel(const T *L, const T *inverseD, T *block, int n, int m, size_t stride)
+    {
+        __shared__ Acc partial[THREADS_PER_BLOCK];
+        T *x = block + size_t(blockIdx.x) * n;
+        const int t = int(threadIdx.x);
+        const int threads = int(blockDim.x);
+
+        for (int i = 0; i < n; ++i)
+        {
+            const T *li = L + size_t(i) * stride + m - i;
+            Acc acc = 0;
+            for (int j = (i > m ? i - m : 0) + t; j < i; j += threads)
+            {
+                acc += Acc(li[j]) * x[j];
+            }
+            acc = blockSum(partial, acc);
+            if (t == 0)
+            {
+                x[i] = T(x[i] - acc);
+            }
+            __syncthreads();
+        }
+
+        for (int i = n - 1; i >= 0; --i)
+        {
+            Acc acc = 0;
+            for (int j = i + 1 + t; j <= i + m && j < n; j += threads)
+            {
+                acc += Acc(L[size_t(j) * stride + m - j + i]) * x[j];
+            }
+            acc = blockSum(partial, acc);
+            if (t == 0)
+            {
+                x[i] = T(x[i] * inverseD[i] - acc);
+            }
+            __syncthreads();
+        }
+    }
+}
+
+int deviceCount()
+{
+    int count = 0;
+    if (LDLT_GPU(GetDeviceCount)(&count) != LDLT_GPU(Success))
+    {
+        return 0;
+    }
+    return count;
+}
+
+template <typename StorageT, typename AccumT>
+DeviceBatchedLDLTSolver<StorageT, AccumT>::DeviceBatchedLDLTSolver(const Batch &batch)
+    : count(batch.systems()), n(batch.size()), m(batch.bandwidth()), stride(size_t(batch.packStride())),
+      deviceAL(nullptr), deviceD(nullptr), deviceF(nullptr)
+{
+    requireComputeBackend(builtDeviceBackend());
+    try
+    {
+        const size_t bandRows = size_t(n) * m;
+        deviceAL = deviceAllocate<floatingPointType>(bandRows * stride);
+        deviceD = deviceAllocate<floatingPointType>(size_t(n) * stride);
+        deviceF = deviceAllocate<floatingPointType>(size_t(n) * stride);
+        if (bandRows > 0)
+        {
+            copyToDevice(deviceAL, batch.AL(0, 0), bandRows * stride);
+        }
+        if (n > 0)
+        {
+            copyToDevice(deviceD, batch.D(0), size_t(n) * stride);
+        }
+    }
+    catch (...)
+    {
+        deviceRelease(deviceAL);
+        deviceRelease(deviceD);
+        deviceRelease(deviceF);
+        throw;
+    }
+}
+
+template <typename StorageT, typename AccumT>
+DeviceBatchedLDLTSolver<StorageT, AccumT>::~DeviceBatchedLDLTSolver()
+{
+    deviceRelease(deviceAL);
+    deviceRelease(deviceD);
+    deviceRelease(deviceF);
+}
+
+template <typename StorageT, typename AccumT>
+void DeviceBatchedLDLTSolver<StorageT, AccumT>::factor()
+{
+    if (count == 0 || n == 0)
+    {
+        return;
+    }
+    LDLT_LAUNCH(blocksFor(count), THREADS_PER_BLOCK, factorBatchKernel<floatingPointType, sum>)(deviceAL, deviceD, n, m, count,
+                                                                                               stride);
+    finishKernel("factorBatchKernel");
+}
+
+template <typename StorageT, typename AccumT>
+void DeviceBatchedLDLTSolver<StorageT, AccumT>::solve(Batch &batch)
+{
+    if (batch.systems() != count || batch.size() != n || batch.bandwidth() != m || size_t(batch.packStride()) != stride)
+    {
+        throw invalid_argument("Batch shape does not match the device pack");
+    }
+    if (count == 0 || n == 0)
+    {
+        return;
+    }
+
+    copyToDevice(deviceF, batch.F(0), size_t(n) * stride);
+    LDLT_LAUNCH(blocksFor(count), THREADS_PER_BLOCK, solveBatchKernel<floatingPointType, sum>)(deviceAL, deviceD, deviceF, n, m,
+                                                                                              count, stride);
+    finishKernel("solveBatchKernel");
+    copyToHost(batch.F(0), deviceF, size_t(n) * stride);
+}
+
+template <typename StorageT, typename AccumT>
+DeviceBandFactorization<StorageT, AccumT>::DeviceBandFactorization(const Factorization &factors)
+    : n(factors.size()), m(factors.bandwidth()), stride(size_t(factors.L().rowStride())), deviceL(nullptr),
+      deviceInverseD(nullptr), deviceBlock(nullptr), capacityColumns(0)
+{
+    requireComputeBackend(builtDeviceBackend());
+
+    // Same reciprocals as LDLTFactorization::invertDiagonal().
+    vector<floatingPointType> inverseD(n);
+    for (int i = 0; i < n; ++i)
+    {
+        inverseD[i] = floatingPointType(1) / factors.D()[i];
+    }
+
+    try
+    {
+        deviceL = deviceAllocate<floatingPointType>(size_t(n) * stride);
+        deviceInverseD = deviceAllocate<floatingPointType>(size_t(n));
+        if (n > 0)
+        {
+            copyToDevice(deviceL, factors.L()[0], size_t(n) * stride);
+        }
+        copyToDevice(deviceInverseD, inverseD.data(), size_t(n));
+    }
+    catch (...)
+    {
+        deviceRelease(deviceL);
+        deviceRelease(deviceInverseD);
+        throw;
+    }
+}
+
+template <typename StorageT, typename AccumT>
+DeviceBandFactorization<StorageT, AccumT>::~DeviceBandFactorization()
+{
+    deviceRelease(deviceL);
+    deviceRelease(deviceInverseD);
+    deviceRelease(deviceBlock);
+}
+
+template <typename StorageT, typename AccumT>
+void DeviceBandFactorization<StorageT, AccumT>::reserveColumns(int k)
+{
+    if (k <= capacityColumns)
+    {
+        return;
+    }
+    deviceRelease(deviceBlock);
+    deviceBlock = nullptr;
+    capacityColumns = 0;
+
+    deviceBlock = deviceAllocate<floatingPointType>(size_t(n) * k);
+    capacityColumns = k;
+}
+
+template <typename StorageT, typename AccumT>
+void DeviceBandFactorization<StorageT, AccumT>::solve(floatingPointType *block, int k, int ld)
+{
+    if (k < 0 || ld < n)
+    {
+        throw invalid_argument("Invalid right-hand side block shape");
+    }
+    if (k == 0 || n == 0)
+    {
+        return;
+    }
+    reserveColumns(k);
+
+    const size_t rowBytes = size_t(n) * sizeof(floatingPointType);
+    const size_t hostPitch = size_t(ld) * sizeof(floatingPointType);
+    check(LDLT_GPU(Memcpy2D)(deviceBlock, rowBytes, block, hostPitch, rowBytes, size_t(k), LDLT_GPU(MemcpyHostToDevice)),
+          "Copy of the right-hand sides to the device");
+
+    LDLT_LAUNCH(unsigned(k), rowThreadsFor(m), solveColumnsKernel<floatingPointType, sum>)(deviceL, deviceInverseD, deviceBlock,
+                                                                                          n, m, stride);
+    finishKernel("solveColumnsKernel");
+
+    check(LDLT_GPU(Memcpy2D)(block, hostPitch, deviceBlock, rowBytes, rowBytes, size_t(k), LDLT_GPU(MemcpyDeviceToHost)),
+          "Copy of the solutions to the host");
+}
+
+template class DeviceBatchedLDLTSolver<float, float>;
+template class DeviceBatchedLDLTSolver<double, double>;
+template class DeviceBatchedLDLTSolver<float, double>;
+
+template class DeviceBandFactorization<float, float>;
+template class DeviceBandFactorization<double, double>;
+template class DeviceBandFactorization<float, double>;
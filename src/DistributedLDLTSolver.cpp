@@ -0,0 +1,435 @@
+/**
+ * @file DistributedLDLTSolver.cpp
+ * @brief Implementation of the row-block partition, the spikes and the interface system.
+ */
+#ifdef LDLT_USE_MPI
+
+#include "DistributedLDLTSolver.hpp"
+
+namespace
+{
+    /// Values moved per message when the solution is collected on rank 0.
+    constexpr int SOLUTION_CHUNK = 1 << 20;
+
+    template <typename T>
+    MPI_Datatype mpiTypeOf();
+
+    template <>
+    MPI_Datatype mpiTypeOf<float>() { return MPI_FLOAT; }
+
+    template <>
+    MPI_Datatype mpiTypeOf<double>() { return MPI_DOUBLE; }
+}
+
+template <typename StorageT, typename AccumT>
+DistributedLDLTSolver<StorageT, AccumT>::DistributedLDLTSolver(MPI_Comm communicator, const string &bandFile,
+                                                               bool verifyChecksum)
+    : comm(communicator), numThreads(1)
+{
+    MPI_Comm_rank(comm, &rank);
+    MPI_Comm_size(comm, &ranks);
+
+    file = make_shared<MappedBandFile>(bandFile, verifyChecksum);
+    if (file->layout() != BandLayout::RowMajorLower)
+    {
+        throw runtime_error(bandFile + " does not hold a band matrix");
+    }
+    n = file->size();
+    m = file->bandwidth();
+
+    // A block of at least 2m rows keeps every interior at least m rows long, so
+    // separators of neighbouring ranks never touch each other directly.
+    int shortest = n;
+    for (int r = 0; r < ranks; ++r)
+    {
+        shortest = min(shortest, blockBegin(r + 1) - blockBegin(r));
+    }
+    if (ranks > 1 && shortest < 2 * max(m, 1))
+    {
+        throw invalid_argument("n = " + to_string(n) + " gives blocks of " + to_string(shortest) + " rows on " +
+                               to_string(ranks) + " ranks; every block needs at least 2m = " + to_string(2 * m) +
+                               " rows");
+    }
+
+    begin = blockBegin(rank);
+    end = blockBegin(rank + 1);
+    leftColumns = rank > 0 ? m : 0;
+    rightColumns = rank < ranks - 1 ? m : 0;
+    interiorEnd = end - rightColumns;
+
+    timings.ranks = ranks;
+    timings.reducedSize = (ranks - 1) * m;
+}
+
+template <typename StorageT, typename AccumT>
+void DistributedLDLTSolver<StorageT, AccumT>::setNumThreads(int threads)
+{
+    numThreads = threads > 0 ? threads : omp_get_max_threads();
+}
+
+template <typename StorageT, typename AccumT>
+auto DistributedLDLTSolver<StorageT, AccumT>::bandRow(int i) const -> const floatingPointType *
+{
+    return file->AL<floatingPointType>() + size_t(i) * file->header().rowStride;
+}
+
+template <typename StorageT, typename AccumT>
+auto DistributedLDLTSolver<StorageT, AccumT>::diagonal(int i) const -> floatingPointType
+{
+    return file->D<floatingPointType>()[i];
+}
+
+template <typename StorageT, typename AccumT>
+double DistributedLDLTSolver<StorageT, AccumT>::slowestRank(double seconds) const
+{
+    double slowest = 0;
+    MPI_Allreduce(&seconds, &slowest, 1, MPI_DOUBLE, MPI_MAX, comm);
+    return slowest;
+}
+
+template <typename StorageT, typename AccumT>
+auto DistributedLDLTSolver<StorageT, AccumT>::couplingTransposeTimes(const floatingPointType *v) const -> vector<sum>
+{
+    const int interiorRows = interiorEnd - begin;
+    vector<sum> product(leftColumns + rightColumns, sum(0));
+    for (int c = 0; c < leftColumns; ++c)
+    {
+        const floatingPointType *column = couplingLeft.data() + size_t(c) * m;
+        for (int u = 0; u < m; ++u)
+        {
+            product[c] += sum(column[u]) * sum(v[u]);
+        }
+    }
+    for (int c = 0; c < rightColumns; ++c)
+    {
+        const floatingPointType *column = couplingRight.data() + size_t(c) * m;
+        const floatingPointType *tail = v + (interiorRows - m);
+        for (int u = 0; u < m; ++u)
+        {
+            product[leftColumns + c] += sum(column[u]) * sum(tail[u]);
+        }
+    }
+    return product;
+}
+
+template <typename StorageT, typename AccumT>
+void DistributedLDLTSolver<StorageT, AccumT>::factorize()
+{
+    const int interiorRows = interiorEnd - begin;
+    const int columns = leftColumns + rightColumns;
+
+    // 1. A_Ir without the entries of the rows [begin, begin + m) that couple to S_(r-1).
+    double start = MPI_Wtime();
+    {
+        Solver local(interiorRows, m, "");
+        local.setNumThreads(numThreads);
+        vector<floatingPointType> row(m);
+        for (int i = begin; i < interiorEnd; ++i)
+        {
+            const floatingPointType *band = bandRow(i);
+            int outside = max(0, m - (i - begin));
+            fill(row.begin(), row.begin() + outside, floatingPointType(0));
+            copy(band + outside, band + m, row.begin() + outside);
+            local.setRow(i - begin, row.data(), diagonal(i));
+        }
+        interior = local.factorize();
+    }
+    timings.localFactorSeconds = slowestRank(MPI_Wtime() - start);
+
+    // 2. The nonzero corners of C_r: A(i, s) for the first m interior rows and S_(r-1),
+    //    and for the last m interior rows and S_r, then the spikes Y_r = A_Ir^-1 C_r.
+    start = MPI_Wtime();
+    couplingLeft.assign(size_t(leftColumns) * m, floatingPointType(0));
+    for (int t = 0; t < leftColumns; ++t)
+    {
+        const int s = begin - m + t;
+        for (int u = 0; u <= t; ++u)
+        {
+            const int i = begin + u;
+            couplingLeft[size_t(t) * m + u] = bandRow(i)[m - i + s];
+        }
+    }
+    couplingRight.assign(size_t(rightColumns) * m, floatingPointType(0));
+    for (int t = 0; t < rightColumns; ++t)
+    {
+        const int s = interiorEnd + t;
+        for (int u = t; u < m; ++u)
+        {
+            const int i = interiorEnd - m + u;
+            couplingRight[size_t(t) * m + u] = bandRow(s)[m - s + i];
+        }
+    }
+
+    spikes.assign(size_t(interiorRows) * columns, floatingPointType(0));
+    for (int c = 0; c < leftColumns; ++c)
+    {
+        copy_n(couplingLeft.data() + size_t(c) * m, m, spikes.data() + size_t(c) * interiorRows);
+    }
+    for (int c = 0; c < rightColumns; ++c)
+    {
+        copy_n(couplingRight.data() + size_t(c) * m, m,
+               spikes.data() + size_t(leftColumns + c) * interiorRows + (interiorRows - m));
+    }
+    if (columns > 0)
+    {
+        interior->solve(spikes.data(), columns, interiorRows);
+    }
+
+    // Contribution of this rank to the interface system in 2m x 2m slots: slot q is
+    // separator unknown (r - 1) m + q, so slots [0, m) are S_(r-1) and [m, 2m) are S_r.
+    const int slots = 2 * m;
+    const int firstSlot = m - leftColumns;
+    vector<sum> schur(size_t(slots) * slots, sum(0));
+    for (int c2 = 0; c2 < columns; ++c2)
+    {
+        vector<sum> column = couplingTransposeTimes(spikes.data() + size_t(c2) * interiorRows);
+        for (int c1 = 0; c1 < columns; ++c1)
+        {
+            schur[size_t(firstSlot + c2) * slots + firstSlot + c1] = -column[c1];
+        }
+    }
+    for (int t1 = 0; t1 < rightColumns; ++t1)
+    {
+        const int s1 = interiorEnd + t1;
+        for (int t2 = 0; t2 <= t1; ++t2)
+        {
+            const int s2 = interiorEnd + t2;
+            sum value = t1 == t2 ? sum(diagonal(s1)) : sum(bandRow(s1)[m - s1 + s2]);
+            schur[size_t(m + t2) * slots + m + t1] += value;
+            if (t1 != t2)
+            {
+                schur[size_t(m + t1) * slots + m + t2] += value;
+            }
+        }
+    }
+    timings.spikeSeconds = slowestRank(MPI_Wtime() - start);
+
+    // 3. Interface system on rank 0.
+    start = MPI_Wtime();
+    factorReduced(schur);
+    timings.reducedSeconds = slowestRank(MPI_Wtime() - start);
+}
+
+template <typename StorageT, typename AccumT>
+void DistributedLDLTSolver<StorageT, AccumT>::factorReduced(const vector<sum> &schur)
+{
+    const int reducedSize = (ranks - 1) * m;
+    if (reducedSize == 0)
+    {
+        return;
+    }
+
+    const int slots = 2 * m;
+    const int count = slots * slots;
+    vector<sum> gathered(rank == 0 ? size_t(count) * ranks : 0);
+    MPI_Gather(schur.data(), count, mpiTypeOf<sum>(), gathered.data(), count, mpiTypeOf<sum>(), 0, comm);
+    if (rank != 0)
+    {
+        return;
+    }
+
+    // Separators couple only through the interiors between them: A_S - C^T A_I^-1 C
+    // is block tridiagonal with m x m blocks, a band of width 2m - 1.
+    const int reducedBandwidth = min(2 * m - 1, reducedSize - 1);
+    vector<sum> band(size_t(reducedSize) * reducedBandwidth, sum(0));
+    vector<sum> diag(reducedSize, sum(0));
+    for (int r = 0; r < ranks; ++r)
+    {
+        const sum *block = gathered.data() + size_t(r) * count;
+        const int offset = (r - 1) * m;
+        for (int q1 = 0; q1 < slots; ++q1)
+        {
+            const int a = offset + q1;
+            if (a < 0 || a >= reducedSize)
+            {
+                continue;
+            }
+            for (int q2 = max(0, -offset); q2 <= q1; ++q2)
+            {
+                const int b = offset + q2;
+                sum value = block[size_t(q2) * slots + q1];
+                if (a == b)
+                {
+                    diag[a] += value;
+                }
+                else
+                {
+                    band[size_t(a) * reducedBandwidth + reducedBandwidth - a + b] += value;
+                }
+            }
+        }
+    }
+
+    Solver system(reducedSize, reducedBandwidth, "");
+    system.setNumThreads(numThreads);
+    vector<floatingPointType> row(reducedBandwidth);
+    for (int a = 0; a < reducedSize; ++a)
+    {
+        const sum *source = band.data() + size_t(a) * reducedBandwidth;
+        transform(source, source + reducedBandwidth, row.begin(), [](sum value) { return floatingPointType(value); });
+        system.setRow(a, row.data(), floatingPointType(diag[a]));
+    }
+    reduced = system.factorize();
+}
+
+template <typename StorageT, typename AccumT>
+auto DistributedLDLTSolver<StorageT, AccumT>::solveReduced(const vector<sum> &rhs) const -> vector<floatingPointType>
+{
+    const int reducedSize = (ranks - 1) * m;
+    vector<floatingPointType> separators(reducedSize);
+    if (reducedSize == 0)
+    {
+        return separators;
+    }
+
+    const int slots = 2 * m;
+    vector<sum> gathered(rank == 0 ? size_t(slots) * ranks : 0);
+    MPI_Gather(rhs.data(), slots, mpiTypeOf<sum>(), gathered.data(), slots, mpiTypeOf<sum>(), 0, comm);
+    if (rank == 0)
+    {
+        vector<sum> total(reducedSize, sum(0));
+        for (int r = 0; r < ranks; ++r)
+        {
+            const int offset = (r - 1) * m;
+            for (int q = max(0, -offset); q < slots && offset + q < reducedSize; ++q)
+            {
+                total[offset + q] += gathered[size_t(r) * slots + q];
+            }
+        }
+        transform(total.begin(), total.end(), separators.begin(), [](sum value) { return floatingPointType(value); });
+        reduced->solve(separators);
+    }
+    MPI_Bcast(separators.data(), reducedSize, mpiTypeOf<floatingPointType>(), 0, comm);
+    return separators;
+}
+
+template <typename StorageT, typename AccumT>
+void DistributedLDLTSolver<StorageT, AccumT>::solve()
+{
+    if (!file->hasF())
+    {
+        throw runtime_error("The band file has no F section");
+    }
+    solve(file->F<floatingPointType>() + begin);
+}
+
+template <typename StorageT, typename AccumT>
+void DistributedLDLTSolver<StorageT, AccumT>::solve(const floatingPointType *localF)
+{
+    if (interior == nullptr)
+    {
+        throw logic_error("factorize() must run before solve()");
+    }
+
+    const double start = MPI_Wtime();
+    const int interiorRows = interiorEnd - begin;
+    const int columns = leftColumns + rightColumns;
+
+    // y = A_Ir^-1 F_Ir and its contribution F_S - C^T y to the interface right-hand side.
+    solution.assign(localF, localF + (end - begin));
+    interior->solve(solution.data());
+
+    const int slots = 2 * m;
+    const int firstSlot = m - leftColumns;
+    vector<sum> product = couplingTransposeTimes(solution.data());
+    vector<sum> rhs(slots, sum(0));
+    for (int c = 0; c < columns; ++c)
+    {
+        rhs[firstSlot + c] = -product[c];
+    }
+    for (int t = 0; t < rightColumns; ++t)
+    {
+        rhs[m + t] += sum(localF[interiorRows + t]);
+    }
+
+    vector<floatingPointType> separators = solveReduced(rhs);
+
+    // x_Ir = y - Y_r x_S; the separator rows of this rank are x_S itself.
+    const int firstSeparator = (rank - 1) * m + firstSlot;
+    #pragma omp parallel for num_threads(numThreads) schedule(static)
+    for (int u = 0; u < interiorRows; ++u)
+    {
+        sum value = sum(solution[u]);
+        for (int c = 0; c < columns; ++c)
+        {
+            value -= sum(spikes[size_t(c) * interiorRows + u]) * sum(separators[firstSeparator + c]);
+        }
+        solution[u] = floatingPointType(value);
+    }
+    for (int t = 0; t < rightColumns; ++t)
+    {
+        solution[interiorRows + t] = separators[rank * m + t];
+    }
+
+    timings.solveSeconds = slowestRank(MPI_Wtime() - start);
+}
+
+template <typename StorageT, typename AccumT>
+void DistributedLDLTSolver<StorageT, AccumT>::writeSolution(const string &filePath, SolutionFormat format) const
+{
+    const MPI_Datatype type = mpiTypeOf<floatingPointType>();
+    if (rank != 0)
+    {
+        for (size_t sent = 0; sent < solution.size(); sent += SOLUTION_CHUNK)
+        {
+            int count = int(min(solution.size() - sent, size_t(SOLUTION_CHUNK)));
+            MPI_Send(solution.data() + sent, count, type, 0, 0, comm);
+        }
+        return;
+    }
+
+    // Rank 0 writes its own rows, then the rows of every other rank in order.
+    unique_ptr<TextRowWriter> text;
+    unique_ptr<VectorFileWriter<floatingPointType>> binary;
+    if (format == SolutionFormat::Text)
+    {
+        text = make_unique<TextRowWriter>(filePath, precisionDigits<floatingPointType>);
+    }
+    else
+    {
+        binary = make_unique<VectorFileWriter<floatingPointType>>(filePath, size_t(n));
+    }
+
+    auto append = [&](const floatingPointType *values, size_t count)
+    {
+        if (text != nullptr)
+        {
+            for (size_t i = 0; i < count; ++i)
+            {
+                text->writeValue(values[i]);
+            }
+        }
+        else
+        {
+            binary->append(values, count);
+        }
+    };
+
+    append(solution.data(), solution.size());
+    vector<floatingPointType> chunk(SOLUTION_CHUNK);
+    for (int r = 1; r < ranks; ++r)
+    {
+        size_t rows = size_t(blockBegin(r + 1) - blockBegin(r));
+        for (size_t received = 0; received < rows; received += SOLUTION_CHUNK)
+        {
+            int count = int(min(rows - received, size_t(SOLUTION_CHUNK)));
+            MPI_Recv(chunk.data(), count, type, r, 0, comm, MPI_STATUS_IGNORE);
+            append(chunk.data(), size_t(count));
+        }
+    }
+
+    if (text != nullptr)
+    {
+        text->close();
+    }
+    else
+    {
+        binary->close();
+    }
+}
+
+template class DistributedLDLTSolver<float, float>;
+template class DistributedLDLTSolver<double, double>;
+template class DistributedLDLTSolver<float, double>;
+
+#endif // LDLT_USE_MPI
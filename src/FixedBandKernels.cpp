@@ -0,0 +1,323 @@
+/**
+ * @file FixedBandKernels.cpp
+ * @brief Implementation of the kernels specialized for m = 1, 2, 3, 4 and 8.
+ */
+#include "FixedBandKernels.hpp"
+
+namespace
+{
+    /// Scales one entry by 1 / D(i) when the diagonal step is fused into the sweep.
+    template <typename T>
+    inline T scaled(T value, const T *inverseD, int i)
+    {
+        return inverseD != nullptr ? T(value * inverseD[i]) : value;
+    }
+
+    /// Row j of the factorization with bounds, for the leading rows j < M.
+    template <int M, typename T, typename Acc>
+    void factorLeadingRow(BandMatrix<T> &AL, T *D, int j)
+    {
+        T *rj = AL[j] + M - j;
+        for (int i = 0; i < j; ++i)
+        {
+            const T *ri = AL[i] + M - i;
+            Acc sumL = 0;
+            for (int k = 0; k < i; ++k)
+            {
+                sumL += Acc(rj[k]) * ri[k] * D[k];
+            }
+            rj[i] = T((rj[i] - sumL) / D[i]);
+        }
+
+        Acc sumD = 0;
+        for (int k = 0; k < j; ++k)
+        {
+            sumD += Acc(rj[k]) * rj[k] * D[k];
+        }
+        D[j] = T(D[j] - sumD);
+    }
+
+    template <int M, typename T, typename Acc>
+    void factorFixed(BandMatrix<T> &AL, T *D, int firstRow, PivotMonitor *pivots)
+    {
+        const int n = AL.rows();
+        int j = firstRow;
+        for (; j < min(M, n); ++j)
+        {
+            factorLeadingRow<M, T, Acc>(AL, D, j);
+            if (pivots != nullptr && pivots->observe(j, D[j]))
+            {
+                return;
+            }
+        }
+        if (j >= n)
+        {
+            return;
+        }
+
+        if constexpr (M == 1)
+        {
+            // Thomas: l(j) = a(j) / d(j - 1), d(j) = a(j, j) - l(j)^2 * d(j - 1).
+            T dPrevious = D[j - 1];
+            for (; j < n; ++j)
+            {
+                T l = T((AL[j][0] - Acc(0)) / dPrevious);
+                AL[j][0] = l;
+                dPrevious = T(D[j] - Acc(l) * l * dPrevious);
+                D[j] = dPrevious;
+                if (pivots != nullptr && pivots->observe(j, dPrevious))
+                {
+                    return;
+                }
+            }
+        }
+        else
+        {
+            // window[q] and dWindow[q] hold row j - M + q of L and D.
+            T window[M][M];
+            T dWindow[M];
+            for (int q = 0; q < M; ++q)
+            {
+                copy(AL[j - M + q], AL[j - M + q] + M, window[q]);
+                dWindow[q] = D[j - M + q];
+            }
+
+            for (; j < n; ++j)
+            {
+                T *rj = AL[j];
+                T l[M];
+#pragma GCC unroll 8
+                for (int p = 0; p < M; ++p)
+                {
+                    // L(j, i) with i = j - M + p; L(i, k) for k = j - M + r is window[p][M - p + r].
+                    Acc sumL = 0;
+#pragma GCC unroll 8
+                    for (int r = 0; r < p; ++r)
+                    {
+                        sumL += Acc(l[r]) * window[p][M - p + r] * dWindow[r];
+                    }
+                    l[p] = T((rj[p] - sumL) / dWindow[p]);
+                }
+
+                Acc sumD = 0;
+#pragma GCC unroll 8
+                for (int r = 0; r < M; ++r)
+                {
+                    sumD += Acc(l[r]) * l[r] * dWindow[r];
+                }
+                T dj = T(D[j] - sumD);
+
+#pragma GCC unroll 8
+                for (int q = 0; q + 1 < M; ++q)
+                {
+#pragma GCC unroll 8
+                    for (int p = 0; p < M; ++p)
+                    {
+                        window[q][p] = window[q + 1][p];
+                    }
+                    dWindow[q] = dWindow[q + 1];
+                }
+#pragma GCC unroll 8
+                for (int p = 0; p < M; ++p)
+                {
+                    window[M - 1][p] = l[p];
+                    rj[p] = l[p];
+                }
+                dWindow[M - 1] = dj;
+                D[j] = dj;
+                if (pivots != nullptr && pivots->observe(j, dj))
+                {
+                    return;
+                }
+            }
+        }
+    }
+
+    template <int M, typename T, typename Acc>
+    void forwardFixed(const BandMatrix<T> &L, T *x)
+    {
+        const int n = L.rows();
+        int i = 0;
+        for (; i < min(M, n); ++i)
+        {
+            const T *row = L[i] + M - i;
+            Acc sumF = 0;
+            for (int j = 0; j < i; ++j)
+            {
+                sumF += Acc(row[j]) * x[j];
+            }
+            x[i] = T(x[i] - sumF);
+        }
+        if (i >= n)
+        {
+            return;
+        }
+
+        if constexpr (M == 1)
+        {
+            T previous = x[i - 1];
+            for (; i < n; ++i)
+            {
+                previous = T(x[i] - (Acc(0) + Acc(L[i][0]) * previous));
+                x[i] = previous;
+            }
+        }
+        else
+        {
+            // window[p] holds x(i - M + p).
+            T window[M];
+            copy(x + i - M, x + i, window);
+            for (; i < n; ++i)
+            {
+                const T *row = L[i];
+                Acc sumF = 0;
+#pragma GCC unroll 8
+                for (int p = 0; p < M; ++p)
+                {
+                    sumF += Acc(row[p]) * window[p];
+                }
+                T xi = T(x[i] - sumF);
+                x[i] = xi;
+#pragma GCC unroll 8
+                for (int p = 0; p + 1 < M; ++p)
+                {
+                    window[p] = window[p + 1];
+                }
+                window[M - 1] = xi;
+            }
+        }
+    }
+
+    /**
+     * Row-oriented backward sweep as in bandDiagonalBackwardSubstitution(): once x(j)
+     * is final, row j of L is subtracted from the partial sums of entries [j - M, j),
+     * which are the only ones still open and live in registers.
+     */
+    template <int M, typename T, typename Acc>
+    void backwardFixed(const BandMatrix<T> &L, const T *inverseD, T *x)
+    {
+        const int n = L.rows();
+
+        // partial[p] holds the open sum of entry j + 1 - M + p, for the row j about to run.
+        Acc partial[M];
+        int j = n - 1;
+        if (n > M)
+        {
+            for (int p = 1; p < M + 1; ++p)
+            {
+                partial[p - 1] = Acc(scaled(x[n - 1 - M + p], inverseD, n - 1 - M + p));
+            }
+
+            if constexpr (M == 1)
+            {
+                // Thomas: x(j - 1) = d(j - 1)^-1 y(j - 1) - l(j) * x(j).
+                Acc open = partial[0];
+                for (; j >= M; --j)
+                {
+                    T xj = T(open);
+                    x[j] = xj;
+                    open = Acc(scaled(x[j - 1], inverseD, j - 1)) + -Acc(xj) * L[j][0];
+                }
+                partial[0] = open;
+            }
+            else
+            {
+                for (; j >= M; --j)
+                {
+                    T xj = T(partial[M - 1]);
+                    x[j] = xj;
+#pragma GCC unroll 8
+                    for (int p = M - 1; p > 0; --p)
+                    {
+                        partial[p] = partial[p - 1];
+                    }
+                    partial[0] = Acc(scaled(x[j - M], inverseD, j - M));
+
+                    const T *row = L[j];
+                    Acc alpha = -Acc(xj);
+#pragma GCC unroll 8
+                    for (int p = 0; p < M; ++p)
+                    {
+                        partial[p] += alpha * row[p];
+                    }
+                }
+            }
+        }
+        else
+        {
+            for (int p = 0; p < n; ++p)
+            {
+                partial[p] = Acc(scaled(x[p], inverseD, p));
+            }
+        }
+
+        // Leading rows: partial[p] now holds entry p for p <= j.
+        for (; j >= 0; --j)
+        {
+            T xj = T(partial[j]);
+            x[j] = xj;
+            const T *row = L[j] + M - j;
+            Acc alpha = -Acc(xj);
+            for (int p = 0; p < j; ++p)
+            {
+                partial[p] += alpha * row[p];
+            }
+        }
+    }
+
+    /// Calls f with the bandwidth as std::integral_constant.
+    template <typename Function>
+    void dispatchBandwidth(int m, Function &&f)
+    {
+        switch (m)
+        {
+        case 1:
+            f(integral_constant<int, 1>());
+            break;
+        case 2:
+            f(integral_constant<int, 2>());
+            break;
+        case 3:
+            f(integral_constant<int, 3>());
+            break;
+        case 4:
+            f(integral_constant<int, 4>());
+            break;
+        case 8:
+            f(integral_constant<int, 8>());
+            break;
+        default:
+            throw invalid_argument("No fixed-bandwidth kernel for m = " + to_string(m));
+        }
+    }
+}
+
+template <typename T, typename Acc>
+void fixedBandFactorization(BandMatrix<T> &AL, T *D, int firstRow, PivotMonitor *pivots)
+{
+    dispatchBandwidth(AL.bandwidth(), [&](auto bandwidth)
+                      { factorFixed<decltype(bandwidth)::value, T, Acc>(AL, D, firstRow, pivots); });
+}
+
+template <typename T, typename Acc>
+void fixedBandForwardSubstitution(const BandMatrix<T> &L, T *x)
+{
+    dispatchBandwidth(L.bandwidth(), [&](auto bandwidth)
+                      { forwardFixed<decltype(bandwidth)::value, T, Acc>(L, x); });
+}
+
+template <typename T, typename Acc>
+void fixedBandBackwardSubstitution(const BandMatrix<T> &L, const T *inverseD, T *x)
+{
+    dispatchBandwidth(L.bandwidth(), [&](auto bandwidth)
+                      { backwardFixed<decltype(bandwidth)::value, T, Acc>(L, inverseD, x); });
+}
+
+#define INSTANTIATE_FIXED_BAND_KERNELS(T, Acc)                                               \
+    template void fixedBandFactorization<T, Acc>(BandMatrix<T> &, T *, int, PivotMonitor *); \
+    template void fixedBandForwardSubstitution<T, Acc>(const BandMatrix<T> &, T *);          \
+    template void fixedBandBackwardSubstitution<T, Acc>(const BandMatrix<T> &, const T *, T *);
+
+INSTANTIATE_FIXED_BAND_KERNELS(float, float)
+INSTANTIATE_FIXED_BAND_KERNELS(double, double)
+INSTANTIATE_FIXED_BAND_KERNELS(float, double)
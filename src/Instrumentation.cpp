@@ -0,0 +1,115 @@
+/**
+ * @file Instrumentation.cpp
+ * @brief Implementation of the process-wide phase table.
+ */
+#include "Instrumentation.hpp"
+
+#ifdef LDLT_USE_ITT
+#include <ittnotify.h>
+#endif
+
+namespace
+{
+    mutex tableMutex;
+    vector<PhaseRecord> table;
+
+#ifdef LDLT_USE_ITT
+    __itt_domain *ittDomain()
+    {
+        static __itt_domain *domain = __itt_domain_create("ldlt");
+        return domain;
+    }
+#endif
+}
+
+atomic<Instrumentation::PhaseHook> Instrumentation::beginHook{nullptr};
+atomic<Instrumentation::PhaseHook> Instrumentation::endHook{nullptr};
+
+void Instrumentation::record(const char *name, double seconds, double flops, double bytes)
+{
+    lock_guard<mutex> lock(tableMutex);
+    auto it = find_if(table.begin(), table.end(), [&](const PhaseRecord &phase)
+                      { return phase.name == name; });
+    if (it == table.end())
+    {
+        table.push_back(PhaseRecord{name});
+        it = table.end() - 1;
+    }
+    ++it->calls;
+    it->seconds += seconds;
+    it->flops += flops;
+    it->bytes += bytes;
+}
+
+vector<PhaseRecord> Instrumentation::phases()
+{
+    lock_guard<mutex> lock(tableMutex);
+    return table;
+}
+
+void Instrumentation::reset()
+{
+    lock_guard<mutex> lock(tableMutex);
+    table.clear();
+}
+
+void Instrumentation::writeJson(ostream &out)
+{
+    vector<PhaseRecord> snapshot = phases();
+    ios::fmtflags flags = out.flags();
+    streamsize precision = out.precision();
+    out << defaultfloat << setprecision(9);
+
+    out << "{\"instrumented\": " << (enabled() ? "true" : "false") << ", \"phases\": [";
+    for (size_t p = 0; p < snapshot.size(); ++p)
+    {
+        const PhaseRecord &phase = snapshot[p];
+        double gflops = phase.seconds > 0 ? phase.flops / phase.seconds * 1e-9 : 0.0;
+        double gbps = phase.seconds > 0 ? phase.bytes / phase.seconds * 1e-9 : 0.0;
+        out << (p == 0 ? "" : ", ") << "{\"name\": \"" << phase.name << "\", \"calls\": " << phase.calls
+            << ", \"seconds\": " << phase.seconds << ", \"flops\": " << phase.flops << ", \"bytes\": " << phase.bytes
+            << ", \"gflops\": " << gflops << ", \"gbps\": " << gbps << '}';
+    }
+    out << "]}\n";
+    out.flags(flags);
+    out.precision(precision);
+}
+
+void Instrumentation::setPhaseHooks(PhaseHook begin, PhaseHook end)
+{
+    beginHook = begin;
+    endHook = end;
+}
+
+double Instrumentation::fileBytes(const string &filePath)
+{
+    error_code error;
+    uintmax_t size = filesystem::file_size(filePath, error);
+    return error ? 0.0 : double(size);
+}
+
+ScopedPhase::ScopedPhase(const char *phaseName, double phaseFlops, double phaseBytes)
+    : name(phaseName), flops(phaseFlops), bytes(phaseBytes)
+{
+    if (Instrumentation::PhaseHook hook = Instrumentation::beginHook.load(memory_order_relaxed))
+    {
+        hook(name);
+    }
+#ifdef LDLT_USE_ITT
+    __itt_task_begin(ittDomain(), __itt_null, __itt_null, __itt_string_handle_create(name));
+#endif
+    start = chrono::steady_clock::now();
+}
+
+ScopedPhase::~ScopedPhase()
+{
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+#ifdef LDLT_USE_ITT
+    __itt_task_end(ittDomain());
+#endif
+    if (Instrumentation::PhaseHook hook = Instrumentation::endHook.load(memory_order_relaxed))
+    {
+        hook(name);
+    }
+    Instrumentation::record(name, seconds, flops, bytes);
+}
@@ -0,0 +1,117 @@
+/**
+ * @file LDLTFactorization.cpp
+ * @brief Implementation of the immutable LDLT factor object.
+ */
+#include "LDLTFactorization.hpp"
+
+template <typename StorageT, typename AccumT>
+LDLTFactorization<StorageT, AccumT>::LDLTFactorization(BandMatrix<floatingPointType> &&L, vector<floatingPointType> &&D)
+    : factorL(std::move(L)), factorD(std::move(D)), originalKept(false)
+{
+    invertDiagonal();
+}
+
+template <typename StorageT, typename AccumT>
+LDLTFactorization<StorageT, AccumT>::LDLTFactorization(BandMatrix<floatingPointType> &&L, vector<floatingPointType> &&D,
+                                                       BandMatrix<floatingPointType> &&AL, vector<floatingPointType> &&AD)
+    : factorL(std::move(L)), factorD(std::move(D)),
+      originalAL(std::move(AL)), originalD(std::move(AD)), originalKept(true)
+{
+    invertDiagonal();
+}
+
+template <typename StorageT, typename AccumT>
+void LDLTFactorization<StorageT, AccumT>::invertDiagonal()
+{
+    inverseD.resize(factorD.size());
+    for (size_t i = 0; i < factorD.size(); ++i)
+    {
+        inverseD[i] = floatingPointType(1) / factorD[i];
+    }
+}
+
+template <typename StorageT, typename AccumT>
+bool LDLTFactorization<StorageT, AccumT>::matchesOriginal(const BandMatrix<floatingPointType> &AL,
+                                                          const vector<floatingPointType> &AD) const
+{
+    if (!originalKept)
+    {
+        throw logic_error("The factorization was created without the original matrix");
+    }
+    if (AL.rows() != originalAL.rows() || AL.bandwidth() != originalAL.bandwidth() || AD != originalD)
+    {
+        return false;
+    }
+    const int m = AL.bandwidth();
+    for (int i = 0; i < AL.rows(); ++i)
+    {
+        if (!equal(AL[i], AL[i] + m, originalAL[i]))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+template <typename StorageT, typename AccumT>
+void LDLTFactorization<StorageT, AccumT>::solve(floatingPointType *x) const
+{
+    bandForwardSubstitution<floatingPointType, sum>(factorL, x);
+    bandDiagonalBackwardSubstitution<floatingPointType, sum>(factorL, inverseD.data(), x);
+}
+
+template <typename StorageT, typename AccumT>
+void LDLTFactorization<StorageT, AccumT>::solve(floatingPointType *x, Workspace &workspace) const
+{
+    sum *work = is_same_v<sum, floatingPointType> ? nullptr : workspace.sumsFor(size());
+    bandForwardSubstitution<floatingPointType, sum>(factorL, x);
+    bandDiagonalBackwardSubstitution<floatingPointType, sum>(factorL, inverseD.data(), x, work);
+}
+
+template <typename StorageT, typename AccumT>
+void LDLTFactorization<StorageT, AccumT>::solve(vector<floatingPointType> &x) const
+{
+    if (x.size() != size_t(size()))
+    {
+        throw invalid_argument("Workspace size does not match the factorization");
+    }
+    solve(x.data());
+}
+
+template <typename StorageT, typename AccumT>
+void LDLTFactorization<StorageT, AccumT>::solve(floatingPointType *block, int k, int ld) const
+{
+    if (k < 0 || ld < size())
+    {
+        throw invalid_argument("Invalid right-hand side block shape");
+    }
+    bandForwardSubstitution<floatingPointType, sum>(factorL, block, k, ld);
+    bandDiagonalBackwardSubstitution<floatingPointType, sum>(factorL, inverseD.data(), block, k, ld);
+}
+
+template <typename StorageT, typename AccumT>
+void LDLTFactorization<StorageT, AccumT>::solve(floatingPointType *block, int k, int ld, Workspace &workspace) const
+{
+    if (k < 0 || ld < size())
+    {
+        throw invalid_argument("Invalid right-hand side block shape");
+    }
+    bandForwardSubstitution<floatingPointType, sum>(factorL, block, k, ld);
+    bandDiagonalBackwardSubstitution<floatingPointType, sum>(factorL, inverseD.data(), block, k, ld,
+                                                             workspace.columnFor(bandwidth()));
+}
+
+template <typename StorageT, typename AccumT>
+ResidualNorms LDLTFactorization<StorageT, AccumT>::residual(const floatingPointType *x, const floatingPointType *f, sum *r) const
+{
+    if (!originalKept)
+    {
+        throw logic_error("Residual requested but the original matrix was not kept");
+    }
+
+    return bandResidual(originalAL, originalD.data(), x, f, r);
+}
+
+template class LDLTFactorization<float, float>;
+template class LDLTFactorization<double, double>;
+template class LDLTFactorization<float, double>;
@@ -0,0 +1,114 @@
+/**
+ * @file NumericalHealth.cpp
+ * @brief Implementation of the pivot statistics and the 1-norm estimator.
+ */
+#include "NumericalHealth.hpp"
+
+namespace
+{
+    template <typename T>
+    double oneNorm(const vector<T> &x)
+    {
+        double norm = 0;
+        for (T value : x)
+        {
+            norm += fabs(double(value));
+        }
+        return norm;
+    }
+
+    template <typename T>
+    int largestEntry(const vector<T> &x)
+    {
+        int j = 0;
+        for (int i = 1; i < int(x.size()); ++i)
+        {
+            if (fabs(double(x[i])) > fabs(double(x[j])))
+            {
+                j = i;
+            }
+        }
+        return j;
+    }
+}
+
+void PivotMonitor::merge(const PivotMonitor &other)
+{
+    const PivotReport &theirs = other.stats;
+    stats.rowsChecked += theirs.rowsChecked;
+    stats.minAbsPivot = min(stats.minAbsPivot, theirs.minAbsPivot);
+    stats.maxAbsPivot = max(stats.maxAbsPivot, theirs.maxAbsPivot);
+    stats.badPivots += theirs.badPivots;
+    if (theirs.firstBadPivot >= 0 && (stats.firstBadPivot < 0 || theirs.firstBadPivot < stats.firstBadPivot))
+    {
+        stats.firstBadPivot = theirs.firstBadPivot;
+    }
+}
+
+template <typename T>
+double estimateSymmetricOneNorm(int n, const function<void(T *)> &apply)
+{
+    constexpr int MAX_STEPS = 5;
+    if (n <= 0)
+    {
+        return 0;
+    }
+
+    vector<T> x(n, T(1.0 / n));
+    apply(x.data());
+    double estimate = oneNorm(x);
+    if (n == 1)
+    {
+        return estimate;
+    }
+
+    // B is symmetric, so B^T * sign(B x) is one more product with B.
+    vector<T> sign(n), z(n);
+    auto signOf = [](T value) { return value >= T(0) ? T(1) : T(-1); };
+    transform(x.begin(), x.end(), sign.begin(), signOf);
+    z = sign;
+    apply(z.data());
+    int j = largestEntry(z);
+
+    for (int step = 1; step < MAX_STEPS; ++step)
+    {
+        fill(x.begin(), x.end(), T(0));
+        x[j] = T(1);
+        apply(x.data());
+        double next = oneNorm(x);
+
+        bool sameSigns = true;
+        for (int i = 0; i < n && sameSigns; ++i)
+        {
+            sameSigns = signOf(x[i]) == sign[i];
+        }
+        if (sameSigns || next <= estimate)
+        {
+            estimate = max(estimate, next);
+            break;
+        }
+        estimate = next;
+
+        transform(x.begin(), x.end(), sign.begin(), signOf);
+        z = sign;
+        apply(z.data());
+        int previous = j;
+        j = largestEntry(z);
+        if (fabs(double(z[j])) == fabs(double(z[previous])))
+        {
+            break;
+        }
+    }
+
+    // Alternating probe that catches the cases where the sign iteration stalls.
+    for (int i = 0; i < n; ++i)
+    {
+        double magnitude = 1.0 + double(i) / (n - 1);
+        x[i] = T(i % 2 == 0 ? magnitude : -magnitude);
+    }
+    apply(x.data());
+    return max(estimate, 2.0 * oneNorm(x) / (3.0 * n));
+}
+
+template double estimateSymmetricOneNorm<float>(int, const function<void(float *)> &);
+template double estimateSymmetricOneNorm<double>(int, const function<void(double *)> &);
@@ -19,7 +19,7 @@
  * 
  * Usage example:
  * @code
- * SLAUSolverLDLT solver("input.txt", "al.txt", "d.txt", "f.txt", "output.txt");
+ * SLAUSolverLDLT<double, double> solver("input.txt", "al.txt", "d.txt", "f.txt", "output.txt");
  * solver.performLDLtDecomposition();
  * solver.solveLinearSystem();
  * solver.writeVectorFToFile();
@@ -27,23 +27,60 @@
  */
 #include "SLAUSolverLDLT.hpp"
 
-void SLAUSolverLDLT::initialize(int a, int b)
+SolutionFormat parseSolutionFormat(const string &name)
 {
+    if (name == "text")
+    {
+        return SolutionFormat::Text;
+    }
+    if (name == "binary")
+    {
+        return SolutionFormat::Binary;
+    }
+    throw invalid_argument("Unknown solution format: " + name + " (expected text or binary)");
+}
+
+namespace
+{
+    /// Local stream for the print helpers, formatted with the precision of T.
+    template <typename T>
+    ostringstream diagnosticBuffer()
+    {
+        ostringstream text;
+        text << fixed << setprecision(precisionDigits<T>);
+        return text;
+    }
+
+    /// Analytic byte count of one pass over the band with the given number of extra vector streams.
+    template <typename T>
+    double sweepBytes(int n, int m, int vectors)
+    {
+        return double(n) * (BandMatrix<T>::paddedStride(m) + vectors) * sizeof(T);
+    }
+}
+
+template <typename StorageT, typename AccumT>
+void SLAUSolverLDLT<StorageT, AccumT>::initialize(int a, int b)
+{
+    matrixChanged();
     n = a;
     m = b;
-    matrixAL.resize(n, vector<floatingPointType>(m, 0.0));
-    diagD.resize(n, 0.0);
-    vectorF.resize(n, 0.0);
+    matrixAL.resize(n, m);
+    diagD.assign(n, 0.0);
+    vectorF.assign(n, 0.0);
+    handedOver = false;
 }
 
-SLAUSolverLDLT::SLAUSolverLDLT(const string &inputFilePath,
-                               const string &alFilePath,
-                               const string &dFilePath,
-                               const string &fFilePath,
-                               const string &solveFilePath)
+template <typename StorageT, typename AccumT>
+SLAUSolverLDLT<StorageT, AccumT>::SLAUSolverLDLT(const string &inputFilePath,
+                                                 const string &alFilePath,
+                                                 const string &dFilePath,
+                                                 const string &fFilePath,
+                                                 const string &solveFilePath)
     : solveFilePath(solveFilePath), AlFilePath(alFilePath), DFilePath(dFilePath)
 {
-    cout << fixed << setprecision(PRECISION_DIGITS);
+    LDLT_PHASE("load_text", 0, Instrumentation::fileBytes(inputFilePath) + Instrumentation::fileBytes(alFilePath) +
+                                   Instrumentation::fileBytes(dFilePath) + Instrumentation::fileBytes(fFilePath));
 
     int a = 0, b = 0;
     loadFromFile(inputFilePath, a, b);
@@ -54,246 +91,1120 @@ SLAUSolverLDLT::SLAUSolverLDLT(const string &inputFilePath,
     loadFromFile(fFilePath, vectorF);
 }
 
-void SLAUSolverLDLT::loadFromFile(const string &filePath, int &a, int &b)
+template <typename StorageT, typename AccumT>
+SLAUSolverLDLT<StorageT, AccumT>::SLAUSolverLDLT(int a, int b, const string &solveFilePath)
+    : solveFilePath(solveFilePath)
 {
-    ifstream file(filePath);
-    if (!file.is_open())
+
+    if (a < 0 || b < 0)
     {
-        throw runtime_error("Could not open file: " + filePath);
+        throw invalid_argument("System size and bandwidth must be non-negative");
     }
-    file >> a >> b;
-    file.close();
+    initialize(a, b);
+}
+
+template <typename StorageT, typename AccumT>
+SLAUSolverLDLT<StorageT, AccumT>::SLAUSolverLDLT(const string &bandFile, const string &solveFilePath, bool verifyChecksum)
+    : solveFilePath(solveFilePath)
+{
+    LDLT_PHASE("load_band_file", 0, Instrumentation::fileBytes(bandFile));
+
+    loadFromBandFile(bandFile, true, verifyChecksum);
 }
 
-void SLAUSolverLDLT::loadFromFile(const string &filePath, vector<vector<floatingPointType>> &matrix)
+template <typename StorageT, typename AccumT>
+void SLAUSolverLDLT<StorageT, AccumT>::loadFromBandFile(const string &filePath, bool loadF, bool verifyChecksum)
 {
-    ifstream file(filePath);
-    if (!file.is_open())
+    auto file = make_shared<MappedBandFile>(filePath, verifyChecksum);
+    matrixChanged();
+
+    n = file->size();
+    m = file->bandwidth();
+    matrixAL = mapBandMatrix<floatingPointType>(file);
+
+    const floatingPointType *d = file->D<floatingPointType>();
+    diagD.assign(d, d + n);
+    handedOver = false;
+
+    if (loadF)
     {
-        throw runtime_error("Could not open file: " + filePath);
+        const floatingPointType *f = file->F<floatingPointType>();
+        if (f != nullptr)
+        {
+            vectorF.assign(f, f + n);
+        }
+        else
+        {
+            vectorF.assign(n, 0.0);
+        }
     }
-    for (int i = 0; i < n; ++i)
+
+    bandFilePath = filePath;
+}
+
+template <typename StorageT, typename AccumT>
+void SLAUSolverLDLT<StorageT, AccumT>::saveToBandFile(const string &filePath) const
+{
+    requireOwnStorage();
+    writeBandFile(filePath, matrixAL, diagD, &vectorF);
+}
+
+template <typename StorageT, typename AccumT>
+void SLAUSolverLDLT<StorageT, AccumT>::loadFromFile(const string &filePath, int &a, int &b)
+{
+    parseSizeText(filePath, a, b);
+}
+
+template <typename StorageT, typename AccumT>
+void SLAUSolverLDLT<StorageT, AccumT>::loadFromFile(const string &filePath, BandMatrix<floatingPointType> &matrix)
+{
+    parseBandText(filePath, matrix);
+}
+
+template <typename StorageT, typename AccumT>
+void SLAUSolverLDLT<StorageT, AccumT>::loadFromFile(const string &filePath, vector<floatingPointType> &vector)
+{
+    parseVectorText(filePath, vector.data(), n);
+}
+
+template <typename StorageT, typename AccumT>
+auto SLAUSolverLDLT<StorageT, AccumT>::factorize(bool keepOriginal) -> shared_ptr<const Factorization>
+{
+    if (!keepOriginal)
     {
-        for (int j = 0; j < m; ++j)
+        performLDLtDecomposition();
+        handedOver = true;
+        return make_shared<const Factorization>(std::move(matrixAL), std::move(diagD));
+    }
+
+    requireOwnStorage();
+    BandMatrix<floatingPointType> keptAL = matrixAL;
+    vector<floatingPointType> keptD = diagD;
+    performLDLtDecomposition();
+    handedOver = true;
+    return make_shared<const Factorization>(std::move(matrixAL), std::move(diagD),
+                                            std::move(keptAL), std::move(keptD));
+}
+
+template <typename StorageT, typename AccumT>
+void SLAUSolverLDLT<StorageT, AccumT>::setNumThreads(int threads)
+{
+    numThreads = threads > 0 ? threads : omp_get_max_threads();
+}
+
+template <typename StorageT, typename AccumT>
+void SLAUSolverLDLT<StorageT, AccumT>::setWorkspace(shared_ptr<Workspace> shared)
+{
+    if (shared == nullptr)
+    {
+        throw invalid_argument("Workspace must not be null");
+    }
+    workspace = std::move(shared);
+}
+
+template <typename StorageT, typename AccumT>
+void SLAUSolverLDLT<StorageT, AccumT>::setFactorizationKernel(FactorizationKernel selected, int panelWidth)
+{
+    if (panelWidth <= 0)
+    {
+        throw invalid_argument("Block size must be positive");
+    }
+    kernel = selected;
+    blockSize = panelWidth;
+}
+
+template <typename StorageT, typename AccumT>
+void SLAUSolverLDLT<StorageT, AccumT>::matrixChanged()
+{
+    factored = false;
+    factoredRows = 0;
+    snapshotValid = false;
+}
+
+template <typename StorageT, typename AccumT>
+void SLAUSolverLDLT<StorageT, AccumT>::requireOwnStorage() const
+{
+    if (handedOver)
+    {
+        throw logic_error("The factors were handed over by factorize(); call returnMatix() first");
+    }
+}
+
+template <typename StorageT, typename AccumT>
+const BandMatrix<StorageT> &SLAUSolverLDLT<StorageT, AccumT>::originalAL() const
+{
+    if (!factored)
+    {
+        return matrixAL;
+    }
+    if (!snapshotValid)
+    {
+        throw logic_error("A has been factored in place; enable setKeepSnapshot() or call returnMatix() first");
+    }
+    return snapshotAL;
+}
+
+template <typename StorageT, typename AccumT>
+const vector<StorageT> &SLAUSolverLDLT<StorageT, AccumT>::originalD() const
+{
+    originalAL();
+    return factored ? snapshotD : diagD;
+}
+
+template <typename StorageT, typename AccumT>
+void SLAUSolverLDLT<StorageT, AccumT>::setKeepSnapshot(bool enabled)
+{
+    keepSnapshot = enabled;
+    if (!enabled && !factored)
+    {
+        snapshotValid = false;
+        snapshotAL = BandMatrix<floatingPointType>();
+        snapshotD = vector<floatingPointType>();
+    }
+}
+
+template <typename StorageT, typename AccumT>
+void SLAUSolverLDLT<StorageT, AccumT>::performLDLtDecomposition()
+{
+    requireOwnStorage();
+    if (factored)
+    {
+        throw logic_error("The matrix is already factored; call returnMatix() before factoring again");
+    }
+    LDLT_PHASE("factorization", double(n) * (1.5 * m * m + 3.5 * m), 2 * sweepBytes<floatingPointType>(n, m, 1));
+    if (keepSnapshot && bandFilePath.empty() && !snapshotValid)
+    {
+        snapshotAL = matrixAL;
+        snapshotD = diagD;
+        snapshotValid = true;
+    }
+
+    pivots.reset();
+    FactorizationKernel selected = kernel;
+    if (selected == FactorizationKernel::Auto)
+    {
+        if (hasFixedBandKernel(m))
+        {
+            selected = FactorizationKernel::Fixed;
+        }
+        else if (m >= BLOCKED_MIN_BANDWIDTH)
+        {
+            selected = FactorizationKernel::Blocked;
+        }
+        else if (numThreads > 1 && m > 0)
+        {
+            selected = FactorizationKernel::Wavefront;
+        }
+        else
         {
-            file >> matrix[i][j];
+            selected = FactorizationKernel::Serial;
         }
     }
-    file.close();
+
+    switch (selected)
+    {
+    case FactorizationKernel::Wavefront:
+        performLDLtDecompositionWavefront();
+        break;
+    case FactorizationKernel::Blocked:
+        performLDLtDecompositionBlocked();
+        break;
+    case FactorizationKernel::Fixed:
+        fixedBandFactorization<floatingPointType, sum>(matrixAL, diagD.data(), 0, &pivots);
+        break;
+    default:
+        performLDLtDecompositionSerial();
+        break;
+    }
+    factored = true;
+    factoredRows = n;
+    checkPivotAbort(0);
+    invertDiagonal(0, n);
 }
 
-void SLAUSolverLDLT::loadFromFile(const string &filePath, vector<floatingPointType> &vector)
+template <typename StorageT, typename AccumT>
+void SLAUSolverLDLT<StorageT, AccumT>::setRow(int i, const floatingPointType *band, floatingPointType diagonal)
 {
-    ifstream file(filePath);
-    if (!file.is_open())
+    requireOwnStorage();
+    if (i < 0 || i >= n)
     {
-        throw runtime_error("Could not open file: " + filePath);
+        throw invalid_argument("Row index is outside the system");
     }
-    for (int i = 0; i < n; ++i)
+    if (factored && !snapshotValid)
+    {
+        throw logic_error("A has been factored in place; enable setKeepSnapshot() to change rows of a factored system");
+    }
+
+    if (snapshotValid)
     {
-        file >> vector[i];
+        copy(band, band + m, snapshotAL[i]);
+        snapshotD[i] = diagonal;
+    }
+    if (factored)
+    {
+        factoredRows = min(factoredRows, i);
+    }
+    else
+    {
+        copy(band, band + m, matrixAL[i]);
+        diagD[i] = diagonal;
     }
-    file.close();
 }
 
-void SLAUSolverLDLT::performLDLtDecomposition()
+template <typename StorageT, typename AccumT>
+void SLAUSolverLDLT<StorageT, AccumT>::refactorFrom(int k)
 {
-    for (int i = 0; i < n; ++i)
+    requireOwnStorage();
+    if (k < 0 || k > n)
     {
-        floatingPointType sumD = 0;
-        int baseIndexI = m - i;
+        throw invalid_argument("First row to refactor is outside the system");
+    }
+    if (!factored)
+    {
+        performLDLtDecomposition();
+        return;
+    }
+    if (!snapshotValid)
+    {
+        throw logic_error("A has been factored in place; enable setKeepSnapshot() before refactoring");
+    }
+    if (matrixAL.rows() != n)
+    {
+        throw logic_error("The factors were handed over by factorize(); call returnMatix() first");
+    }
 
-        for (int j = max(0, i - m); j <= i + m && j < n; ++j)
-        {
-            int baseIndexJ = m - j;
+    k = min(k, factoredRows);
+    LDLT_PHASE("refactorization", double(n - k) * (1.5 * m * m + 3.5 * m), 2 * sweepBytes<floatingPointType>(n - k, m, 1));
+    for (int i = k; i < n; ++i)
+    {
+        copy(snapshotAL[i], snapshotAL[i] + m, matrixAL[i]);
+        diagD[i] = snapshotD[i];
+    }
 
-            if (j < i)
+    restartPivotReport(k);
+    if (hasFixedBandKernel(m))
+    {
+        fixedBandFactorization<floatingPointType, sum>(matrixAL, diagD.data(), k, &pivots);
+    }
+    else if (numThreads > 1)
+    {
+        performLDLtDecompositionWavefront(k);
+    }
+    else
+    {
+        for (int j = k; j < n; ++j)
+        {
+            factorRow(j);
+            if (pivots.observe(j, diagD[j]))
             {
-                int indexIJ = baseIndexI + j;
-                sumD += matrixAL[i][indexIJ] * matrixAL[i][indexIJ] * diagD[j];
+                break;
             }
-            else if (j == i)
+        }
+    }
+    factoredRows = n;
+    checkPivotAbort(k);
+    invertDiagonal(k, n);
+}
+
+template <typename StorageT, typename AccumT>
+void SLAUSolverLDLT<StorageT, AccumT>::invertDiagonal(int first, int last)
+{
+    inverseD.resize(n);
+    for (int i = first; i < last; ++i)
+    {
+        inverseD[i] = floatingPointType(1) / diagD[i];
+    }
+}
+
+template <typename StorageT, typename AccumT>
+void SLAUSolverLDLT<StorageT, AccumT>::restartPivotReport(int rows)
+{
+    pivots.reset();
+    for (int i = 0; i < rows; ++i)
+    {
+        pivots.observe(i, diagD[i]);
+    }
+}
+
+template <typename StorageT, typename AccumT>
+void SLAUSolverLDLT<StorageT, AccumT>::checkPivotAbort(int firstRow)
+{
+    if (!pivots.stopped())
+    {
+        return;
+    }
+    int row = pivots.report().firstBadPivot;
+    factoredRows = row;
+    invertDiagonal(firstRow, row);
+
+    ostringstream message;
+    message << scientific << setprecision(3) << "Pivot D(" << row << ") = " << diagD[row]
+            << " is not above " << pivots.minimumPivot() << "; the factorization stopped at row " << row;
+    throw runtime_error(message.str());
+}
+
+template <typename StorageT, typename AccumT>
+void SLAUSolverLDLT<StorageT, AccumT>::setPivotCheck(double minimumPivot, bool abort)
+{
+    pivots = PivotMonitor(minimumPivot, abort);
+}
+
+template <typename StorageT, typename AccumT>
+ConditionEstimate SLAUSolverLDLT<StorageT, AccumT>::estimateCondition() const
+{
+    requireOwnStorage();
+    if (!factored || factoredRows < n || matrixAL.rows() != n)
+    {
+        throw logic_error("The condition estimate needs the complete factors; factor the system first");
+    }
+    LDLT_PHASE("condition_estimate", 11 * (4.0 * n * m + n), 11 * sweepBytes<floatingPointType>(n, m, 3));
+
+    ConditionEstimate estimate;
+    estimate.normInverse = estimateSymmetricOneNorm<floatingPointType>(n, [&](floatingPointType *x)
+    {
+        bandForwardSubstitution<floatingPointType, sum>(matrixAL, x, numThreads);
+        bandDiagonalBackwardSubstitution<floatingPointType, sum>(matrixAL, inverseD.data(), x, nullptr, numThreads);
+    });
+
+    if (snapshotValid)
+    {
+        // ||A||_1 is the largest row sum of |A|, the upper band counted through the lower one.
+        vector<double> rowSum(n);
+        for (int i = 0; i < n; ++i)
+        {
+            rowSum[i] += fabs(double(snapshotD[i]));
+            for (int j = max(0, i - m); j < i; ++j)
             {
-                diagD[i] -= sumD;
+                double a = fabs(double(snapshotAL[i][m - i + j]));
+                rowSum[i] += a;
+                rowSum[j] += a;
             }
-            else if (j > i)
+        }
+        estimate.normA = n > 0 ? *max_element(rowSum.begin(), rowSum.end()) : 0.0;
+        estimate.exactNormA = true;
+    }
+    else
+    {
+        // x <- L * D * L^T * x, in place: L^T by ascending rows, L by descending rows.
+        estimate.normA = estimateSymmetricOneNorm<floatingPointType>(n, [&](floatingPointType *x)
+        {
+            for (int i = 0; i < n; ++i)
             {
-                floatingPointType sumL = 0;
-
-                int indexIK = baseIndexI;
-                int indexJK = baseIndexJ;
-                for (int k = max(0, i - m); k < i; ++k)
+                sum t = x[i];
+                for (int j = i + 1; j <= min(n - 1, i + m); ++j)
                 {
-                    indexIK += k;
-                    indexJK += k;
-                    sumL += matrixAL[j][indexJK] * matrixAL[i][indexIK] * diagD[k];
+                    t += sum(matrixAL[j][m - j + i]) * x[j];
                 }
-
-                int indexJI = baseIndexJ + i;
-                matrixAL[j][indexJI] = (matrixAL[j][indexJI] - sumL) / diagD[i];
+                x[i] = floatingPointType(t * diagD[i]);
             }
-        }
+            for (int i = n - 1; i >= 0; --i)
+            {
+                int jBegin = max(0, i - m);
+                sum t = bandDot<floatingPointType, sum>(matrixAL[i] + (m - i) + jBegin, x + jBegin, i - jBegin);
+                x[i] = floatingPointType(x[i] + t);
+            }
+        });
     }
+    estimate.condition = estimate.normA * estimate.normInverse;
+    return estimate;
+}
+
+template <typename StorageT, typename AccumT>
+void SLAUSolverLDLT<StorageT, AccumT>::refactor()
+{
+    refactorFrom(factoredRows);
 }
 
-void SLAUSolverLDLT::solveForwardSubstitution()
+template <typename StorageT, typename AccumT>
+void SLAUSolverLDLT<StorageT, AccumT>::performLDLtDecompositionSerial()
 {
     for (int i = 0; i < n; ++i)
     {
-        floatingPointType sum = 0;
         int baseIndexI = m - i;
+        int kBeginI = max(0, i - m);
 
-        for (int j = max(0, i - m); j < i; ++j)
+        sum sumD = bandDotScaled<floatingPointType, sum>(matrixAL[i] + baseIndexI + kBeginI, matrixAL[i] + baseIndexI + kBeginI,
+                                                         diagD.data() + kBeginI, i - kBeginI);
+        diagD[i] = floatingPointType(diagD[i] - sumD);
+        if (pivots.observe(i, diagD[i]))
         {
-            int indexIJ = baseIndexI + j;
-            sum += matrixAL[i][indexIJ] * vectorF[j];
+            return;
+        }
+
+        for (int j = i + 1; j <= i + m && j < n; ++j)
+        {
+            int baseIndexJ = m - j;
+
+            // Only k >= j - m lies inside the band of row j.
+            int kBegin = max(0, j - m);
+            sum sumL = bandDotScaled<floatingPointType, sum>(matrixAL[j] + baseIndexJ + kBegin, matrixAL[i] + baseIndexI + kBegin,
+                                                             diagD.data() + kBegin, i - kBegin);
+
+            int indexJI = baseIndexJ + i;
+            matrixAL[j][indexJI] = floatingPointType((matrixAL[j][indexJI] - sumL) / diagD[i]);
         }
-        vectorF[i] -= sum;
     }
 }
 
-void SLAUSolverLDLT::solveDiagonalSubstitution()
+template <typename StorageT, typename AccumT>
+void SLAUSolverLDLT<StorageT, AccumT>::performLDLtDecompositionWavefront(int firstRow)
 {
-    for (int i = 0; i < n; ++i)
+    // Number of leading rows whose L and D entries are final. Rows finish in order
+    // because row j always depends on row j - 1 when m > 0.
+    atomic<int> rowsDone(firstRow);
+    // Set at a bad pivot when aborting; that row never completes, so the later rows stop waiting.
+    atomic<bool> stop(false);
+
+#pragma omp parallel num_threads(numThreads)
     {
-        vectorF[i] /= diagD[i];
+        PivotMonitor local(pivots.minimumPivot(), pivots.abortsOnBadPivot());
+
+#pragma omp for schedule(static, 1) nowait
+        for (int j = firstRow; j < n; ++j)
+        {
+            int baseIndexJ = m - j;
+            int seen = rowsDone.load(memory_order_acquire);
+            bool abandoned = false;
+
+            for (int i = max(0, j - m); i < j; ++i)
+            {
+                while (seen <= i && !abandoned)
+                {
+                    this_thread::yield();
+                    seen = rowsDone.load(memory_order_acquire);
+                    abandoned = stop.load(memory_order_relaxed);
+                }
+                if (abandoned)
+                {
+                    break;
+                }
+
+                int baseIndexI = m - i;
+                int kBegin = max(0, j - m);
+                sum sumL = bandDotScaled<floatingPointType, sum>(matrixAL[j] + baseIndexJ + kBegin, matrixAL[i] + baseIndexI + kBegin,
+                                                                 diagD.data() + kBegin, i - kBegin);
+
+                int indexJI = baseIndexJ + i;
+                matrixAL[j][indexJI] = floatingPointType((matrixAL[j][indexJI] - sumL) / diagD[i]);
+            }
+            if (abandoned)
+            {
+                continue;
+            }
+
+            int kBeginJ = max(0, j - m);
+            sum sumD = bandDotScaled<floatingPointType, sum>(matrixAL[j] + baseIndexJ + kBeginJ, matrixAL[j] + baseIndexJ + kBeginJ,
+                                                             diagD.data() + kBeginJ, j - kBeginJ);
+            diagD[j] = floatingPointType(diagD[j] - sumD);
+            if (local.observe(j, diagD[j]))
+            {
+                stop.store(true, memory_order_relaxed);
+                continue;
+            }
+
+            rowsDone.store(j + 1, memory_order_release);
+        }
+
+#pragma omp critical
+        pivots.merge(local);
     }
 }
 
-void SLAUSolverLDLT::solveBackwardSubstitution()
+template <typename StorageT, typename AccumT>
+void SLAUSolverLDLT<StorageT, AccumT>::rankUpdate(const floatingPointType *V, int k, int first, int length, int ld, sum alpha)
 {
-    for (int i = n - 1; i >= 0; --i)
+    requireOwnStorage();
+    if (k < 0 || length < 0 || ld < length || first < 0 || first + length > n)
     {
-        floatingPointType sum = 0.0;
-        int baseIndexI = m - i;
+        throw invalid_argument("Update vectors do not fit in the system");
+    }
+    if (length > m + 1)
+    {
+        throw invalid_argument("Update vectors span more than m + 1 rows and would widen the band");
+    }
+    if (factored && factoredRows < n)
+    {
+        throw logic_error("Rows changed by setRow() are not factored yet; call refactor() first");
+    }
+    if (matrixAL.rows() != n)
+    {
+        throw logic_error("The factors were handed over by factorize(); call returnMatix() first");
+    }
+    LDLT_PHASE("rank_update", 4.0 * k * (n - first) * m, k * (2 * sweepBytes<floatingPointType>(n - first, m, 1)));
 
-        for (int j = i + 1; j < n && j <= i + m; ++j)
+    // A(i, j) += alpha * v(i) * v(j) inside the support, on A itself or on its snapshot.
+    auto addOuterProduct = [&](BandMatrix<floatingPointType> &AL, vector<floatingPointType> &D, const floatingPointType *v)
+    {
+        for (int i = first; i < first + length; ++i)
         {
-            int baseIndexJ = m - j;
-            int indexJI = baseIndexJ + i;
-            sum += matrixAL[j][indexJI] * vectorF[j];
+            sum vi = alpha * v[i - first];
+            for (int j = first; j < i; ++j)
+            {
+                AL[i][m - i + j] = floatingPointType(AL[i][m - i + j] + vi * v[j - first]);
+            }
+            D[i] = floatingPointType(D[i] + vi * v[i - first]);
+        }
+    };
+
+    // The snapshot takes the whole update first, so it holds the new A even if a
+    // downdate below stops half way.
+    for (int c = 0; c < k; ++c)
+    {
+        if (snapshotValid)
+        {
+            addOuterProduct(snapshotAL, snapshotD, V + size_t(c) * ld);
         }
-        vectorF[i] -= sum;
+        if (!factored)
+        {
+            addOuterProduct(matrixAL, diagD, V + size_t(c) * ld);
+        }
+    }
+    if (!factored)
+    {
+        return;
     }
+
+    sum *w = workspace->sumsFor(n);
+    for (int c = 0; c < k; ++c)
+    {
+        const floatingPointType *v = V + size_t(c) * ld;
+
+        // w = L^-1 v is computed along the way. It fills in below the support at most
+        // m rows past the last pivot processed; rows after last have no fill yet.
+        copy(v, v + length, w + first);
+        int last = first + length - 1;
+        sum a = alpha;
+        for (int j = first; j <= last; ++j)
+        {
+            sum p = w[j];
+            if (p == sum(0))
+            {
+                continue;
+            }
+
+            sum dj = diagD[j];
+            sum dNew = dj + a * p * p;
+            if (!(dNew > sum(0)) && (dj > sum(0) || dNew == sum(0)))
+            {
+                // Rows [0, first) are untouched; the later ones mix old and new factors.
+                factoredRows = first;
+                ostringstream message;
+                message << scientific << setprecision(3) << "The downdate turns pivot D(" << j << ") = " << dj
+                        << " into " << dNew << ", so A is no longer positive definite; rows from " << first
+                        << " need refactor()";
+                throw runtime_error(message.str());
+            }
+            sum beta = p * a / dNew;
+            a = a * dj / dNew;
+            diagD[j] = floatingPointType(dNew);
+
+            int rEnd = min(n - 1, j + m);
+            for (int r = j + 1; r <= rEnd; ++r)
+            {
+                floatingPointType &l = matrixAL[r][m - r + j];
+                if (r > last)
+                {
+                    w[r] = 0;
+                }
+                w[r] -= p * l;
+                l = floatingPointType(l + beta * w[r]);
+            }
+            last = max(last, rEnd);
+        }
+    }
+    restartPivotReport(n);
+    invertDiagonal(first, n);
 }
 
-void SLAUSolverLDLT::solveLinearSystem()
+template <typename StorageT, typename AccumT>
+void SLAUSolverLDLT<StorageT, AccumT>::rankOneUpdate(const floatingPointType *v, int first, int length, sum alpha)
 {
-    solveForwardSubstitution();
-    solveDiagonalSubstitution();
-    solveBackwardSubstitution();
+    rankUpdate(v, 1, first, length, max(length, 0), alpha);
 }
 
-void SLAUSolverLDLT::writeVectorFToFile()
+template <typename StorageT, typename AccumT>
+void SLAUSolverLDLT<StorageT, AccumT>::factorRow(int j)
 {
-    ofstream outFile(solveFilePath);
-    if (!outFile.is_open())
+    int baseIndexJ = m - j;
+    int kBegin = max(0, j - m);
+
+    for (int i = kBegin; i < j; ++i)
     {
-        throw runtime_error("Could not open file: " + solveFilePath);
+        sum sumL = bandDotScaled<floatingPointType, sum>(matrixAL[j] + baseIndexJ + kBegin, matrixAL[i] + (m - i) + kBegin,
+                                                         diagD.data() + kBegin, i - kBegin);
+        int indexJI = baseIndexJ + i;
+        matrixAL[j][indexJI] = floatingPointType((matrixAL[j][indexJI] - sumL) / diagD[i]);
     }
 
-    outFile << fixed << setprecision(PRECISION_DIGITS);
-    for (const auto &value : vectorF)
+    sum sumD = bandDotScaled<floatingPointType, sum>(matrixAL[j] + baseIndexJ + kBegin, matrixAL[j] + baseIndexJ + kBegin,
+                                                     diagD.data() + kBegin, j - kBegin);
+    diagD[j] = floatingPointType(diagD[j] - sumD);
+}
+
+template <typename StorageT, typename AccumT>
+void SLAUSolverLDLT<StorageT, AccumT>::performLDLtDecompositionBlocked()
+{
+    const int b = min(blockSize, max(m, 1));
+    sum *panelW = workspace->panelFor(size_t(m) * b);
+
+    for (int k0 = 0; k0 < n; k0 += b)
     {
-        outFile << value << '\n';
+        const int k1 = min(k0 + b, n);
+
+        // Panel factorization: columns k0..k1-1 already carry the updates of
+        // earlier panels, so only the columns inside the panel are subtracted here.
+        for (int p = k0; p < k1; ++p)
+        {
+            int baseIndexP = m - p;
+
+            int qBeginP = max(k0, p - m);
+            sum sumD = bandDotScaled<floatingPointType, sum>(matrixAL[p] + baseIndexP + qBeginP, matrixAL[p] + baseIndexP + qBeginP,
+                                                             diagD.data() + qBeginP, p - qBeginP);
+            diagD[p] = floatingPointType(diagD[p] - sumD);
+            if (pivots.observe(p, diagD[p]))
+            {
+                return;
+            }
+
+            for (int r = p + 1; r < n && r <= p + m; ++r)
+            {
+                int baseIndexR = m - r;
+                int qBegin = max(k0, r - m);
+                sum sumL = bandDotScaled<floatingPointType, sum>(matrixAL[r] + baseIndexR + qBegin, matrixAL[p] + baseIndexP + qBegin,
+                                                                 diagD.data() + qBegin, p - qBegin);
+                int indexRP = baseIndexR + p;
+                matrixAL[r][indexRP] = floatingPointType((matrixAL[r][indexRP] - sumL) / diagD[p]);
+            }
+        }
+
+        // Rows k1..rowEnd-1 are the only ones the panel couples with.
+        const int rowEnd = min(n, k1 + m);
+        const int width = k1 - k0;
+
+        // W(c, q) = L(c, q) * D(q) in the accumulation type, stored densely with
+        // zeros outside the band.
+        for (int c = k1; c < rowEnd; ++c)
+        {
+            sum *w = panelW + size_t(c - k1) * b;
+            int baseIndexC = m - c;
+            for (int q = k0; q < k1; ++q)
+            {
+                w[q - k0] = q >= c - m ? sum(matrixAL[c][baseIndexC + q]) * diagD[q] : sum(0);
+            }
+        }
+
+        // Trailing update A(r, c) -= sum_q L(r, q) * W(c, q) for k1 <= c <= r.
+#pragma omp parallel for schedule(static) num_threads(numThreads) if (numThreads > 1)
+        for (int r = k1; r < rowEnd; ++r)
+        {
+            const int qBegin = max(k0, r - m) - k0;
+            const int len = width - qBegin;
+            const floatingPointType *lr = matrixAL[r] + (m - r) + k0 + qBegin;
+            floatingPointType *ar = matrixAL[r] + (m - r);
+
+            int c = max(k1, r - m);
+            for (; c + 3 < r; c += 4)
+            {
+                sum s[4];
+                bandDot4<floatingPointType, sum>(lr, panelW + size_t(c - k1) * b + qBegin, b, len, s);
+                ar[c] = floatingPointType(ar[c] - s[0]);
+                ar[c + 1] = floatingPointType(ar[c + 1] - s[1]);
+                ar[c + 2] = floatingPointType(ar[c + 2] - s[2]);
+                ar[c + 3] = floatingPointType(ar[c + 3] - s[3]);
+            }
+            for (; c <= r; ++c)
+            {
+                const sum *w0 = panelW + size_t(c - k1) * b + qBegin;
+                sum s0 = 0;
+                for (int q = 0; q < len; ++q)
+                {
+                    s0 += sum(lr[q]) * w0[q];
+                }
+                if (c == r)
+                {
+                    diagD[r] = floatingPointType(diagD[r] - s0);
+                }
+                else
+                {
+                    ar[c] = floatingPointType(ar[c] - s0);
+                }
+            }
+        }
     }
+}
 
-    outFile.close();
+template <typename StorageT, typename AccumT>
+void SLAUSolverLDLT<StorageT, AccumT>::solveForwardSubstitution()
+{
+    requireOwnStorage();
+    LDLT_PHASE("forward", 2.0 * n * m, sweepBytes<floatingPointType>(n, m, 2));
+    bandForwardSubstitution<floatingPointType, sum>(matrixAL, vectorF.data(), numThreads);
 }
 
-void SLAUSolverLDLT::printvectorF()
+template <typename StorageT, typename AccumT>
+void SLAUSolverLDLT<StorageT, AccumT>::solveDiagonalSubstitution()
 {
-    for (const auto &val : vectorF)
+    requireOwnStorage();
+    LDLT_PHASE("diagonal", n, 3.0 * n * sizeof(floatingPointType));
+    bandDiagonalSubstitution(inverseD.data(), n, vectorF.data());
+}
+
+template <typename StorageT, typename AccumT>
+void SLAUSolverLDLT<StorageT, AccumT>::solveBackwardSubstitution()
+{
+    requireOwnStorage();
+    LDLT_PHASE("backward", 2.0 * n * m, sweepBytes<floatingPointType>(n, m, 2));
+    sum *work = is_same_v<sum, floatingPointType> ? nullptr : workspace->sumsFor(n);
+    bandBackwardSubstitution<floatingPointType, sum>(matrixAL, vectorF.data(), work, numThreads);
+}
+
+template <typename StorageT, typename AccumT>
+void SLAUSolverLDLT<StorageT, AccumT>::solveLinearSystem()
+{
+    requireOwnStorage();
+    // The diagonal step rides along with the backward sweep, saving one pass over F.
+    solveForwardSubstitution();
+    LDLT_PHASE("diagonal_backward", 2.0 * n * m + n, sweepBytes<floatingPointType>(n, m, 3));
+    sum *work = is_same_v<sum, floatingPointType> ? nullptr : workspace->sumsFor(n);
+    bandDiagonalBackwardSubstitution<floatingPointType, sum>(matrixAL, inverseD.data(), vectorF.data(), work, numThreads);
+}
+
+template <typename StorageT, typename AccumT>
+void SLAUSolverLDLT<StorageT, AccumT>::solveForwardSubstitution(floatingPointType *block, int k, int ld)
+{
+    requireOwnStorage();
+    LDLT_PHASE("forward_block", 2.0 * n * m * k, sweepBytes<floatingPointType>(n, m, 2 * k));
+    bandForwardSubstitution<floatingPointType, sum>(matrixAL, block, k, ld, numThreads);
+}
+
+template <typename StorageT, typename AccumT>
+void SLAUSolverLDLT<StorageT, AccumT>::solveDiagonalSubstitution(floatingPointType *block, int k, int ld)
+{
+    requireOwnStorage();
+    LDLT_PHASE("diagonal_block", double(n) * k, (2.0 * k + 1) * n * sizeof(floatingPointType));
+    bandDiagonalSubstitution(inverseD.data(), n, block, k, ld);
+}
+
+template <typename StorageT, typename AccumT>
+void SLAUSolverLDLT<StorageT, AccumT>::solveBackwardSubstitution(floatingPointType *block, int k, int ld)
+{
+    requireOwnStorage();
+    LDLT_PHASE("backward_block", 2.0 * n * m * k, sweepBytes<floatingPointType>(n, m, 2 * k));
+    floatingPointType *columnL = workspace->columnFor(m * bandSweepColumnGroups(n, m, k, numThreads));
+    bandBackwardSubstitution<floatingPointType, sum>(matrixAL, block, k, ld, columnL, numThreads);
+}
+
+template <typename StorageT, typename AccumT>
+void SLAUSolverLDLT<StorageT, AccumT>::solveLinearSystem(floatingPointType *block, int k, int ld)
+{
+    requireOwnStorage();
+    if (k < 0 || ld < n)
     {
-        cout << val << '\n';
+        throw invalid_argument("Invalid right-hand side block shape");
     }
-    cout << '\n';
+    solveForwardSubstitution(block, k, ld);
+    LDLT_PHASE("diagonal_backward_block", (2.0 * m + 1) * n * k, sweepBytes<floatingPointType>(n, m, 2 * k + 1));
+    floatingPointType *columnL = workspace->columnFor(m * bandSweepColumnGroups(n, m, k, numThreads));
+    bandDiagonalBackwardSubstitution<floatingPointType, sum>(matrixAL, inverseD.data(), block, k, ld, columnL, numThreads);
 }
 
-void SLAUSolverLDLT::returnMatix()
+template <typename StorageT, typename AccumT>
+void SLAUSolverLDLT<StorageT, AccumT>::solveLinearSystem(vector<floatingPointType> &block, int k)
 {
-    loadFromFile(AlFilePath, matrixAL);
-    loadFromFile(DFilePath, diagD);
+    if (block.size() != size_t(n) * k)
+    {
+        throw invalid_argument("Right-hand side block must hold n * k values");
+    }
+    solveLinearSystem(block.data(), k, n);
 }
 
-void SLAUSolverLDLT::printMultiplyMatrixToVector()
+template <typename StorageT, typename AccumT>
+RefinementReport SLAUSolverLDLT<StorageT, AccumT>::solveWithRefinement(double tolerance, int maxIterations)
 {
-    cout << "Result of multiplying matrix (A = AL + D) by vector X:" << "\n";
+    requireOwnStorage();
+    if (tolerance <= 0 || maxIterations < 0)
+    {
+        throw invalid_argument("Refinement tolerance must be positive and the iteration limit non-negative");
+    }
 
-    for (int i = 0; i < n; ++i)
+    if constexpr (!is_same_v<StorageT, double>)
     {
-        floatingPointType result = diagD[i] * vectorF[i];
-        int baseIndexI = m - i;
+        throw logic_error("Iterative refinement needs A in double storage (use --precision double)");
+    }
+    else
+    {
+        const BandMatrix<double> &AL = originalAL();
+        const vector<double> &AD = originalD();
 
-        for (int j = 0; j < n; ++j)
+        SLAUSolverLDLT<float, float> low(n, m, solveFilePath);
+        for (int i = 0; i < n; ++i)
         {
-            if (i == j)
+            const double *row = AL[i];
+            float *lowRow = low.matrixAL[i];
+            for (int j = 0; j < m; ++j)
             {
-                continue;
+                lowRow[j] = float(row[j]);
             }
-            else if (j < i && (i - j) <= m)
+            low.diagD[i] = float(AD[i]);
+        }
+        low.setNumThreads(numThreads);
+        low.setFactorizationKernel(kernel, blockSize);
+        low.setPivotCheck(pivots.minimumPivot(), pivots.abortsOnBadPivot());
+        auto factors = low.factorize();
+        pivots = low.pivots;
+
+        vector<double> x(n, 0.0), residual(n), best;
+        vector<float> correction(n);
+
+        // A step that stalls or diverges can leave x worse than before it, so the
+        // iterate with the smallest residual is the one returned.
+        RefinementReport report;
+        double previousNorm = numeric_limits<double>::infinity();
+        for (int iteration = 0;; ++iteration)
+        {
+            ResidualNorms norms = bandResidual(AL, AD.data(), x.data(), vectorF.data(), residual.data(), numThreads);
+            double norm = norms.l2;
+
+            if (iteration > 0)
             {
-                int indexIJ = baseIndexI + j;
-                result += matrixAL[i][indexIJ] * vectorF[j];
+                if (best.empty() || norm < report.residualNorm)
+                {
+                    best = x;
+                    report.iterations = iteration - 1;
+                    report.residualNorm = norm;
+                    report.relativeResidual = norms.relative;
+                }
+                if (norms.relative <= tolerance)
+                {
+                    report.converged = true;
+                    break;
+                }
+                if (norm > 0.5 * previousNorm || iteration > maxIterations)
+                {
+                    break;
+                }
             }
-            else if (i < j && (j - i) <= m)
+            previousNorm = norm;
+
+            for (int i = 0; i < n; ++i)
             {
-                int baseIndexJ = m - j;
-                int indexJI = baseIndexJ + i;
-                result += matrixAL[j][indexJI] * vectorF[j];
+                correction[i] = float(residual[i]);
+            }
+            factors->solve(correction.data());
+            for (int i = 0; i < n; ++i)
+            {
+                x[i] += correction[i];
             }
         }
-        cout << result << endl;
+
+        vectorF = std::move(best);
+        return report;
     }
 }
 
-void SLAUSolverLDLT::printRestoredMatrix()
+template <typename StorageT, typename AccumT>
+void SLAUSolverLDLT<StorageT, AccumT>::writeSolution(const floatingPointType *x, size_t count) const
 {
+    LDLT_PHASE("write_solution", 0, 0);
+    if (solutionFormat == SolutionFormat::Binary)
+    {
+        writeVectorFile(solveFilePath, x, count);
+    }
+    else
+    {
+        writeVectorText(solveFilePath, x, count, precisionDigits<floatingPointType>);
+    }
+    LDLT_PHASE_BYTES(Instrumentation::fileBytes(solveFilePath));
+}
+
+template <typename StorageT, typename AccumT>
+void SLAUSolverLDLT<StorageT, AccumT>::writeVectorFToFile()
+{
+    waitForWrite();
+    writeSolution(vectorF.data(), vectorF.size());
+}
+
+template <typename StorageT, typename AccumT>
+void SLAUSolverLDLT<StorageT, AccumT>::writeVectorFToFileAsync()
+{
+    waitForWrite();
+    pendingSolution.assign(vectorF.begin(), vectorF.end());
+    pendingWrite = async(launch::async, [this]
+                         { writeSolution(pendingSolution.data(), pendingSolution.size()); });
+}
+
+template <typename StorageT, typename AccumT>
+void SLAUSolverLDLT<StorageT, AccumT>::waitForWrite()
+{
+    if (pendingWrite.valid())
+    {
+        pendingWrite.get();
+    }
+}
+
+template <typename StorageT, typename AccumT>
+void SLAUSolverLDLT<StorageT, AccumT>::printvectorF(ostream &out) const
+{
+    ostringstream text = diagnosticBuffer<floatingPointType>();
+    for (const auto &val : vectorF)
+    {
+        text << val << '\n';
+    }
+    text << '\n';
+    out << text.str();
+}
+
+template <typename StorageT, typename AccumT>
+void SLAUSolverLDLT<StorageT, AccumT>::returnMatix()
+{
+    if (snapshotValid)
+    {
+        matrixAL = snapshotAL;
+        diagD = snapshotD;
+        factored = false;
+        factoredRows = 0;
+        handedOver = false;
+        return;
+    }
+    if (!bandFilePath.empty())
+    {
+        loadFromBandFile(bandFilePath, false, false);
+        return;
+    }
+
+    if (matrixAL.rows() != n)
+    {
+        matrixAL.resize(n, m);
+    }
+    diagD.resize(n, 0.0);
+    loadFromFile(AlFilePath, matrixAL);
+    loadFromFile(DFilePath, diagD);
+    factored = false;
+    factoredRows = 0;
+    handedOver = false;
+}
+
+template <typename StorageT, typename AccumT>
+void SLAUSolverLDLT<StorageT, AccumT>::multiply(const floatingPointType *x, sum *y) const
+{
+    requireOwnStorage();
+    bandMultiply(originalAL(), originalD().data(), x, y, numThreads);
+}
+
+template <typename StorageT, typename AccumT>
+vector<typename SLAUSolverLDLT<StorageT, AccumT>::sum> SLAUSolverLDLT<StorageT, AccumT>::multiplyMatrixToVector() const
+{
+    vector<sum> result(n);
+    multiply(vectorF.data(), result.data());
+    return result;
+}
+
+template <typename StorageT, typename AccumT>
+uint64_t SLAUSolverLDLT<StorageT, AccumT>::contentHash() const
+{
+    requireOwnStorage();
+    const BandMatrix<floatingPointType> &AL = originalAL();
+    const vector<floatingPointType> &AD = originalD();
+    const uint64_t shape[2] = {uint64_t(n), uint64_t(m)};
+    uint64_t hash = fnv1a64(shape, sizeof(shape));
+    hash = fnv1a64(AL.raw(), size_t(n) * AL.rowStride() * sizeof(floatingPointType), hash);
+    return fnv1a64(AD.data(), size_t(n) * sizeof(floatingPointType), hash);
+}
+
+template <typename StorageT, typename AccumT>
+bool SLAUSolverLDLT<StorageT, AccumT>::matches(const Factorization &factors) const
+{
+    requireOwnStorage();
+    return factors.matchesOriginal(originalAL(), originalD());
+}
+
+template <typename StorageT, typename AccumT>
+ResidualNorms SLAUSolverLDLT<StorageT, AccumT>::residualNorms(const floatingPointType *x, const floatingPointType *f) const
+{
+    requireOwnStorage();
+    LDLT_PHASE("residual", 4.0 * n * m + 3.0 * n, sweepBytes<floatingPointType>(n, m, 4));
+    return bandResidual(originalAL(), originalD().data(), x, f, workspace->sumsFor(n), numThreads);
+}
+
+template <typename StorageT, typename AccumT>
+void SLAUSolverLDLT<StorageT, AccumT>::setVectorF(const floatingPointType *f)
+{
+    copy(f, f + n, vectorF.begin());
+}
+
+template <typename StorageT, typename AccumT>
+void SLAUSolverLDLT<StorageT, AccumT>::printMultiplyMatrixToVector(ostream &out) const
+{
+    vector<sum> result = multiplyMatrixToVector();
+
+    ostringstream text = diagnosticBuffer<floatingPointType>();
+    text << "Result of multiplying matrix (A = AL + D) by vector X:" << "\n";
+    for (int i = 0; i < n; ++i)
+    {
+        text << result[i] << '\n';
+    }
+    out << text.str() << flush;
+}
+
+template <typename StorageT, typename AccumT>
+void SLAUSolverLDLT<StorageT, AccumT>::printRestoredMatrix(ostream &out) const
+{
+    requireOwnStorage();
+    ostringstream text = diagnosticBuffer<floatingPointType>();
     for (int i = 0; i < n; i++)
     {
         for (int j = 0; j < n; j++)
         {
             if (i == j)
             {
-                cout << diagD[i] << " ";
+                text << diagD[i] << " ";
             }
             else if (j < i && (i - j) <= m)
             {
                 int baseIndexI = m - i;
                 int indexIJ = baseIndexI + j;
-                cout << matrixAL[i][indexIJ] << " ";
+                text << matrixAL[i][indexIJ] << " ";
             }
             else if (i < j && (j - i) <= m)
             {
                 int baseIndexJ = m - j;
                 int indexJI = baseIndexJ + i;
-                cout << matrixAL[j][indexJI] << " ";
+                text << matrixAL[j][indexJI] << " ";
             }
             else
             {
-                cout << 0.0 << " ";
+                text << 0.0 << " ";
             }
         }
-        cout << '\n';
+        text << '\n';
     }
-    cout << '\n';
+    text << '\n';
+    out << text.str();
 }
 
-void SLAUSolverLDLT::printMatrixAL()
+template <typename StorageT, typename AccumT>
+void SLAUSolverLDLT<StorageT, AccumT>::printMatrixAL(ostream &out) const
 {
-    for (const auto &row : matrixAL)
+    requireOwnStorage();
+    ostringstream text = diagnosticBuffer<floatingPointType>();
+    for (int i = 0; i < n; ++i)
     {
-        for (const auto &value : row)
+        const floatingPointType *row = matrixAL[i];
+        for (int j = 0; j < m; ++j)
         {
-            cout << value << " ";
+            text << row[j] << " ";
         }
-        cout << '\n';
+        text << '\n';
     }
-    cout << '\n';
+    text << '\n';
+    out << text.str();
 }
 
-void SLAUSolverLDLT::HilbertBandMatrix()
+template <typename StorageT, typename AccumT>
+void SLAUSolverLDLT<StorageT, AccumT>::HilbertBandMatrix()
 {
+    requireOwnStorage();
+    matrixChanged();
     for (int i = 1; i < n; ++i)
     {
         diagD[i] = 1.0 / (2 * i + 1);
@@ -309,8 +1220,22 @@ void SLAUSolverLDLT::HilbertBandMatrix()
     }
 }
 
-void SLAUSolverLDLT::returnMatixAfterHilbert()
+template <typename StorageT, typename AccumT>
+void SLAUSolverLDLT<StorageT, AccumT>::returnMatixAfterHilbert()
 {
+    if (snapshotValid)
+    {
+        returnMatix();
+        return;
+    }
+    if (handedOver)
+    {
+        matrixAL.resize(n, m);
+        diagD.assign(n, 0.0);
+        handedOver = false;
+    }
+    factored = false;
+    factoredRows = 0;
     for (int i = 1; i < n; ++i)
     {
         diagD[i] = 1.0 / (2 * i + 1);
@@ -323,3 +1248,98 @@ void SLAUSolverLDLT::returnMatixAfterHilbert()
         }
     }
 }
+
+template <typename StorageT, typename AccumT>
+void SLAUSolverLDLT<StorageT, AccumT>::DiagonallyDominantBandMatrix(unsigned seed)
+{
+    requireOwnStorage();
+    matrixChanged();
+    mt19937 generator(seed);
+    uniform_real_distribution<double> offDiagonal(-1.0, 1.0);
+    uniform_real_distribution<double> rightHandSide(-1.0, 1.0);
+    vector<double> rowSum(n, 0.0);
+
+    for (int i = 0; i < n; ++i)
+    {
+        int baseIndexI = m - i;
+
+        for (int j = max(0, i - m); j < i; ++j)
+        {
+            int indexIJ = baseIndexI + j;
+            matrixAL[i][indexIJ] = floatingPointType(offDiagonal(generator));
+            rowSum[i] += fabs(double(matrixAL[i][indexIJ]));
+            rowSum[j] += fabs(double(matrixAL[i][indexIJ]));
+        }
+        vectorF[i] = floatingPointType(rightHandSide(generator));
+    }
+
+    for (int i = 0; i < n; ++i)
+    {
+        diagD[i] = floatingPointType(rowSum[i] + 1.0);
+    }
+}
+
+template <typename StorageT, typename AccumT>
+void SLAUSolverLDLT<StorageT, AccumT>::LaplacianBandMatrix()
+{
+    requireOwnStorage();
+    matrixChanged();
+    for (int i = 0; i < n; ++i)
+    {
+        int baseIndexI = m - i;
+
+        diagD[i] = m == 1 ? 2.0 : 4.0;
+        vectorF[i] = 1.0;
+
+        if (m == 0)
+        {
+            continue;
+        }
+        if (i >= m)
+        {
+            matrixAL[i][baseIndexI + i - m] = -1.0;
+        }
+        if (i > 0 && (m == 1 || i % m != 0))
+        {
+            matrixAL[i][baseIndexI + i - 1] = -1.0;
+        }
+    }
+}
+
+template <typename StorageT, typename AccumT>
+void SLAUSolverLDLT<StorageT, AccumT>::saveToFile(const string &inputFilePath,
+                                                  const string &alFilePath,
+                                                  const string &dFilePath,
+                                                  const string &fFilePath) const
+{
+    ofstream input(inputFilePath), al(alFilePath), d(dFilePath), f(fFilePath);
+    if (!input.is_open() || !al.is_open() || !d.is_open() || !f.is_open())
+    {
+        throw runtime_error("Could not open output files for " + alFilePath);
+    }
+
+    input << n << ' ' << m << '\n';
+
+    al << setprecision(precisionDigits<floatingPointType> + 2);
+    d << setprecision(precisionDigits<floatingPointType> + 2);
+    f << setprecision(precisionDigits<floatingPointType> + 2);
+    for (int i = 0; i < n; ++i)
+    {
+        const floatingPointType *row = matrixAL[i];
+        for (int j = 0; j < m; ++j)
+        {
+            al << row[j] << (j + 1 < m ? ' ' : '\n');
+        }
+        d << diagD[i] << '\n';
+        f << vectorF[i] << '\n';
+    }
+
+    if (!input || !al || !d || !f)
+    {
+        throw runtime_error("Could not write system files for " + alFilePath);
+    }
+}
+
+template class SLAUSolverLDLT<float, float>;
+template class SLAUSolverLDLT<double, double>;
+template class SLAUSolverLDLT<float, double>;
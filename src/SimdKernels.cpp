@@ -0,0 +1,890 @@
+/**
+ * @file SimdKernels.cpp
+ * @brief Scalar, AVX2, AVX-512 and NEON band kernels with runtime selection.
+ */
+#include "SimdKernels.hpp"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define LDLT_SIMD_X86 1
+#elif defined(__aarch64__)
+#include <arm_neon.h>
+#define LDLT_SIMD_NEON 1
+#endif
+
+namespace
+{
+    template <typename T, typename Acc>
+    Acc dotScalar(const T *a, const T *b, int len)
+    {
+        Acc result = 0;
+        for (int i = 0; i < len; ++i)
+        {
+            result += Acc(a[i]) * b[i];
+        }
+        return result;
+    }
+
+    template <typename T, typename Acc>
+    Acc dotScaledScalar(const T *a, const T *b, const T *d, int len)
+    {
+        Acc result = 0;
+        for (int i = 0; i < len; ++i)
+        {
+            result += Acc(a[i]) * b[i] * d[i];
+        }
+        return result;
+    }
+
+    template <typename T, typename Acc>
+    void axpyScalar(Acc *y, Acc alpha, const T *x, int len)
+    {
+        for (int i = 0; i < len; ++i)
+        {
+            y[i] += alpha * x[i];
+        }
+    }
+
+    template <typename T, typename Acc>
+    void dot4Scalar(const T *a, const Acc *w, int ldw, int len, Acc *out)
+    {
+        Acc s0 = 0, s1 = 0, s2 = 0, s3 = 0;
+        for (int i = 0; i < len; ++i)
+        {
+            Acc x = a[i];
+            s0 += x * w[i];
+            s1 += x * w[ldw + i];
+            s2 += x * w[2 * ldw + i];
+            s3 += x * w[3 * ldw + i];
+        }
+        out[0] = s0;
+        out[1] = s1;
+        out[2] = s2;
+        out[3] = s3;
+    }
+
+#if defined(LDLT_SIMD_X86)
+    // AVX2 + FMA: 8 floats or 4 doubles per register.
+
+    __attribute__((target("avx2,fma"))) float horizontalSum(__m256 v)
+    {
+        __m128 low = _mm_add_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1));
+        low = _mm_hadd_ps(low, low);
+        low = _mm_hadd_ps(low, low);
+        return _mm_cvtss_f32(low);
+    }
+
+    __attribute__((target("avx2,fma"))) double horizontalSum(__m256d v)
+    {
+        __m128d low = _mm_add_pd(_mm256_castpd256_pd128(v), _mm256_extractf128_pd(v, 1));
+        return _mm_cvtsd_f64(_mm_add_sd(low, _mm_unpackhi_pd(low, low)));
+    }
+
+    __attribute__((target("avx2,fma"))) float dotAvx2(const float *a, const float *b, int len)
+    {
+        __m256 s0 = _mm256_setzero_ps(), s1 = _mm256_setzero_ps();
+        int i = 0;
+        for (; i + 16 <= len; i += 16)
+        {
+            s0 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i), s0);
+            s1 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i + 8), _mm256_loadu_ps(b + i + 8), s1);
+        }
+        for (; i + 8 <= len; i += 8)
+        {
+            s0 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i), s0);
+        }
+        float result = horizontalSum(_mm256_add_ps(s0, s1));
+        for (; i < len; ++i)
+        {
+            result += a[i] * b[i];
+        }
+        return result;
+    }
+
+    __attribute__((target("avx2,fma"))) double dotAvx2(const double *a, const double *b, int len)
+    {
+        __m256d s0 = _mm256_setzero_pd(), s1 = _mm256_setzero_pd();
+        int i = 0;
+        for (; i + 8 <= len; i += 8)
+        {
+            s0 = _mm256_fmadd_pd(_mm256_loadu_pd(a + i), _mm256_loadu_pd(b + i), s0);
+            s1 = _mm256_fmadd_pd(_mm256_loadu_pd(a + i + 4), _mm256_loadu_pd(b + i + 4), s1);
+        }
+        for (; i + 4 <= len; i += 4)
+        {
+            s0 = _mm256_fmadd_pd(_mm256_loadu_pd(a + i), _mm256_loadu_pd(b + i), s0);
+        }
+        double result = horizontalSum(_mm256_add_pd(s0, s1));
+        for (; i < len; ++i)
+        {
+            result += a[i] * b[i];
+        }
+        return result;
+    }
+
+    __attribute__((target("avx2,fma"))) double dotAvx2Widened(const float *a, const float *b, int len)
+    {
+        __m256d s0 = _mm256_setzero_pd(), s1 = _mm256_setzero_pd();
+        int i = 0;
+        for (; i + 8 <= len; i += 8)
+        {
+            s0 = _mm256_fmadd_pd(_mm256_cvtps_pd(_mm_loadu_ps(a + i)), _mm256_cvtps_pd(_mm_loadu_ps(b + i)), s0);
+            s1 = _mm256_fmadd_pd(_mm256_cvtps_pd(_mm_loadu_ps(a + i + 4)), _mm256_cvtps_pd(_mm_loadu_ps(b + i + 4)), s1);
+        }
+        double result = horizontalSum(_mm256_add_pd(s0, s1));
+        for (; i < len; ++i)
+        {
+            result += double(a[i]) * b[i];
+        }
+        return result;
+    }
+
+    __attribute__((target("avx2,fma"))) float dotScaledAvx2(const float *a, const float *b, const float *d, int len)
+    {
+        __m256 s0 = _mm256_setzero_ps();
+        int i = 0;
+        for (; i + 8 <= len; i += 8)
+        {
+            __m256 ab = _mm256_mul_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i));
+            s0 = _mm256_fmadd_ps(ab, _mm256_loadu_ps(d + i), s0);
+        }
+        float result = horizontalSum(s0);
+        for (; i < len; ++i)
+        {
+            result += a[i] * b[i] * d[i];
+        }
+        return result;
+    }
+
+    __attribute__((target("avx2,fma"))) double dotScaledAvx2(const double *a, const double *b, const double *d, int len)
+    {
+        __m256d s0 = _mm256_setzero_pd();
+        int i = 0;
+        for (; i + 4 <= len; i += 4)
+        {
+            __m256d ab = _mm256_mul_pd(_mm256_loadu_pd(a + i), _mm256_loadu_pd(b + i));
+            s0 = _mm256_fmadd_pd(ab, _mm256_loadu_pd(d + i), s0);
+        }
+        double result = horizontalSum(s0);
+        for (; i < len; ++i)
+        {
+            result += a[i] * b[i] * d[i];
+        }
+        return result;
+    }
+
+    __attribute__((target("avx2,fma"))) double dotScaledAvx2Widened(const float *a, const float *b, const float *d, int len)
+    {
+        __m256d s0 = _mm256_setzero_pd();
+        int i = 0;
+        for (; i + 4 <= len; i += 4)
+        {
+            __m256d ab = _mm256_mul_pd(_mm256_cvtps_pd(_mm_loadu_ps(a + i)), _mm256_cvtps_pd(_mm_loadu_ps(b + i)));
+            s0 = _mm256_fmadd_pd(ab, _mm256_cvtps_pd(_mm_loadu_ps(d + i)), s0);
+        }
+        double result = horizontalSum(s0);
+        for (; i < len; ++i)
+        {
+            result += double(a[i]) * b[i] * d[i];
+        }
+        return result;
+    }
+
+    __attribute__((target("avx2,fma"))) void axpyAvx2(float *y, float alpha, const float *x, int len)
+    {
+        __m256 va = _mm256_set1_ps(alpha);
+        int i = 0;
+        for (; i + 8 <= len; i += 8)
+        {
+            _mm256_storeu_ps(y + i, _mm256_fmadd_ps(va, _mm256_loadu_ps(x + i), _mm256_loadu_ps(y + i)));
+        }
+        for (; i < len; ++i)
+        {
+            y[i] += alpha * x[i];
+        }
+    }
+
+    __attribute__((target("avx2,fma"))) void axpyAvx2(double *y, double alpha, const double *x, int len)
+    {
+        __m256d va = _mm256_set1_pd(alpha);
+        int i = 0;
+        for (; i + 4 <= len; i += 4)
+        {
+            _mm256_storeu_pd(y + i, _mm256_fmadd_pd(va, _mm256_loadu_pd(x + i), _mm256_loadu_pd(y + i)));
+        }
+        for (; i < len; ++i)
+        {
+            y[i] += alpha * x[i];
+        }
+    }
+
+    __attribute__((target("avx2,fma"))) void axpyAvx2Widened(double *y, double alpha, const float *x, int len)
+    {
+        __m256d va = _mm256_set1_pd(alpha);
+        int i = 0;
+        for (; i + 4 <= len; i += 4)
+        {
+            __m256d vx = _mm256_cvtps_pd(_mm_loadu_ps(x + i));
+            _mm256_storeu_pd(y + i, _mm256_fmadd_pd(va, vx, _mm256_loadu_pd(y + i)));
+        }
+        for (; i < len; ++i)
+        {
+            y[i] += alpha * x[i];
+        }
+    }
+
+    __attribute__((target("avx2,fma"))) void dot4Avx2(const float *a, const float *w, int ldw, int len, float *out)
+    {
+        __m256 s0 = _mm256_setzero_ps(), s1 = _mm256_setzero_ps(), s2 = _mm256_setzero_ps(), s3 = _mm256_setzero_ps();
+        const float *w1 = w + ldw, *w2 = w1 + ldw, *w3 = w2 + ldw;
+        int i = 0;
+        for (; i + 8 <= len; i += 8)
+        {
+            __m256 x = _mm256_loadu_ps(a + i);
+            s0 = _mm256_fmadd_ps(x, _mm256_loadu_ps(w + i), s0);
+            s1 = _mm256_fmadd_ps(x, _mm256_loadu_ps(w1 + i), s1);
+            s2 = _mm256_fmadd_ps(x, _mm256_loadu_ps(w2 + i), s2);
+            s3 = _mm256_fmadd_ps(x, _mm256_loadu_ps(w3 + i), s3);
+        }
+        float r0 = horizontalSum(s0), r1 = horizontalSum(s1), r2 = horizontalSum(s2), r3 = horizontalSum(s3);
+        for (; i < len; ++i)
+        {
+            float x = a[i];
+            r0 += x * w[i];
+            r1 += x * w1[i];
+            r2 += x * w2[i];
+            r3 += x * w3[i];
+        }
+        out[0] = r0;
+        out[1] = r1;
+        out[2] = r2;
+        out[3] = r3;
+    }
+
+    __attribute__((target("avx2,fma"))) void dot4Avx2(const double *a, const double *w, int ldw, int len, double *out)
+    {
+        __m256d s0 = _mm256_setzero_pd(), s1 = _mm256_setzero_pd(), s2 = _mm256_setzero_pd(), s3 = _mm256_setzero_pd();
+        const double *w1 = w + ldw, *w2 = w1 + ldw, *w3 = w2 + ldw;
+        int i = 0;
+        for (; i + 4 <= len; i += 4)
+        {
+            __m256d x = _mm256_loadu_pd(a + i);
+            s0 = _mm256_fmadd_pd(x, _mm256_loadu_pd(w + i), s0);
+            s1 = _mm256_fmadd_pd(x, _mm256_loadu_pd(w1 + i), s1);
+            s2 = _mm256_fmadd_pd(x, _mm256_loadu_pd(w2 + i), s2);
+            s3 = _mm256_fmadd_pd(x, _mm256_loadu_pd(w3 + i), s3);
+        }
+        double r0 = horizontalSum(s0), r1 = horizontalSum(s1), r2 = horizontalSum(s2), r3 = horizontalSum(s3);
+        for (; i < len; ++i)
+        {
+            double x = a[i];
+            r0 += x * w[i];
+            r1 += x * w1[i];
+            r2 += x * w2[i];
+            r3 += x * w3[i];
+        }
+        out[0] = r0;
+        out[1] = r1;
+        out[2] = r2;
+        out[3] = r3;
+    }
+
+    __attribute__((target("avx2,fma"))) void dot4Avx2Widened(const float *a, const double *w, int ldw, int len, double *out)
+    {
+        __m256d s0 = _mm256_setzero_pd(), s1 = _mm256_setzero_pd(), s2 = _mm256_setzero_pd(), s3 = _mm256_setzero_pd();
+        const double *w1 = w + ldw, *w2 = w1 + ldw, *w3 = w2 + ldw;
+        int i = 0;
+        for (; i + 4 <= len; i += 4)
+        {
+            __m256d x = _mm256_cvtps_pd(_mm_loadu_ps(a + i));
+            s0 = _mm256_fmadd_pd(x, _mm256_loadu_pd(w + i), s0);
+            s1 = _mm256_fmadd_pd(x, _mm256_loadu_pd(w1 + i), s1);
+            s2 = _mm256_fmadd_pd(x, _mm256_loadu_pd(w2 + i), s2);
+            s3 = _mm256_fmadd_pd(x, _mm256_loadu_pd(w3 + i), s3);
+        }
+        double r0 = horizontalSum(s0), r1 = horizontalSum(s1), r2 = horizontalSum(s2), r3 = horizontalSum(s3);
+        for (; i < len; ++i)
+        {
+            double x = a[i];
+            r0 += x * w[i];
+            r1 += x * w1[i];
+            r2 += x * w2[i];
+            r3 += x * w3[i];
+        }
+        out[0] = r0;
+        out[1] = r1;
+        out[2] = r2;
+        out[3] = r3;
+    }
+
+    // AVX-512: 16 floats or 8 doubles per register, masked tails.
+
+    __attribute__((target("avx512f"))) float dotAvx512(const float *a, const float *b, int len)
+    {
+        __m512 s0 = _mm512_setzero_ps();
+        int i = 0;
+        for (; i + 16 <= len; i += 16)
+        {
+            s0 = _mm512_fmadd_ps(_mm512_loadu_ps(a + i), _mm512_loadu_ps(b + i), s0);
+        }
+        if (i < len)
+        {
+            __mmask16 mask = __mmask16((1u << (len - i)) - 1);
+            s0 = _mm512_fmadd_ps(_mm512_maskz_loadu_ps(mask, a + i), _mm512_maskz_loadu_ps(mask, b + i), s0);
+        }
+        return _mm512_reduce_add_ps(s0);
+    }
+
+    __attribute__((target("avx512f"))) double dotAvx512(const double *a, const double *b, int len)
+    {
+        __m512d s0 = _mm512_setzero_pd();
+        int i = 0;
+        for (; i + 8 <= len; i += 8)
+        {
+            s0 = _mm512_fmadd_pd(_mm512_loadu_pd(a + i), _mm512_loadu_pd(b + i), s0);
+        }
+        if (i < len)
+        {
+            __mmask8 mask = __mmask8((1u << (len - i)) - 1);
+            s0 = _mm512_fmadd_pd(_mm512_maskz_loadu_pd(mask, a + i), _mm512_maskz_loadu_pd(mask, b + i), s0);
+        }
+        return _mm512_reduce_add_pd(s0);
+    }
+
+    __attribute__((target("avx512f"))) double dotAvx512Widened(const float *a, const float *b, int len)
+    {
+        __m512d s0 = _mm512_setzero_pd();
+        int i = 0;
+        for (; i + 8 <= len; i += 8)
+        {
+            s0 = _mm512_fmadd_pd(_mm512_cvtps_pd(_mm256_loadu_ps(a + i)), _mm512_cvtps_pd(_mm256_loadu_ps(b + i)), s0);
+        }
+        double result = _mm512_reduce_add_pd(s0);
+        for (; i < len; ++i)
+        {
+            result += double(a[i]) * b[i];
+        }
+        return result;
+    }
+
+    __attribute__((target("avx512f"))) float dotScaledAvx512(const float *a, const float *b, const float *d, int len)
+    {
+        __m512 s0 = _mm512_setzero_ps();
+        int i = 0;
+        for (; i + 16 <= len; i += 16)
+        {
+            __m512 ab = _mm512_mul_ps(_mm512_loadu_ps(a + i), _mm512_loadu_ps(b + i));
+            s0 = _mm512_fmadd_ps(ab, _mm512_loadu_ps(d + i), s0);
+        }
+        if (i < len)
+        {
+            __mmask16 mask = __mmask16((1u << (len - i)) - 1);
+            __m512 ab = _mm512_mul_ps(_mm512_maskz_loadu_ps(mask, a + i), _mm512_maskz_loadu_ps(mask, b + i));
+            s0 = _mm512_fmadd_ps(ab, _mm512_maskz_loadu_ps(mask, d + i), s0);
+        }
+        return _mm512_reduce_add_ps(s0);
+    }
+
+    __attribute__((target("avx512f"))) double dotScaledAvx512(const double *a, const double *b, const double *d, int len)
+    {
+        __m512d s0 = _mm512_setzero_pd();
+        int i = 0;
+        for (; i + 8 <= len; i += 8)
+        {
+            __m512d ab = _mm512_mul_pd(_mm512_loadu_pd(a + i), _mm512_loadu_pd(b + i));
+            s0 = _mm512_fmadd_pd(ab, _mm512_loadu_pd(d + i), s0);
+        }
+        if (i < len)
+        {
+            __mmask8 mask = __mmask8((1u << (len - i)) - 1);
+            __m512d ab = _mm512_mul_pd(_mm512_maskz_loadu_pd(mask, a + i), _mm512_maskz_loadu_pd(mask, b + i));
+            s0 = _mm512_fmadd_pd(ab, _mm512_maskz_loadu_pd(mask, d + i), s0);
+        }
+        return _mm512_reduce_add_pd(s0);
+    }
+
+    __attribute__((target("avx512f"))) double dotScaledAvx512Widened(const float *a, const float *b, const float *d, int len)
+    {
+        __m512d s0 = _mm512_setzero_pd();
+        int i = 0;
+        for (; i + 8 <= len; i += 8)
+        {
+            __m512d ab = _mm512_mul_pd(_mm512_cvtps_pd(_mm256_loadu_ps(a + i)), _mm512_cvtps_pd(_mm256_loadu_ps(b + i)));
+            s0 = _mm512_fmadd_pd(ab, _mm512_cvtps_pd(_mm256_loadu_ps(d + i)), s0);
+        }
+        double result = _mm512_reduce_add_pd(s0);
+        for (; i < len; ++i)
+        {
+            result += double(a[i]) * b[i] * d[i];
+        }
+        return result;
+    }
+
+    __attribute__((target("avx512f"))) void axpyAvx512(float *y, float alpha, const float *x, int len)
+    {
+        __m512 va = _mm512_set1_ps(alpha);
+        int i = 0;
+        for (; i + 16 <= len; i += 16)
+        {
+            _mm512_storeu_ps(y + i, _mm512_fmadd_ps(va, _mm512_loadu_ps(x + i), _mm512_loadu_ps(y + i)));
+        }
+        if (i < len)
+        {
+            __mmask16 mask = __mmask16((1u << (len - i)) - 1);
+            __m512 vy = _mm512_fmadd_ps(va, _mm512_maskz_loadu_ps(mask, x + i), _mm512_maskz_loadu_ps(mask, y + i));
+            _mm512_mask_storeu_ps(y + i, mask, vy);
+        }
+    }
+
+    __attribute__((target("avx512f"))) void axpyAvx512(double *y, double alpha, const double *x, int len)
+    {
+        __m512d va = _mm512_set1_pd(alpha);
+        int i = 0;
+        for (; i + 8 <= len; i += 8)
+        {
+            _mm512_storeu_pd(y + i, _mm512_fmadd_pd(va, _mm512_loadu_pd(x + i), _mm512_loadu_pd(y + i)));
+        }
+        if (i < len)
+        {
+            __mmask8 mask = __mmask8((1u << (len - i)) - 1);
+            __m512d vy = _mm512_fmadd_pd(va, _mm512_maskz_loadu_pd(mask, x + i), _mm512_maskz_loadu_pd(mask, y + i));
+            _mm512_mask_storeu_pd(y + i, mask, vy);
+        }
+    }
+
+    __attribute__((target("avx512f"))) void axpyAvx512Widened(double *y, double alpha, const float *x, int len)
+    {
+        __m512d va = _mm512_set1_pd(alpha);
+        int i = 0;
+        for (; i + 8 <= len; i += 8)
+        {
+            __m512d vx = _mm512_cvtps_pd(_mm256_loadu_ps(x + i));
+            _mm512_storeu_pd(y + i, _mm512_fmadd_pd(va, vx, _mm512_loadu_pd(y + i)));
+        }
+        for (; i < len; ++i)
+        {
+            y[i] += alpha * x[i];
+        }
+    }
+
+    __attribute__((target("avx512f"))) void dot4Avx512(const float *a, const float *w, int ldw, int len, float *out)
+    {
+        __m512 s0 = _mm512_setzero_ps(), s1 = _mm512_setzero_ps(), s2 = _mm512_setzero_ps(), s3 = _mm512_setzero_ps();
+        const float *w1 = w + ldw, *w2 = w1 + ldw, *w3 = w2 + ldw;
+        int i = 0;
+        for (; i + 16 <= len; i += 16)
+        {
+            __m512 x = _mm512_loadu_ps(a + i);
+            s0 = _mm512_fmadd_ps(x, _mm512_loadu_ps(w + i), s0);
+            s1 = _mm512_fmadd_ps(x, _mm512_loadu_ps(w1 + i), s1);
+            s2 = _mm512_fmadd_ps(x, _mm512_loadu_ps(w2 + i), s2);
+            s3 = _mm512_fmadd_ps(x, _mm512_loadu_ps(w3 + i), s3);
+        }
+        float r0 = _mm512_reduce_add_ps(s0), r1 = _mm512_reduce_add_ps(s1), r2 = _mm512_reduce_add_ps(s2), r3 = _mm512_reduce_add_ps(s3);
+        for (; i < len; ++i)
+        {
+            float x = a[i];
+            r0 += x * w[i];
+            r1 += x * w1[i];
+            r2 += x * w2[i];
+            r3 += x * w3[i];
+        }
+        out[0] = r0;
+        out[1] = r1;
+        out[2] = r2;
+        out[3] = r3;
+    }
+
+    __attribute__((target("avx512f"))) void dot4Avx512(const double *a, const double *w, int ldw, int len, double *out)
+    {
+        __m512d s0 = _mm512_setzero_pd(), s1 = _mm512_setzero_pd(), s2 = _mm512_setzero_pd(), s3 = _mm512_setzero_pd();
+        const double *w1 = w + ldw, *w2 = w1 + ldw, *w3 = w2 + ldw;
+        int i = 0;
+        for (; i + 8 <= len; i += 8)
+        {
+            __m512d x = _mm512_loadu_pd(a + i);
+            s0 = _mm512_fmadd_pd(x, _mm512_loadu_pd(w + i), s0);
+            s1 = _mm512_fmadd_pd(x, _mm512_loadu_pd(w1 + i), s1);
+            s2 = _mm512_fmadd_pd(x, _mm512_loadu_pd(w2 + i), s2);
+            s3 = _mm512_fmadd_pd(x, _mm512_loadu_pd(w3 + i), s3);
+        }
+        double r0 = _mm512_reduce_add_pd(s0), r1 = _mm512_reduce_add_pd(s1), r2 = _mm512_reduce_add_pd(s2), r3 = _mm512_reduce_add_pd(s3);
+        for (; i < len; ++i)
+        {
+            double x = a[i];
+            r0 += x * w[i];
+            r1 += x * w1[i];
+            r2 += x * w2[i];
+            r3 += x * w3[i];
+        }
+        out[0] = r0;
+        out[1] = r1;
+        out[2] = r2;
+        out[3] = r3;
+    }
+
+    __attribute__((target("avx512f"))) void dot4Avx512Widened(const float *a, const double *w, int ldw, int len, double *out)
+    {
+        __m512d s0 = _mm512_setzero_pd(), s1 = _mm512_setzero_pd(), s2 = _mm512_setzero_pd(), s3 = _mm512_setzero_pd();
+        const double *w1 = w + ldw, *w2 = w1 + ldw, *w3 = w2 + ldw;
+        int i = 0;
+        for (; i + 8 <= len; i += 8)
+        {
+            __m512d x = _mm512_cvtps_pd(_mm256_loadu_ps(a + i));
+            s0 = _mm512_fmadd_pd(x, _mm512_loadu_pd(w + i), s0);
+            s1 = _mm512_fmadd_pd(x, _mm512_loadu_pd(w1 + i), s1);
+            s2 = _mm512_fmadd_pd(x, _mm512_loadu_pd(w2 + i), s2);
+            s3 = _mm512_fmadd_pd(x, _mm512_loadu_pd(w3 + i), s3);
+        }
+        double r0 = _mm512_reduce_add_pd(s0), r1 = _mm512_reduce_add_pd(s1), r2 = _mm512_reduce_add_pd(s2), r3 = _mm512_reduce_add_pd(s3);
+        for (; i < len; ++i)
+        {
+            double x = a[i];
+            r0 += x * w[i];
+            r1 += x * w1[i];
+            r2 += x * w2[i];
+            r3 += x * w3[i];
+        }
+        out[0] = r0;
+        out[1] = r1;
+        out[2] = r2;
+        out[3] = r3;
+    }
+#endif
+
+#if defined(LDLT_SIMD_NEON)
+    // NEON: 4 floats or 2 doubles per register.
+
+    float dotNeon(const float *a, const float *b, int len)
+    {
+        float32x4_t s0 = vdupq_n_f32(0.0f);
+        int i = 0;
+        for (; i + 4 <= len; i += 4)
+        {
+            s0 = vfmaq_f32(s0, vld1q_f32(a + i), vld1q_f32(b + i));
+        }
+        float result = vaddvq_f32(s0);
+        for (; i < len; ++i)
+        {
+            result += a[i] * b[i];
+        }
+        return result;
+    }
+
+    double dotNeon(const double *a, const double *b, int len)
+    {
+        float64x2_t s0 = vdupq_n_f64(0.0);
+        int i = 0;
+        for (; i + 2 <= len; i += 2)
+        {
+            s0 = vfmaq_f64(s0, vld1q_f64(a + i), vld1q_f64(b + i));
+        }
+        double result = vaddvq_f64(s0);
+        for (; i < len; ++i)
+        {
+            result += a[i] * b[i];
+        }
+        return result;
+    }
+
+    double dotNeonWidened(const float *a, const float *b, int len)
+    {
+        float64x2_t s0 = vdupq_n_f64(0.0);
+        int i = 0;
+        for (; i + 2 <= len; i += 2)
+        {
+            s0 = vfmaq_f64(s0, vcvt_f64_f32(vld1_f32(a + i)), vcvt_f64_f32(vld1_f32(b + i)));
+        }
+        double result = vaddvq_f64(s0);
+        for (; i < len; ++i)
+        {
+            result += double(a[i]) * b[i];
+        }
+        return result;
+    }
+
+    float dotScaledNeon(const float *a, const float *b, const float *d, int len)
+    {
+        float32x4_t s0 = vdupq_n_f32(0.0f);
+        int i = 0;
+        for (; i + 4 <= len; i += 4)
+        {
+            s0 = vfmaq_f32(s0, vmulq_f32(vld1q_f32(a + i), vld1q_f32(b + i)), vld1q_f32(d + i));
+        }
+        float result = vaddvq_f32(s0);
+        for (; i < len; ++i)
+        {
+            result += a[i] * b[i] * d[i];
+        }
+        return result;
+    }
+
+    double dotScaledNeon(const double *a, const double *b, const double *d, int len)
+    {
+        float64x2_t s0 = vdupq_n_f64(0.0);
+        int i = 0;
+        for (; i + 2 <= len; i += 2)
+        {
+            s0 = vfmaq_f64(s0, vmulq_f64(vld1q_f64(a + i), vld1q_f64(b + i)), vld1q_f64(d + i));
+        }
+        double result = vaddvq_f64(s0);
+        for (; i < len; ++i)
+        {
+            result += a[i] * b[i] * d[i];
+        }
+        return result;
+    }
+
+    double dotScaledNeonWidened(const float *a, const float *b, const float *d, int len)
+    {
+        float64x2_t s0 = vdupq_n_f64(0.0);
+        int i = 0;
+        for (; i + 2 <= len; i += 2)
+        {
+            float64x2_t ab = vmulq_f64(vcvt_f64_f32(vld1_f32(a + i)), vcvt_f64_f32(vld1_f32(b + i)));
+            s0 = vfmaq_f64(s0, ab, vcvt_f64_f32(vld1_f32(d + i)));
+        }
+        double result = vaddvq_f64(s0);
+        for (; i < len; ++i)
+        {
+            result += double(a[i]) * b[i] * d[i];
+        }
+        return result;
+    }
+
+    void axpyNeon(float *y, float alpha, const float *x, int len)
+    {
+        float32x4_t va = vdupq_n_f32(alpha);
+        int i = 0;
+        for (; i + 4 <= len; i += 4)
+        {
+            vst1q_f32(y + i, vfmaq_f32(vld1q_f32(y + i), va, vld1q_f32(x + i)));
+        }
+        for (; i < len; ++i)
+        {
+            y[i] += alpha * x[i];
+        }
+    }
+
+    void axpyNeon(double *y, double alpha, const double *x, int len)
+    {
+        float64x2_t va = vdupq_n_f64(alpha);
+        int i = 0;
+        for (; i + 2 <= len; i += 2)
+        {
+            vst1q_f64(y + i, vfmaq_f64(vld1q_f64(y + i), va, vld1q_f64(x + i)));
+        }
+        for (; i < len; ++i)
+        {
+            y[i] += alpha * x[i];
+        }
+    }
+
+    void axpyNeonWidened(double *y, double alpha, const float *x, int len)
+    {
+        float64x2_t va = vdupq_n_f64(alpha);
+        int i = 0;
+        for (; i + 2 <= len; i += 2)
+        {
+            vst1q_f64(y + i, vfmaq_f64(vld1q_f64(y + i), va, vcvt_f64_f32(vld1_f32(x + i))));
+        }
+        for (; i < len; ++i)
+        {
+            y[i] += alpha * x[i];
+        }
+    }
+
+    void dot4Neon(const float *a, const float *w, int ldw, int len, float *out)
+    {
+        float32x4_t s0 = vdupq_n_f32(0.0f), s1 = vdupq_n_f32(0.0f), s2 = vdupq_n_f32(0.0f), s3 = vdupq_n_f32(0.0f);
+        const float *w1 = w + ldw, *w2 = w1 + ldw, *w3 = w2 + ldw;
+        int i = 0;
+        for (; i + 4 <= len; i += 4)
+        {
+            float32x4_t x = vld1q_f32(a + i);
+            s0 = vfmaq_f32(s0, x, vld1q_f32(w + i));
+            s1 = vfmaq_f32(s1, x, vld1q_f32(w1 + i));
+            s2 = vfmaq_f32(s2, x, vld1q_f32(w2 + i));
+            s3 = vfmaq_f32(s3, x, vld1q_f32(w3 + i));
+        }
+        float r0 = vaddvq_f32(s0), r1 = vaddvq_f32(s1), r2 = vaddvq_f32(s2), r3 = vaddvq_f32(s3);
+        for (; i < len; ++i)
+        {
+            float x = a[i];
+            r0 += x * w[i];
+            r1 += x * w1[i];
+            r2 += x * w2[i];
+            r3 += x * w3[i];
+        }
+        out[0] = r0;
+        out[1] = r1;
+        out[2] = r2;
+        out[3] = r3;
+    }
+
+    void dot4Neon(const double *a, const double *w, int ldw, int len, double *out)
+    {
+        float64x2_t s0 = vdupq_n_f64(0.0), s1 = vdupq_n_f64(0.0), s2 = vdupq_n_f64(0.0), s3 = vdupq_n_f64(0.0);
+        const double *w1 = w + ldw, *w2 = w1 + ldw, *w3 = w2 + ldw;
+        int i = 0;
+        for (; i + 2 <= len; i += 2)
+        {
+            float64x2_t x = vld1q_f64(a + i);
+            s0 = vfmaq_f64(s0, x, vld1q_f64(w + i));
+            s1 = vfmaq_f64(s1, x, vld1q_f64(w1 + i));
+            s2 = vfmaq_f64(s2, x, vld1q_f64(w2 + i));
+            s3 = vfmaq_f64(s3, x, vld1q_f64(w3 + i));
+        }
+        double r0 = vaddvq_f64(s0), r1 = vaddvq_f64(s1), r2 = vaddvq_f64(s2), r3 = vaddvq_f64(s3);
+        for (; i < len; ++i)
+        {
+            double x = a[i];
+            r0 += x * w[i];
+            r1 += x * w1[i];
+            r2 += x * w2[i];
+            r3 += x * w3[i];
+        }
+        out[0] = r0;
+        out[1] = r1;
+        out[2] = r2;
+        out[3] = r3;
+    }
+
+    void dot4NeonWidened(const float *a, const double *w, int ldw, int len, double *out)
+    {
+        float64x2_t s0 = vdupq_n_f64(0.0), s1 = vdupq_n_f64(0.0), s2 = vdupq_n_f64(0.0), s3 = vdupq_n_f64(0.0);
+        const double *w1 = w + ldw, *w2 = w1 + ldw, *w3 = w2 + ldw;
+        int i = 0;
+        for (; i + 2 <= len; i += 2)
+        {
+            float64x2_t x = vcvt_f64_f32(vld1_f32(a + i));
+            s0 = vfmaq_f64(s0, x, vld1q_f64(w + i));
+            s1 = vfmaq_f64(s1, x, vld1q_f64(w1 + i));
+            s2 = vfmaq_f64(s2, x, vld1q_f64(w2 + i));
+            s3 = vfmaq_f64(s3, x, vld1q_f64(w3 + i));
+        }
+        double r0 = vaddvq_f64(s0), r1 = vaddvq_f64(s1), r2 = vaddvq_f64(s2), r3 = vaddvq_f64(s3);
+        for (; i < len; ++i)
+        {
+            double x = a[i];
+            r0 += x * w[i];
+            r1 += x * w1[i];
+            r2 += x * w2[i];
+            r3 += x * w3[i];
+        }
+        out[0] = r0;
+        out[1] = r1;
+        out[2] = r2;
+        out[3] = r3;
+    }
+#endif
+
+    enum class Isa
+    {
+        Scalar,
+        Avx2,
+        Avx512,
+        Neon
+    };
+
+    Isa detectIsa()
+    {
+        const char *forced = getenv("LDLT_SIMD");
+        string requested = forced != nullptr ? forced : "";
+        if (requested == "scalar")
+        {
+            return Isa::Scalar;
+        }
+#if defined(LDLT_SIMD_X86)
+        __builtin_cpu_init();
+        bool avx512 = __builtin_cpu_supports("avx512f");
+        bool avx2 = __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+        if (avx512 && requested != "avx2")
+        {
+            return Isa::Avx512;
+        }
+        if (avx2)
+        {
+            return Isa::Avx2;
+        }
+#elif defined(LDLT_SIMD_NEON)
+        return Isa::Neon;
+#endif
+        return Isa::Scalar;
+    }
+
+    template <typename T, typename Acc>
+    SimdKernels<T, Acc> scalarTable()
+    {
+        return {dotScalar<T, Acc>, dotScaledScalar<T, Acc>, axpyScalar<T, Acc>, dot4Scalar<T, Acc>, "scalar"};
+    }
+}
+
+template <>
+const SimdKernels<float, float> &simdKernels<float, float>()
+{
+    static const SimdKernels<float, float> table = []
+    {
+        switch (detectIsa())
+        {
+#if defined(LDLT_SIMD_X86)
+        case Isa::Avx512:
+            return SimdKernels<float, float>{dotAvx512, dotScaledAvx512, axpyAvx512, dot4Avx512, "avx512"};
+        case Isa::Avx2:
+            return SimdKernels<float, float>{dotAvx2, dotScaledAvx2, axpyAvx2, dot4Avx2, "avx2"};
+#elif defined(LDLT_SIMD_NEON)
+        case Isa::Neon:
+            return SimdKernels<float, float>{dotNeon, dotScaledNeon, axpyNeon, dot4Neon, "neon"};
+#endif
+        default:
+            return scalarTable<float, float>();
+        }
+    }();
+    return table;
+}
+
+template <>
+const SimdKernels<double, double> &simdKernels<double, double>()
+{
+    static const SimdKernels<double, double> table = []
+    {
+        switch (detectIsa())
+        {
+#if defined(LDLT_SIMD_X86)
+        case Isa::Avx512:
+            return SimdKernels<double, double>{dotAvx512, dotScaledAvx512, axpyAvx512, dot4Avx512, "avx512"};
+        case Isa::Avx2:
+            return SimdKernels<double, double>{dotAvx2, dotScaledAvx2, axpyAvx2, dot4Avx2, "avx2"};
+#elif defined(LDLT_SIMD_NEON)
+        case Isa::Neon:
+            return SimdKernels<double, double>{dotNeon, dotScaledNeon, axpyNeon, dot4Neon, "neon"};
+#endif
+        default:
+            return scalarTable<double, double>();
+        }
+    }();
+    return table;
+}
+
+template <>
+const SimdKernels<float, double> &simdKernels<float, double>()
+{
+    static const SimdKernels<float, double> table = []
+    {
+        switch (detectIsa())
+        {
+#if defined(LDLT_SIMD_X86)
+        case Isa::Avx512:
+            return SimdKernels<float, double>{dotAvx512Widened, dotScaledAvx512Widened, axpyAvx512Widened, dot4Avx512Widened, "avx512"};
+        case Isa::Avx2:
+            return SimdKernels<float, double>{dotAvx2Widened, dotScaledAvx2Widened, axpyAvx2Widened, dot4Avx2Widened, "avx2"};
+#elif defined(LDLT_SIMD_NEON)
+        case Isa::Neon:
+            return SimdKernels<float, double>{dotNeonWidened, dotScaledNeonWidened, axpyNeonWidened, dot4NeonWidened, "neon"};
+#endif
+        default:
+            return scalarTable<float, double>();
+        }
+    }();
+    return table;
+}
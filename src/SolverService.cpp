@@ -0,0 +1,404 @@
+/**
+ * @file SolverService.cpp
+ * @brief Implementation of the factor cache and the job loop of the solver service.
+ */
+#include "SolverService.hpp"
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace
+{
+    /// Splits "command key=value ..." into the command and its keys.
+    string parseRequest(const string &line, map<string, string> &keys)
+    {
+        istringstream tokens(line);
+        string command, token;
+        tokens >> command;
+        while (tokens >> token)
+        {
+            size_t equals = token.find('=');
+            if (equals == string::npos || equals == 0)
+            {
+                throw invalid_argument("Expected key=value, got '" + token + "'");
+            }
+            keys[token.substr(0, equals)] = token.substr(equals + 1);
+        }
+        return command;
+    }
+
+    const string &requiredKey(const map<string, string> &keys, const string &key)
+    {
+        auto it = keys.find(key);
+        if (it == keys.end() || it->second.empty())
+        {
+            throw invalid_argument("Missing " + key + "=");
+        }
+        return it->second;
+    }
+
+    string optionalKey(const map<string, string> &keys, const string &key)
+    {
+        auto it = keys.find(key);
+        return it == keys.end() ? string() : it->second;
+    }
+
+    /// Writes all of text to fd, retrying short writes.
+    void sendAll(int fd, const string &text)
+    {
+        size_t sent = 0;
+        while (sent < text.size())
+        {
+            ssize_t written = ::send(fd, text.data() + sent, text.size() - sent, MSG_NOSIGNAL);
+            if (written < 0 && errno == EINTR)
+            {
+                continue;
+            }
+            if (written <= 0)
+            {
+                throw runtime_error(string("Could not write to the client: ") + strerror(errno));
+            }
+            sent += size_t(written);
+        }
+    }
+}
+
+template <typename StorageT, typename AccumT>
+size_t FactorCache<StorageT, AccumT>::bytesOf(const Factorization &factors)
+{
+    const size_t n = size_t(factors.size());
+    const size_t copies = factors.hasOriginal() ? 2 : 1;
+    return (copies * (n * factors.L().rowStride() + n) + n) * sizeof(StorageT);
+}
+
+template <typename StorageT, typename AccumT>
+auto FactorCache<StorageT, AccumT>::find(uint64_t key) -> shared_ptr<const Factorization>
+{
+    auto it = index.find(key);
+    if (it == index.end())
+    {
+        return nullptr;
+    }
+    order.splice(order.begin(), order, it->second);
+    return it->second->second;
+}
+
+template <typename StorageT, typename AccumT>
+void FactorCache<StorageT, AccumT>::insert(uint64_t key, shared_ptr<const Factorization> factors)
+{
+    const size_t bytes = bytesOf(*factors);
+    if (bytes > capacityBytes || index.count(key) != 0)
+    {
+        return;
+    }
+    while (usedBytes + bytes > capacityBytes)
+    {
+        usedBytes -= bytesOf(*order.back().second);
+        index.erase(order.back().first);
+        order.pop_back();
+        ++evicted;
+    }
+    order.emplace_front(key, std::move(factors));
+    index[key] = order.begin();
+    usedBytes += bytes;
+}
+
+template <typename StorageT, typename AccumT>
+SolverService<StorageT, AccumT>::SolverService(size_t cacheBytes, SolutionFormat solutionFormat, int threads)
+    : cache(cacheBytes), format(solutionFormat), numThreads(threads > 0 ? threads : omp_get_max_threads())
+{
+}
+
+template <typename StorageT, typename AccumT>
+string SolverService<StorageT, AccumT>::solve(const map<string, string> &keys)
+{
+    auto start = chrono::steady_clock::now();
+    const string band = optionalKey(keys, "band");
+    const string rhs = band.empty() ? requiredKey(keys, "f") : optionalKey(keys, "f");
+    const string output = requiredKey(keys, "x");
+    if (!band.empty() && rhs.empty() && !MappedBandFile(band, false).hasF())
+    {
+        throw invalid_argument(band + " has no F section; pass f=");
+    }
+
+    vector<string> matrixFiles;
+    if (band.empty())
+    {
+        matrixFiles = {requiredKey(keys, "input"), requiredKey(keys, "al"), requiredKey(keys, "d")};
+    }
+    else
+    {
+        matrixFiles = {band};
+    }
+
+    FileStamp stamp;
+    string filesKey;
+    for (const string &file : matrixFiles)
+    {
+        stamp.files.emplace_back(filesystem::file_size(file), filesystem::last_write_time(file));
+        filesKey += file + '\n';
+    }
+
+    // Unchanged files whose factors are still cached: no parse, no factorization.
+    // The factors must be the very ones made from these files, not a colliding matrix
+    // cached under the same hash after those were evicted.
+    shared_ptr<const Factorization> factors;
+    vector<floatingPointType> x;
+    auto known = knownFiles.find(filesKey);
+    if (known != knownFiles.end() && known->second.stamp == stamp)
+    {
+        factors = cache.find(known->second.hash);
+        if (factors != known->second.factors.lock())
+        {
+            factors = nullptr;
+        }
+        known->second.lastJob = counters.jobs;
+    }
+
+    bool parsed = factors == nullptr;
+    bool hit = true;
+    if (factors != nullptr)
+    {
+        ++counters.parseSkips;
+        x.resize(factors->size());
+        if (!rhs.empty())
+        {
+            parseVectorText(rhs, x.data(), int(x.size()));
+        }
+        else
+        {
+            MappedBandFile file(band, false);
+            const floatingPointType *f = file.F<floatingPointType>();
+            copy(f, f + x.size(), x.begin());
+        }
+    }
+    else
+    {
+        unique_ptr<Solver> system = band.empty()
+                                        ? make_unique<Solver>(matrixFiles[0], matrixFiles[1], matrixFiles[2], rhs, output)
+                                        : make_unique<Solver>(band, output);
+        if (!band.empty() && !rhs.empty())
+        {
+            vector<floatingPointType> f(system->getVectorF().size());
+            parseVectorText(rhs, f.data(), int(f.size()));
+            system->setVectorF(f.data());
+        }
+
+        // Another file with the same content is a hit here, after the parse; a
+        // different matrix with the same hash is a miss and is not cached.
+        uint64_t hash = system->contentHash();
+        factors = cache.find(hash);
+        x = system->getVectorF();
+        if (factors != nullptr && !system->matches(*factors))
+        {
+            factors = nullptr;
+        }
+        if (factors == nullptr)
+        {
+            hit = false;
+            system->setNumThreads(numThreads);
+            factors = system->factorize(true);
+            cache.insert(hash, factors);
+        }
+
+        // Forget the file sets whose factors the cache has dropped. Many file sets can
+        // share one cached matrix, so past MAX_KNOWN_FILE_SETS the least recently used
+        // set goes too; a daemon fed new files for every job stays bounded either way.
+        knownFiles.erase(filesKey);
+        for (auto it = knownFiles.begin(); it != knownFiles.end();)
+        {
+            it = it->second.factors.expired() ? knownFiles.erase(it) : next(it);
+        }
+        if (knownFiles.size() >= MAX_KNOWN_FILE_SETS)
+        {
+            knownFiles.erase(min_element(knownFiles.begin(), knownFiles.end(), [](const auto &a, const auto &b)
+                                         { return a.second.lastJob < b.second.lastJob; }));
+        }
+        knownFiles[filesKey] = KnownMatrix{stamp, hash, factors, counters.jobs};
+    }
+    if (hit)
+    {
+        ++counters.hits;
+    }
+    else
+    {
+        ++counters.misses;
+    }
+
+    factors->solve(x.data(), workspace);
+    if (format == SolutionFormat::Binary)
+    {
+        writeVectorFile(output, x.data(), x.size());
+    }
+    else
+    {
+        writeVectorText(output, x.data(), x.size(), precisionDigits<floatingPointType>);
+    }
+
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    ostringstream response;
+    response << "ok id=" << optionalKey(keys, "id") << " cache=" << (hit ? "hit" : "miss") << " parsed=" << (parsed ? 1 : 0)
+             << " n=" << factors->size() << " m=" << factors->bandwidth() << " seconds=" << setprecision(6) << seconds;
+    return response.str();
+}
+
+template <typename StorageT, typename AccumT>
+string SolverService<StorageT, AccumT>::handle(const string &line, bool &quit)
+{
+    map<string, string> keys;
+    bool job = false;
+    try
+    {
+        string command = parseRequest(line, keys);
+        if (command.empty())
+        {
+            return "";
+        }
+        if (command == "quit")
+        {
+            quit = true;
+            return statsLine();
+        }
+        if (command == "stats")
+        {
+            return statsLine();
+        }
+        if (command != "solve")
+        {
+            throw invalid_argument("Unknown request '" + command + "' (expected solve, stats or quit)");
+        }
+
+        ++counters.jobs;
+        job = true;
+        return solve(keys);
+    }
+    catch (const exception &e)
+    {
+        if (job)
+        {
+            ++counters.failed;
+        }
+        return "error id=" + optionalKey(keys, "id") + ' ' + e.what();
+    }
+}
+
+template <typename StorageT, typename AccumT>
+void SolverService<StorageT, AccumT>::serve(istream &in, ostream &out)
+{
+    bool quit = false;
+    string line;
+    while (!quit && getline(in, line))
+    {
+        string response = handle(line, quit);
+        if (!response.empty())
+        {
+            out << response << endl;
+        }
+    }
+}
+
+template <typename StorageT, typename AccumT>
+void SolverService<StorageT, AccumT>::serveSocket(const string &socketPath)
+{
+    sockaddr_un address = {};
+    if (socketPath.size() >= sizeof(address.sun_path))
+    {
+        throw invalid_argument("Socket path is too long: " + socketPath);
+    }
+    address.sun_family = AF_UNIX;
+    copy(socketPath.begin(), socketPath.end(), address.sun_path);
+
+    int listener = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listener < 0)
+    {
+        throw runtime_error(string("Could not create a socket: ") + strerror(errno));
+    }
+    ::unlink(socketPath.c_str());
+    if (::bind(listener, reinterpret_cast<const sockaddr *>(&address), sizeof(address)) < 0 || ::listen(listener, 16) < 0)
+    {
+        string reason = strerror(errno);
+        ::close(listener);
+        throw runtime_error("Could not listen on " + socketPath + ": " + reason);
+    }
+
+    bool quit = false;
+    while (!quit)
+    {
+        int client = ::accept(listener, nullptr, nullptr);
+        if (client < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            break;
+        }
+
+        // Requests may arrive split or batched; answer every complete line as it comes in.
+        string pending;
+        char buffer[4096];
+        try
+        {
+            while (!quit)
+            {
+                ssize_t received = ::recv(client, buffer, sizeof(buffer), 0);
+                if (received < 0 && errno == EINTR)
+                {
+                    continue;
+                }
+                if (received <= 0)
+                {
+                    break;
+                }
+                pending.append(buffer, size_t(received));
+
+                size_t lineEnd;
+                while (!quit && (lineEnd = pending.find('\n')) != string::npos)
+                {
+                    string response = handle(pending.substr(0, lineEnd), quit);
+                    pending.erase(0, lineEnd + 1);
+                    if (!response.empty())
+                    {
+                        sendAll(client, response + '\n');
+                    }
+                }
+            }
+        }
+        catch (const exception &)
+        {
+            // The client went away; keep serving the next one.
+        }
+        ::close(client);
+    }
+    ::close(listener);
+    ::unlink(socketPath.c_str());
+}
+
+template <typename StorageT, typename AccumT>
+ServiceStats SolverService<StorageT, AccumT>::stats() const
+{
+    ServiceStats current = counters;
+    current.evictions = cache.evictions();
+    return current;
+}
+
+template <typename StorageT, typename AccumT>
+string SolverService<StorageT, AccumT>::statsLine() const
+{
+    ServiceStats current = stats();
+    ostringstream line;
+    line << "stats jobs=" << current.jobs << " failed=" << current.failed << " hits=" << current.hits
+         << " misses=" << current.misses << " hit_rate=" << fixed << setprecision(3) << current.hitRate()
+         << " parse_skips=" << current.parseSkips << " evictions=" << current.evictions
+         << " entries=" << cache.entries() << " cache_bytes=" << cache.bytes();
+    return line.str();
+}
+
+template class FactorCache<float, float>;
+template class FactorCache<double, double>;
+template class FactorCache<float, double>;
+
+template class SolverService<float, float>;
+template class SolverService<double, double>;
+template class SolverService<float, double>;
@@ -0,0 +1,364 @@
+/**
+ * @file SparseReordering.cpp
+ * @brief Implementation of the Reverse Cuthill-McKee front-end of the band solver.
+ */
+#include "SparseReordering.hpp"
+
+namespace
+{
+    void checkPattern(int n, const vector<int> &rowStart, const vector<int> &columns)
+    {
+        if (n < 0 || rowStart.size() != size_t(n) + 1 || rowStart[0] != 0 || size_t(rowStart[n]) != columns.size())
+        {
+            throw invalid_argument("Invalid CSR row offsets");
+        }
+    }
+
+    /// Symmetrized adjacency lists without self loops and duplicates, in CSR form.
+    void symmetricAdjacency(int n, const vector<int> &rowStart, const vector<int> &columns,
+                            vector<int> &start, vector<int> &adjacent)
+    {
+        start.assign(n + 1, 0);
+        for (int i = 0; i < n; ++i)
+        {
+            for (int k = rowStart[i]; k < rowStart[i + 1]; ++k)
+            {
+                int j = columns[k];
+                if (j != i)
+                {
+                    ++start[i + 1];
+                    ++start[j + 1];
+                }
+            }
+        }
+        partial_sum(start.begin(), start.end(), start.begin());
+
+        adjacent.resize(start[n]);
+        vector<int> next(start.begin(), start.end() - 1);
+        for (int i = 0; i < n; ++i)
+        {
+            for (int k = rowStart[i]; k < rowStart[i + 1]; ++k)
+            {
+                int j = columns[k];
+                if (j != i)
+                {
+                    adjacent[next[i]++] = j;
+                    adjacent[next[j]++] = i;
+                }
+            }
+        }
+
+        // Sort every list and squeeze out duplicates in place.
+        int kept = 0;
+        for (int i = 0; i < n; ++i)
+        {
+            auto first = adjacent.begin() + start[i];
+            auto last = adjacent.begin() + start[i + 1];
+            sort(first, last);
+            last = unique(first, last);
+            start[i] = kept;
+            kept = int(copy(first, last, adjacent.begin() + kept) - adjacent.begin());
+        }
+        start[n] = kept;
+        adjacent.resize(kept);
+    }
+
+    /**
+     * Breadth-first search from root over the unvisited vertices. Fills queue with
+     * the vertices in visiting order and returns the index in queue where the last
+     * level starts. stamp/mark avoid clearing a vector of length n per search.
+     */
+    size_t levelStructure(int root, const vector<int> &start, const vector<int> &adjacent,
+                          const vector<char> &visited, vector<int> &mark, int stamp, vector<int> &queue, int &depth)
+    {
+        queue.clear();
+        queue.push_back(root);
+        mark[root] = stamp;
+        size_t levelBegin = 0;
+        depth = 0;
+
+        while (true)
+        {
+            size_t levelEnd = queue.size();
+            for (size_t q = levelBegin; q < levelEnd; ++q)
+            {
+                int v = queue[q];
+                for (int k = start[v]; k < start[v + 1]; ++k)
+                {
+                    int u = adjacent[k];
+                    if (!visited[u] && mark[u] != stamp)
+                    {
+                        mark[u] = stamp;
+                        queue.push_back(u);
+                    }
+                }
+            }
+            if (queue.size() == levelEnd)
+            {
+                return levelBegin;
+            }
+            levelBegin = levelEnd;
+            ++depth;
+        }
+    }
+}
+
+vector<int> reverseCuthillMcKee(int n, const vector<int> &rowStart, const vector<int> &columns)
+{
+    checkPattern(n, rowStart, columns);
+
+    vector<int> start, adjacent;
+    symmetricAdjacency(n, rowStart, columns, start, adjacent);
+    auto degree = [&](int v) { return start[v + 1] - start[v]; };
+
+    vector<int> order;
+    order.reserve(n);
+    vector<char> visited(n, 0);
+    vector<int> mark(n, -1), queue, neighbours;
+    int stamp = 0;
+
+    for (int seed = 0; seed < n; ++seed)
+    {
+        if (visited[seed])
+        {
+            continue;
+        }
+
+        // Pseudo-peripheral root: restart from a last-level vertex of least degree
+        // for as long as the level structure gets deeper.
+        int root = seed, depth = 0;
+        size_t lastLevel = levelStructure(root, start, adjacent, visited, mark, stamp++, queue, depth);
+        while (true)
+        {
+            int candidate = queue[lastLevel];
+            for (size_t q = lastLevel; q < queue.size(); ++q)
+            {
+                if (degree(queue[q]) < degree(candidate))
+                {
+                    candidate = queue[q];
+                }
+            }
+            int candidateDepth = 0;
+            size_t candidateLast = levelStructure(candidate, start, adjacent, visited, mark, stamp++, queue, candidateDepth);
+            if (candidateDepth <= depth)
+            {
+                break;
+            }
+            root = candidate;
+            depth = candidateDepth;
+            lastLevel = candidateLast;
+        }
+
+        // Cuthill-McKee: breadth-first, neighbours by increasing degree.
+        size_t head = order.size();
+        order.push_back(root);
+        visited[root] = 1;
+        while (head < order.size())
+        {
+            int v = order[head++];
+            neighbours.clear();
+            for (int k = start[v]; k < start[v + 1]; ++k)
+            {
+                int u = adjacent[k];
+                if (!visited[u])
+                {
+                    visited[u] = 1;
+                    neighbours.push_back(u);
+                }
+            }
+            sort(neighbours.begin(), neighbours.end(), [&](int a, int b)
+                 { return degree(a) != degree(b) ? degree(a) < degree(b) : a < b; });
+            order.insert(order.end(), neighbours.begin(), neighbours.end());
+        }
+    }
+
+    reverse(order.begin(), order.end());
+    return order;
+}
+
+int patternBandwidth(int n, const vector<int> &rowStart, const vector<int> &columns, const vector<int> &position)
+{
+    checkPattern(n, rowStart, columns);
+
+    int bandwidth = 0;
+    for (int i = 0; i < n; ++i)
+    {
+        int pi = position.empty() ? i : position[i];
+        for (int k = rowStart[i]; k < rowStart[i + 1]; ++k)
+        {
+            int pj = position.empty() ? columns[k] : position[columns[k]];
+            bandwidth = max(bandwidth, abs(pi - pj));
+        }
+    }
+    return bandwidth;
+}
+
+template <typename T>
+SparseMatrix<T> SparseMatrix<T>::fromCoo(int size, const vector<int> &rows, const vector<int> &cols, const vector<T> &entries)
+{
+    if (size < 0 || rows.size() != cols.size() || rows.size() != entries.size())
+    {
+        throw invalid_argument("COO arrays must have the same length");
+    }
+
+    SparseMatrix matrix;
+    matrix.n = size;
+    matrix.rowStart.assign(size + 1, 0);
+    for (size_t k = 0; k < rows.size(); ++k)
+    {
+        if (rows[k] < 0 || rows[k] >= size || cols[k] < 0 || cols[k] >= size)
+        {
+            throw invalid_argument("COO entry " + to_string(k) + " is outside the matrix");
+        }
+        ++matrix.rowStart[rows[k] + 1];
+    }
+    partial_sum(matrix.rowStart.begin(), matrix.rowStart.end(), matrix.rowStart.begin());
+
+    matrix.columns.resize(rows.size());
+    matrix.values.resize(rows.size());
+    vector<int> next(matrix.rowStart.begin(), matrix.rowStart.end() - 1);
+    for (size_t k = 0; k < rows.size(); ++k)
+    {
+        int position = next[rows[k]]++;
+        matrix.columns[position] = cols[k];
+        matrix.values[position] = entries[k];
+    }
+    return matrix;
+}
+
+template <typename T>
+SparseMatrix<T> SparseMatrix<T>::loadCoo(const string &filePath)
+{
+    TextRowReader reader(filePath);
+    double header[2];
+    reader.readRow(header, 2);
+    if (header[0] < 0 || header[1] < 0 || header[0] != floor(header[0]) || header[1] != floor(header[1]))
+    {
+        throw runtime_error(filePath + ": the first line must hold n and nnz");
+    }
+
+    const int size = int(header[0]);
+    const size_t nnz = size_t(header[1]);
+    vector<int> rows(nnz), cols(nnz);
+    vector<T> entries(nnz);
+    for (size_t k = 0; k < nnz; ++k)
+    {
+        double triplet[3];
+        reader.readRow(triplet, 3);
+        if (triplet[0] != floor(triplet[0]) || triplet[1] != floor(triplet[1]))
+        {
+            throw runtime_error(filePath + ": entry " + to_string(k) + " has a non-integer index");
+        }
+        rows[k] = int(triplet[0]);
+        cols[k] = int(triplet[1]);
+        entries[k] = T(triplet[2]);
+    }
+    return fromCoo(size, rows, cols, entries);
+}
+
+template <typename StorageT, typename AccumT>
+ReorderedBandSolver<StorageT, AccumT>::ReorderedBandSolver(const SparseMatrix<floatingPointType> &A, bool reorder,
+                                                           const string &outputFilePath)
+    : bandwidthBefore(patternBandwidth(A.n, A.rowStart, A.columns))
+{
+    const int n = A.n;
+    if (reorder)
+    {
+        order = reverseCuthillMcKee(n, A.rowStart, A.columns);
+    }
+    else
+    {
+        order.resize(n);
+        iota(order.begin(), order.end(), 0);
+    }
+
+    vector<int> position(n);
+    for (int k = 0; k < n; ++k)
+    {
+        position[order[k]] = k;
+    }
+    bandwidthAfter = patternBandwidth(n, A.rowStart, A.columns, position);
+    const int m = bandwidthAfter;
+
+    // Lower-triangle entries regrouped by their row in the new numbering.
+    vector<int> bucketStart(n + 1, 0);
+    for (int i = 0; i < n; ++i)
+    {
+        for (int k = A.rowStart[i]; k < A.rowStart[i + 1]; ++k)
+        {
+            if (A.columns[k] <= i)
+            {
+                ++bucketStart[max(position[i], position[A.columns[k]]) + 1];
+            }
+        }
+    }
+    partial_sum(bucketStart.begin(), bucketStart.end(), bucketStart.begin());
+
+    vector<pair<int, floatingPointType>> bucket(bucketStart[n]);
+    vector<int> next(bucketStart.begin(), bucketStart.end() - 1);
+    for (int i = 0; i < n; ++i)
+    {
+        for (int k = A.rowStart[i]; k < A.rowStart[i + 1]; ++k)
+        {
+            int j = A.columns[k];
+            if (j <= i)
+            {
+                int p = max(position[i], position[j]);
+                bucket[next[p]++] = {min(position[i], position[j]), A.values[k]};
+            }
+        }
+    }
+
+    system = make_unique<Solver>(n, m, outputFilePath);
+    vector<floatingPointType> row(m);
+    for (int p = 0; p < n; ++p)
+    {
+        fill(row.begin(), row.end(), floatingPointType(0));
+        floatingPointType diagonal = 0;
+        for (int b = bucketStart[p]; b < bucketStart[p + 1]; ++b)
+        {
+            auto [q, value] = bucket[b];
+            if (q == p)
+            {
+                diagonal += value;
+            }
+            else
+            {
+                row[m - p + q] += value;
+            }
+        }
+        system->setRow(p, row.data(), diagonal);
+    }
+    permuted.resize(n);
+}
+
+template <typename StorageT, typename AccumT>
+void ReorderedBandSolver<StorageT, AccumT>::factor()
+{
+    system->performLDLtDecomposition();
+}
+
+template <typename StorageT, typename AccumT>
+void ReorderedBandSolver<StorageT, AccumT>::solve(const floatingPointType *f, floatingPointType *x)
+{
+    const int n = size();
+    for (int k = 0; k < n; ++k)
+    {
+        permuted[k] = f[order[k]];
+    }
+    system->setVectorF(permuted.data());
+    system->solveLinearSystem();
+
+    const vector<floatingPointType> &y = system->getVectorF();
+    for (int k = 0; k < n; ++k)
+    {
+        x[order[k]] = y[k];
+    }
+}
+
+template struct SparseMatrix<float>;
+template struct SparseMatrix<double>;
+
+template class ReorderedBandSolver<float, float>;
+template class ReorderedBandSolver<double, double>;
+template class ReorderedBandSolver<float, double>;
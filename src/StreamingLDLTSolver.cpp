@@ -0,0 +1,218 @@
+/**
+ * @file StreamingLDLTSolver.cpp
+ * @brief Implementation of the two-pass out-of-core band LDLT solver.
+ */
+#include "StreamingLDLTSolver.hpp"
+
+namespace
+{
+    constexpr char FACTOR_FILE_MAGIC[8] = {'L', 'D', 'L', 'T', 'F', 'A', 'C', 'T'};
+    constexpr uint32_t FACTOR_FILE_VERSION = 1;
+}
+
+template <typename StorageT, typename AccumT>
+StreamingLDLTSolver<StorageT, AccumT>::StreamingLDLTSolver(const string &inputFilePath,
+                                                           const string &alFilePath,
+                                                           const string &dFilePath,
+                                                           const string &fFilePath,
+                                                           const string &factorFile,
+                                                           const string &outputFilePath,
+                                                           size_t blockBytes)
+    : AlFilePath(alFilePath), DFilePath(dFilePath), FFilePath(fFilePath),
+      factorFilePath(factorFile), solveFilePath(outputFilePath)
+{
+    parseSizeText(inputFilePath, n, m);
+    recordsPerBlock = max<size_t>(1, blockBytes / (size_t(m + 2) * sizeof(floatingPointType)));
+}
+
+template <typename StorageT, typename AccumT>
+size_t StreamingLDLTSolver<StorageT, AccumT>::workingSetBytes() const
+{
+    const size_t slots = size_t(m) + 1;
+    const size_t window = slots * (size_t(m) + 2) * sizeof(floatingPointType) + slots * sizeof(sum);
+    const size_t buffers = recordsPerBlock * (size_t(m) + 3) * sizeof(floatingPointType);
+    return window + buffers;
+}
+
+template <typename StorageT, typename AccumT>
+void StreamingLDLTSolver<StorageT, AccumT>::factorAndForward()
+{
+    TextRowReader al(AlFilePath), d(DFilePath), f(FFilePath);
+
+    ofstream out(factorFilePath, ios::binary | ios::trunc);
+    if (!out.is_open())
+    {
+        throw runtime_error("Could not open file: " + factorFilePath);
+    }
+
+    StreamingFactorHeader header = {};
+    copy(begin(FACTOR_FILE_MAGIC), end(FACTOR_FILE_MAGIC), header.magic);
+    header.version = FACTOR_FILE_VERSION;
+    header.scalarSize = sizeof(floatingPointType);
+    header.n = uint64_t(n);
+    header.m = uint64_t(m);
+    out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+
+    // Row j of the window lives in slot j % (m + 1); the slot of row j - m - 1 is free again.
+    const int slots = m + 1;
+    const size_t record = size_t(m) + 2;
+    vector<floatingPointType> windowL(size_t(slots) * m);
+    vector<floatingPointType> windowD(slots), windowY(slots);
+    vector<floatingPointType> block(recordsPerBlock * record);
+    size_t pending = 0;
+
+    for (int j = 0; j < n; ++j)
+    {
+        floatingPointType *row = windowL.data() + size_t(j % slots) * m;
+        if (m > 0)
+        {
+            al.readRow(row, m);
+        }
+        floatingPointType dj, fj;
+        d.readRow(&dj, 1);
+        f.readRow(&fj, 1);
+
+        int baseIndexJ = m - j;
+        int kBegin = max(0, j - m);
+
+        for (int i = kBegin; i < j; ++i)
+        {
+            const floatingPointType *rowI = windowL.data() + size_t(i % slots) * m;
+            int baseIndexI = m - i;
+            sum sumL = 0;
+            for (int k = kBegin; k < i; ++k)
+            {
+                sumL += sum(row[baseIndexJ + k]) * rowI[baseIndexI + k] * windowD[k % slots];
+            }
+            int indexJI = baseIndexJ + i;
+            row[indexJI] = floatingPointType((row[indexJI] - sumL) / windowD[i % slots]);
+        }
+
+        sum sumD = 0, sumF = 0;
+        for (int k = kBegin; k < j; ++k)
+        {
+            int indexJK = baseIndexJ + k;
+            sumD += sum(row[indexJK]) * row[indexJK] * windowD[k % slots];
+            sumF += sum(row[indexJK]) * windowY[k % slots];
+        }
+        dj = floatingPointType(dj - sumD);
+        floatingPointType yj = floatingPointType(fj - sumF);
+        windowD[j % slots] = dj;
+        windowY[j % slots] = yj;
+
+        floatingPointType *target = block.data() + pending * record;
+        copy(row, row + m, target);
+        target[m] = dj;
+        target[m + 1] = yj / dj;
+
+        if (++pending == recordsPerBlock)
+        {
+            out.write(reinterpret_cast<const char *>(block.data()), streamsize(pending * record * sizeof(floatingPointType)));
+            pending = 0;
+        }
+    }
+
+    out.write(reinterpret_cast<const char *>(block.data()), streamsize(pending * record * sizeof(floatingPointType)));
+    if (!out)
+    {
+        throw runtime_error("Could not write file: " + factorFilePath);
+    }
+    out.close();
+}
+
+template <typename StorageT, typename AccumT>
+void StreamingLDLTSolver<StorageT, AccumT>::solveBackward()
+{
+    ifstream in(factorFilePath, ios::binary);
+    if (!in.is_open())
+    {
+        throw runtime_error("Could not open file: " + factorFilePath);
+    }
+
+    StreamingFactorHeader header = {};
+    in.read(reinterpret_cast<char *>(&header), sizeof(header));
+    if (!in || !equal(begin(FACTOR_FILE_MAGIC), end(FACTOR_FILE_MAGIC), header.magic) ||
+        header.version != FACTOR_FILE_VERSION || header.scalarSize != sizeof(floatingPointType) ||
+        header.n != uint64_t(n) || header.m != uint64_t(m))
+    {
+        throw runtime_error("Factor file does not match the system: " + factorFilePath);
+    }
+
+    // The solution is produced from the last row to the first, so it goes to a
+    // binary scratch file first and is written out as text in a final forward pass.
+    const string scratchPath = factorFilePath + ".x";
+    fstream scratch(scratchPath, ios::binary | ios::in | ios::out | ios::trunc);
+    if (!scratch.is_open())
+    {
+        throw runtime_error("Could not open file: " + scratchPath);
+    }
+
+    const int slots = m + 1;
+    const size_t record = size_t(m) + 2;
+    vector<sum> pendingSums(slots, 0.0);
+    vector<floatingPointType> block(recordsPerBlock * record);
+    vector<floatingPointType> solution(recordsPerBlock);
+
+    for (int blockEnd = n; blockEnd > 0;)
+    {
+        int blockStart = int(max<long long>(0, (long long)blockEnd - (long long)recordsPerBlock));
+        size_t count = size_t(blockEnd - blockStart);
+
+        in.seekg(streamoff(sizeof(header) + size_t(blockStart) * record * sizeof(floatingPointType)));
+        in.read(reinterpret_cast<char *>(block.data()), streamsize(count * record * sizeof(floatingPointType)));
+        if (!in)
+        {
+            throw runtime_error("Unexpected end of factor file: " + factorFilePath);
+        }
+
+        for (int j = blockEnd - 1; j >= blockStart; --j)
+        {
+            const floatingPointType *row = block.data() + size_t(j - blockStart) * record;
+            floatingPointType xj = floatingPointType(row[m + 1] - pendingSums[j % slots]);
+            pendingSums[j % slots] = 0;
+
+            int baseIndexJ = m - j;
+            for (int k = max(0, j - m); k < j; ++k)
+            {
+                pendingSums[k % slots] += sum(row[baseIndexJ + k]) * xj;
+            }
+            solution[j - blockStart] = xj;
+        }
+
+        scratch.seekp(streamoff(size_t(blockStart) * sizeof(floatingPointType)));
+        scratch.write(reinterpret_cast<const char *>(solution.data()), streamsize(count * sizeof(floatingPointType)));
+        blockEnd = blockStart;
+    }
+
+    TextRowWriter outFile(solveFilePath, precisionDigits<floatingPointType>);
+
+    scratch.seekg(0);
+    for (int start = 0; start < n; start += int(recordsPerBlock))
+    {
+        size_t count = min(recordsPerBlock, size_t(n - start));
+        scratch.read(reinterpret_cast<char *>(solution.data()), streamsize(count * sizeof(floatingPointType)));
+        for (size_t i = 0; i < count; ++i)
+        {
+            outFile.writeValue(solution[i]);
+        }
+    }
+    if (!scratch)
+    {
+        throw runtime_error("Could not read file: " + scratchPath);
+    }
+
+    scratch.close();
+    remove(scratchPath.c_str());
+    outFile.close();
+}
+
+template <typename StorageT, typename AccumT>
+void StreamingLDLTSolver<StorageT, AccumT>::solve()
+{
+    factorAndForward();
+    solveBackward();
+}
+
+template class StreamingLDLTSolver<float, float>;
+template class StreamingLDLTSolver<double, double>;
+template class StreamingLDLTSolver<float, double>;
@@ -0,0 +1,518 @@
+/**
+ * @file TextParser.cpp
+ * @brief Implementation of the chunked, multi-threaded from_chars text parser.
+ */
+#include "TextParser.hpp"
+
+#include <omp.h>
+
+namespace
+{
+    /// First problem found in a chunk, with 1-based line and column.
+    struct ParseError
+    {
+        size_t line = 0;
+        size_t column = 0;
+        string message;
+    };
+
+    bool isBlank(char c)
+    {
+        return c == ' ' || c == '\t' || c == '\r' || c == '\v' || c == '\f';
+    }
+
+    const char *skipBlanks(const char *p, const char *end)
+    {
+        while (p < end && isBlank(*p))
+        {
+            ++p;
+        }
+        return p;
+    }
+
+    const char *lineEnd(const char *p, const char *end)
+    {
+        const void *newline = memchr(p, '\n', size_t(end - p));
+        return newline != nullptr ? static_cast<const char *>(newline) : end;
+    }
+
+    template <typename T>
+    const char *parseValue(const char *p, const char *end, T &value)
+    {
+        if (p < end && *p == '+')
+        {
+            ++p;
+        }
+        from_chars_result result = from_chars(p, end, value);
+        if (result.ec != errc() || (result.ptr < end && !isBlank(*result.ptr) && *result.ptr != '\n'))
+        {
+            return nullptr;
+        }
+        return result.ptr;
+    }
+
+    /// A block of whole lines handled by one thread.
+    struct Chunk
+    {
+        const char *begin = nullptr;
+        const char *end = nullptr;
+        size_t firstLine = 0; ///< 0-based line number of the first line of the chunk
+        size_t firstRow = 0;  ///< Index of the first row stored in the chunk
+        size_t lines = 0;     ///< Number of lines in the chunk
+        size_t rows = 0;      ///< Number of non-blank lines in the chunk
+    };
+
+    /// Bytes the in-core parser reads at a time; each block is split among the threads.
+    constexpr size_t PARSE_BLOCK = size_t(1) << 24;
+
+    /**
+     * Splits [begin, end), which holds whole lines, into one chunk per thread and
+     * counts the lines and rows of every chunk. firstLine and firstRow continue
+     * from the lines and rows of the earlier blocks.
+     */
+    vector<Chunk> splitIntoChunks(const char *begin, const char *end, int threads, size_t firstLine, size_t firstRow)
+    {
+        const size_t size = size_t(end - begin);
+        size_t parts = size_t(max(1, threads));
+        parts = max<size_t>(1, min(parts, size / (1 << 16)));
+
+        vector<Chunk> chunks(parts);
+        const char *p = begin;
+        for (size_t c = 0; c < parts; ++c)
+        {
+            chunks[c].begin = p;
+            if (c + 1 == parts)
+            {
+                p = end;
+            }
+            else
+            {
+                const char *target = max(p, begin + size / parts * (c + 1));
+                p = lineEnd(target, end);
+                p = p < end ? p + 1 : end;
+            }
+            chunks[c].end = p;
+        }
+
+#pragma omp parallel for schedule(static, 1) num_threads(int(parts))
+        for (size_t c = 0; c < parts; ++c)
+        {
+            const char *q = chunks[c].begin;
+            while (q < chunks[c].end)
+            {
+                const char *eol = lineEnd(q, chunks[c].end);
+                ++chunks[c].lines;
+                if (skipBlanks(q, eol) < eol)
+                {
+                    ++chunks[c].rows;
+                }
+                q = eol + 1;
+            }
+        }
+
+        chunks[0].firstLine = firstLine;
+        chunks[0].firstRow = firstRow;
+        for (size_t c = 1; c < parts; ++c)
+        {
+            chunks[c].firstLine = chunks[c - 1].firstLine + chunks[c - 1].lines;
+            chunks[c].firstRow = chunks[c - 1].firstRow + chunks[c - 1].rows;
+        }
+        return chunks;
+    }
+
+    /**
+     * Parses the rows of the chunks of one block; rows from n on are skipped.
+     *
+     * @throws runtime_error with the position of the first problem in the block
+     */
+    template <typename T, typename RowPointer>
+    void parseChunks(const string &filePath, const vector<Chunk> &chunks, size_t n, int width, RowPointer &rowPointer)
+    {
+        vector<ParseError> errors(chunks.size());
+
+#pragma omp parallel for schedule(static, 1) num_threads(int(chunks.size()))
+        for (size_t c = 0; c < chunks.size(); ++c)
+        {
+            const Chunk &chunk = chunks[c];
+            size_t line = chunk.firstLine;
+            size_t row = chunk.firstRow;
+            const char *p = chunk.begin;
+
+            while (p < chunk.end && row < n)
+            {
+                const char *eol = lineEnd(p, chunk.end);
+                ++line;
+                const char *q = skipBlanks(p, eol);
+                if (q < eol)
+                {
+                    T *destination = rowPointer(row);
+                    int count = 0;
+                    while (q < eol)
+                    {
+                        if (count == width)
+                        {
+                            errors[c] = {line, size_t(q - p) + 1,
+                                         "expected " + to_string(width) + " values, found more"};
+                            break;
+                        }
+                        const char *next = parseValue(q, eol, destination[count]);
+                        if (next == nullptr)
+                        {
+                            errors[c] = {line, size_t(q - p) + 1, "malformed number"};
+                            break;
+                        }
+                        ++count;
+                        q = skipBlanks(next, eol);
+                    }
+                    if (errors[c].line == 0 && count < width)
+                    {
+                        errors[c] = {line, size_t(eol - p) + 1,
+                                     "expected " + to_string(width) + " values, found " + to_string(count)};
+                    }
+                    if (errors[c].line != 0)
+                    {
+                        break;
+                    }
+                    ++row;
+                }
+                p = eol + 1;
+            }
+        }
+
+        for (const ParseError &error : errors)
+        {
+            if (error.line != 0)
+            {
+                throw runtime_error(filePath + ":" + to_string(error.line) + ":" + to_string(error.column) +
+                                    ": " + error.message);
+            }
+        }
+    }
+
+    /**
+     * Parses rows [0, n) of width values each. rowPointer(i) returns the destination
+     * of row i. Lines after row n - 1 are not read.
+     *
+     * The file is read PARSE_BLOCK bytes at a time. A block is parsed up to its last
+     * newline and the unfinished line is carried into the next block, so memory use
+     * does not grow with the file.
+     */
+    template <typename T, typename RowPointer>
+    void parseRows(const string &filePath, size_t n, int width, int threads, RowPointer rowPointer)
+    {
+        ifstream file(filePath, ios::binary);
+        if (!file.is_open())
+        {
+            throw runtime_error("Could not open file: " + filePath);
+        }
+
+        const int parts = threads > 0 ? threads : omp_get_max_threads();
+        vector<char> buffer(PARSE_BLOCK);
+        size_t carried = 0; // Bytes of an unfinished line kept from the previous block
+        size_t lines = 0;   // Lines in the blocks parsed so far
+        size_t rows = 0;    // Rows in the blocks parsed so far
+        bool atEnd = false;
+
+        while (rows < n && !atEnd)
+        {
+            if (carried == buffer.size())
+            {
+                // One line is longer than the whole buffer.
+                buffer.resize(buffer.size() * 2);
+            }
+            file.read(buffer.data() + carried, streamsize(buffer.size() - carried));
+            if (file.bad())
+            {
+                throw runtime_error("Could not read file: " + filePath);
+            }
+            const size_t filled = carried + size_t(file.gcount());
+            atEnd = file.eof();
+
+            const char *begin = buffer.data();
+            const char *end = begin + filled;
+            if (!atEnd)
+            {
+                auto lastNewline = find(make_reverse_iterator(end), make_reverse_iterator(begin), '\n');
+                if (lastNewline == make_reverse_iterator(begin))
+                {
+                    carried = filled;
+                    continue;
+                }
+                end = lastNewline.base();
+            }
+
+            vector<Chunk> chunks = splitIntoChunks(begin, end, parts, lines, rows);
+            parseChunks<T>(filePath, chunks, n, width, rowPointer);
+            lines = chunks.back().firstLine + chunks.back().lines;
+            rows = chunks.back().firstRow + chunks.back().rows;
+
+            carried = size_t(buffer.data() + filled - end);
+            memmove(buffer.data(), end, carried);
+        }
+
+        if (rows < n)
+        {
+            throw runtime_error(filePath + ":" + to_string(lines) + ": expected " + to_string(n) + " rows, found " +
+                                to_string(rows));
+        }
+    }
+}
+
+string readTextFile(const string &filePath)
+{
+    ifstream file(filePath, ios::binary);
+    if (!file.is_open())
+    {
+        throw runtime_error("Could not open file: " + filePath);
+    }
+
+    file.seekg(0, ios::end);
+    streamoff size = file.tellg();
+    file.seekg(0, ios::beg);
+
+    string text(size_t(max<streamoff>(size, 0)), '\0');
+    if (!file.read(text.data(), streamsize(text.size())))
+    {
+        // Also a file that shrank between tellg() and the read.
+        throw runtime_error("Could not read file: " + filePath);
+    }
+    return text;
+}
+
+void parseSizeText(const string &filePath, int &n, int &m)
+{
+    const string text = readTextFile(filePath);
+    const char *end = text.data() + text.size();
+    const char *p = text.data();
+    int values[2] = {0, 0};
+
+    for (int &value : values)
+    {
+        while (p < end && (isBlank(*p) || *p == '\n'))
+        {
+            ++p;
+        }
+        from_chars_result result = from_chars(p, end, value);
+        if (result.ec != errc() || value < 0)
+        {
+            size_t line = size_t(count(text.data(), p, '\n')) + 1;
+            const char *lineStart = p;
+            while (lineStart > text.data() && lineStart[-1] != '\n')
+            {
+                --lineStart;
+            }
+            throw runtime_error(filePath + ":" + to_string(line) + ":" + to_string(p - lineStart + 1) +
+                                ": expected a non-negative integer");
+        }
+        p = result.ptr;
+    }
+
+    n = values[0];
+    m = values[1];
+}
+
+string parsePrecisionText(const string &filePath)
+{
+    const string text = readTextFile(filePath);
+    const char *end = text.data() + text.size();
+    const char *p = text.data();
+
+    for (int token = 0; token < 3; ++token)
+    {
+        while (p < end && (isBlank(*p) || *p == '\n'))
+        {
+            ++p;
+        }
+        const char *start = p;
+        while (p < end && !isBlank(*p) && *p != '\n')
+        {
+            ++p;
+        }
+        if (token == 2)
+        {
+            return string(start, p);
+        }
+    }
+    return string();
+}
+
+template <typename T>
+void parseBandText(const string &filePath, BandMatrix<T> &matrix, int threads)
+{
+    if (matrix.bandwidth() == 0)
+    {
+        return;
+    }
+    parseRows<T>(filePath, size_t(matrix.rows()), matrix.bandwidth(), threads,
+                 [&matrix](size_t row) { return matrix[int(row)]; });
+}
+
+template <typename T>
+void parseVectorText(const string &filePath, T *values, int n, int threads)
+{
+    parseRows<T>(filePath, size_t(n), 1, threads, [values](size_t row) { return values + row; });
+}
+
+TextRowReader::TextRowReader(const string &filePath, size_t blockSize)
+    : file(filePath, ios::binary), path(filePath), buffer(max<size_t>(blockSize, 64)), begin(0), end(0), line(0), eof(false)
+{
+    if (!file.is_open())
+    {
+        throw runtime_error("Could not open file: " + filePath);
+    }
+}
+
+bool TextRowReader::fill()
+{
+    if (eof)
+    {
+        return false;
+    }
+
+    // Keep the unparsed tail, grow the buffer if a single line fills it.
+    size_t tail = end - begin;
+    memmove(buffer.data(), buffer.data() + begin, tail);
+    begin = 0;
+    end = tail;
+    if (end == buffer.size())
+    {
+        buffer.resize(buffer.size() * 2);
+    }
+
+    file.read(buffer.data() + end, streamsize(buffer.size() - end));
+    size_t got = size_t(file.gcount());
+    end += got;
+    if (got == 0 || file.eof())
+    {
+        eof = true;
+    }
+    return got > 0;
+}
+
+template <typename T>
+void TextRowReader::readRow(T *values, int width)
+{
+    for (;;)
+    {
+        const char *start = buffer.data() + begin;
+        const char *limit = buffer.data() + end;
+        const void *newline = memchr(start, '\n', size_t(limit - start));
+
+        if (newline == nullptr && !eof)
+        {
+            fill();
+            continue;
+        }
+        if (newline == nullptr && start == limit)
+        {
+            throw runtime_error(path + ":" + to_string(line) + ": unexpected end of file");
+        }
+
+        const char *eol = newline != nullptr ? static_cast<const char *>(newline) : limit;
+        ++line;
+        begin = size_t(eol - buffer.data()) + (newline != nullptr ? 1 : 0);
+
+        const char *q = skipBlanks(start, eol);
+        if (q == eol)
+        {
+            continue;
+        }
+
+        int count = 0;
+        while (q < eol)
+        {
+            if (count == width)
+            {
+                throw runtime_error(path + ":" + to_string(line) + ":" + to_string(q - start + 1) +
+                                    ": expected " + to_string(width) + " values, found more");
+            }
+            const char *next = parseValue(q, eol, values[count]);
+            if (next == nullptr)
+            {
+                throw runtime_error(path + ":" + to_string(line) + ":" + to_string(q - start + 1) +
+                                    ": malformed number");
+            }
+            ++count;
+            q = skipBlanks(next, eol);
+        }
+        if (count < width)
+        {
+            throw runtime_error(path + ":" + to_string(line) + ":" + to_string(eol - start + 1) +
+                                ": expected " + to_string(width) + " values, found " + to_string(count));
+        }
+        return;
+    }
+}
+
+TextRowWriter::TextRowWriter(const string &filePath, int precision, size_t blockSize)
+    : file(filePath, ios::binary | ios::trunc), path(filePath), buffer(max(blockSize, 2 * MAX_VALUE_CHARS)), used(0),
+      digits(precision)
+{
+    if (!file.is_open())
+    {
+        throw runtime_error("Could not open file: " + filePath);
+    }
+}
+
+TextRowWriter::~TextRowWriter()
+{
+    if (file.is_open())
+    {
+        flush();
+    }
+}
+
+void TextRowWriter::flush()
+{
+    file.write(buffer.data(), streamsize(used));
+    used = 0;
+}
+
+template <typename T>
+void TextRowWriter::writeValue(T value)
+{
+    if (buffer.size() - used < MAX_VALUE_CHARS)
+    {
+        flush();
+    }
+    char *first = buffer.data() + used;
+    to_chars_result result = to_chars(first, first + MAX_VALUE_CHARS - 1, value, chars_format::fixed, digits);
+    if (result.ec != errc())
+    {
+        throw runtime_error(path + ": value does not fit in " + to_string(MAX_VALUE_CHARS) + " characters");
+    }
+    *result.ptr = '\n';
+    used = size_t(result.ptr + 1 - buffer.data());
+}
+
+void TextRowWriter::close()
+{
+    flush();
+    file.close();
+    if (!file)
+    {
+        throw runtime_error("Could not write file: " + path);
+    }
+}
+
+template <typename T>
+void writeVectorText(const string &filePath, const T *values, size_t n, int precision)
+{
+    TextRowWriter writer(filePath, precision);
+    for (size_t i = 0; i < n; ++i)
+    {
+        writer.writeValue(values[i]);
+    }
+    writer.close();
+}
+
+template void TextRowReader::readRow<float>(float *, int);
+template void TextRowReader::readRow<double>(double *, int);
+template void parseBandText<float>(const string &, BandMatrix<float> &, int);
+template void parseBandText<double>(const string &, BandMatrix<double> &, int);
+template void parseVectorText<float>(const string &, float *, int, int);
+template void parseVectorText<double>(const string &, double *, int, int);
+template void TextRowWriter::writeValue<float>(float);
+template void TextRowWriter::writeValue<double>(double);
+template void writeVectorText<float>(const string &, const float *, size_t, int);
+template void writeVectorText<double>(const string &, const double *, size_t, int);
@@ -0,0 +1,45 @@
+/**
+ * @file AllocationCounter.cpp
+ * @brief Counting replacements of the global allocation functions.
+ */
+#include "AllocationCounter.hpp"
+
+namespace
+{
+    /// Heap allocations made through operator new since the start of the process.
+    atomic<size_t> allocations{0};
+}
+
+// The array, nothrow and sized forms of libstdc++ all forward to these. All of them
+// stay out of line: once inlined, the malloc() or free() inside would be paired with
+// the operator new or delete of the caller and trip -Wmismatched-new-delete.
+__attribute__((noinline)) void *operator new(size_t size)
+{
+    ++allocations;
+    if (void *pointer = malloc(size > 0 ? size : 1))
+    {
+        return pointer;
+    }
+    throw bad_alloc();
+}
+
+__attribute__((noinline)) void *operator new(size_t size, align_val_t alignment)
+{
+    ++allocations;
+    const size_t align = size_t(alignment);
+    if (void *pointer = aligned_alloc(align, (max(size, size_t(1)) + align - 1) / align * align))
+    {
+        return pointer;
+    }
+    throw bad_alloc();
+}
+
+__attribute__((noinline)) void operator delete(void *pointer) noexcept { free(pointer); }
+__attribute__((noinline)) void operator delete(void *pointer, size_t) noexcept { free(pointer); }
+__attribute__((noinline)) void operator delete(void *pointer, align_val_t) noexcept { free(pointer); }
+__attribute__((noinline)) void operator delete(void *pointer, size_t, align_val_t) noexcept { free(pointer); }
+
+size_t allocationCount()
+{
+    return allocations.load();
+}
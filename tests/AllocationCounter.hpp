@@ -0,0 +1,20 @@
+/**
+ * @file AllocationCounter.hpp
+ * @brief Heap allocation count of the unit tests and the benchmark.
+ *
+ * AllocationCounter.cpp replaces the global operator new and delete with counting
+ * versions; linking it into an executable turns the count on.
+ */
+
+#ifndef AllocationCounter_HPP
+#define AllocationCounter_HPP
+
+#include <bits/stdc++.h>
+using namespace std;
+
+/**
+ * @brief Heap allocations made through operator new since the start of the process.
+ */
+size_t allocationCount();
+
+#endif // AllocationCounter_HPP
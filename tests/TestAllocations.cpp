@@ -0,0 +1,93 @@
+/**
+ * @file TestAllocations.cpp
+ * @brief Steady-state time steps and factorization solves must not allocate.
+ */
+#include "TestSystems.hpp"
+
+namespace
+{
+    /**
+     * @brief Heap allocations made by one call of the function.
+     */
+    template <typename Function>
+    size_t allocationsOf(Function &&function)
+    {
+        size_t before = allocationCount();
+        function();
+        return allocationCount() - before;
+    }
+
+    /**
+     * @brief Runs the time-step loop of the benchmark on one solver and checks that only the first step allocates.
+     */
+    template <typename StorageT, typename AccumT>
+    void checkTimeSteps(int n, int m, FactorizationKernel kernel, int threads)
+    {
+        BandSystem system = randomBandSystem(n, m, 9u);
+        SLAUSolverLDLT<StorageT, AccumT> solver(n, m, testDataDir() + "/X.txt");
+        loadSystem(solver, system);
+        solver.setKeepSnapshot(true);
+        solver.setNumThreads(threads);
+        solver.setFactorizationKernel(kernel, 8);
+        vector<StorageT> f(system.f.begin(), system.f.end());
+
+        for (int step = 0; step < 4; ++step)
+        {
+            size_t allocations = allocationsOf([&]
+            {
+                if (solver.isFactored())
+                {
+                    solver.returnMatix();
+                }
+                solver.setVectorF(f.data());
+                solver.performLDLtDecomposition();
+                solver.solveLinearSystem();
+            });
+            check(step == 0 || allocations == 0, "Time step " + to_string(step) + " with m = " + to_string(m) +
+                                                     " made " + to_string(allocations) + " heap allocations");
+        }
+        check(system.relativeResidual(solver.getVectorF()) <= (is_same_v<StorageT, float> ? 1e-5 : 1e-13),
+              "Time step solution has a large residual");
+    }
+}
+
+LDLT_TEST(timeStepsDoNotAllocate)
+{
+    checkTimeSteps<double, double>(500, 12, FactorizationKernel::Serial, 1);
+    checkTimeSteps<double, double>(500, 12, FactorizationKernel::Wavefront, 2);
+    checkTimeSteps<double, double>(500, 40, FactorizationKernel::Blocked, 1);
+    checkTimeSteps<double, double>(500, 4, FactorizationKernel::Fixed, 1);
+    checkTimeSteps<float, double>(500, 12, FactorizationKernel::Serial, 1);
+    checkTimeSteps<float, float>(500, 12, FactorizationKernel::Serial, 1);
+}
+
+LDLT_TEST(factorizationSolvesDoNotAllocate)
+{
+    BandSystem system = randomBandSystem(400, 10, 13u);
+    SLAUSolverLDLT<float, double> solver(system.n, system.m, testDataDir() + "/X.txt");
+    loadSystem(solver, system);
+    auto factors = solver.factorize();
+    LDLTFactorization<float, double>::Workspace workspace;
+
+    const int k = 3;
+    vector<float> x(system.n);
+    vector<float> block(size_t(k) * system.n);
+    for (int repeat = 0; repeat < 3; ++repeat)
+    {
+        size_t allocations = allocationsOf([&]
+        {
+            copy(system.f.begin(), system.f.end(), x.begin());
+            factors->solve(x.data(), workspace);
+            for (int c = 0; c < k; ++c)
+            {
+                copy(system.f.begin(), system.f.end(), block.begin() + size_t(c) * system.n);
+            }
+            factors->solve(block.data(), k, system.n, workspace);
+        });
+        check(repeat == 0 || allocations == 0, "Solve " + to_string(repeat) + " made " + to_string(allocations) +
+                                                   " heap allocations");
+    }
+    check(system.relativeResidual(x) <= 1e-5, "Solution has a large residual");
+    check(maxRelativeDifference(vector<float>(block.end() - system.n, block.end()), x) <= 1e-6,
+          "Block and single solves differ");
+}
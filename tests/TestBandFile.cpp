@@ -0,0 +1,68 @@
+/**
+ * @file TestBandFile.cpp
+ * @brief Vector files written in one piece and in pieces, read back through MappedBandFile.
+ */
+#include "BandFile.hpp"
+#include "TestFramework.hpp"
+
+namespace
+{
+    string fileBytes(const string &path)
+    {
+        ifstream file(path, ios::binary);
+        return string(istreambuf_iterator<char>(file), istreambuf_iterator<char>());
+    }
+}
+
+LDLT_TEST(vectorFileWriterMatchesWriteVectorFile)
+{
+    const string dir = testDataDir();
+    vector<double> values(5000);
+    for (size_t i = 0; i < values.size(); ++i)
+    {
+        values[i] = sin(double(i)) * 1e3;
+    }
+    writeVectorFile(dir + "/vector_whole.ldlt", values.data(), values.size());
+
+    VectorFileWriter<double> writer(dir + "/vector_pieces.ldlt", values.size());
+    for (size_t start = 0; start < values.size(); start += 777)
+    {
+        writer.append(values.data() + start, min(size_t(777), values.size() - start));
+    }
+    writer.close();
+    check(fileBytes(dir + "/vector_whole.ldlt") == fileBytes(dir + "/vector_pieces.ldlt"), "The vector files differ");
+
+    MappedBandFile file(dir + "/vector_pieces.ldlt", true);
+    check(file.layout() == BandLayout::Vector && file.size() == int(values.size()), "Wrong vector file header");
+    check(equal(values.begin(), values.end(), file.F<double>()), "The mapped vector differs");
+}
+
+LDLT_TEST(vectorFileWriterChecksTheCount)
+{
+    const string path = testDataDir() + "/vector_count.ldlt";
+    vector<float> values(10, 1.0f);
+    bool threwOnExtra = false;
+    bool threwOnShort = false;
+    {
+        VectorFileWriter<float> writer(path, 8);
+        try
+        {
+            writer.append(values.data(), 10);
+        }
+        catch (const logic_error &)
+        {
+            threwOnExtra = true;
+        }
+        writer.append(values.data(), 5);
+        try
+        {
+            writer.close();
+        }
+        catch (const logic_error &)
+        {
+            threwOnShort = true;
+        }
+    }
+    check(threwOnExtra, "Appending past n values was accepted");
+    check(threwOnShort, "Closing after fewer than n values was accepted");
+}
@@ -0,0 +1,109 @@
+/**
+ * @file TestDevice.cpp
+ * @brief The GPU kernels, run through the host emulation of tests/device, against the host solvers.
+ *
+ * Only built into build/ldlt_device_tests.exe, where DeviceKernels.cu is compiled
+ * as C++ with LDLT_USE_CUDA (see tests/device/cuda_runtime.h).
+ */
+#include "DeviceBackend.hpp"
+#include "TestSystems.hpp"
+
+namespace
+{
+    /**
+     * @brief Solves k right-hand sides on the device and on the host and compares them.
+     */
+    template <typename StorageT, typename AccumT>
+    void checkMultiRhs(int n, int m, int k, double tolerance)
+    {
+        BandSystem system = randomBandSystem(n, m, 61u + unsigned(m));
+        SLAUSolverLDLT<StorageT, AccumT> solver(n, m, testDataDir() + "/X.txt");
+        loadSystem(solver, system);
+        auto factors = solver.factorize();
+
+        // A leading dimension above n checks the pitched copies.
+        const int ld = n + 3;
+        vector<StorageT> block(size_t(ld) * k);
+        mt19937 generator(7u);
+        uniform_real_distribution<double> value(-1.0, 1.0);
+        for (StorageT &entry : block)
+        {
+            entry = StorageT(value(generator));
+        }
+        vector<StorageT> expected(block);
+        factors->solve(expected.data(), k, ld);
+
+        DeviceBandFactorization<StorageT, AccumT> device(*factors);
+        device.solve(block.data(), k, ld);
+        for (int c = 0; c < k; ++c)
+        {
+            vector<StorageT> column(block.begin() + size_t(c) * ld, block.begin() + size_t(c) * ld + n);
+            vector<StorageT> reference(expected.begin() + size_t(c) * ld, expected.begin() + size_t(c) * ld + n);
+            double difference = maxRelativeDifference(column, reference);
+            check(difference <= tolerance, "Column " + to_string(c) + " with m = " + to_string(m) + " differs by " +
+                                               to_string(difference));
+        }
+        check(equal(block.begin() + n, block.begin() + ld, expected.begin() + n), "The padding rows were changed");
+    }
+
+    /**
+     * @brief Factors and solves a batch on the device and on the host and compares the solutions.
+     */
+    template <typename StorageT, typename AccumT>
+    void checkBatch(int systems, int n, int m, double tolerance)
+    {
+        using Batch = BatchedLDLTSolver<StorageT, AccumT>;
+        Batch host(systems, n, m);
+        for (int s = 0; s < systems; ++s)
+        {
+            BandSystem system = randomBandSystem(n, m, 100u + unsigned(s));
+            BandMatrix<StorageT> AL(n, m);
+            for (int i = 0; i < n; ++i)
+            {
+                for (int p = 0; p < m; ++p)
+                {
+                    AL[i][p] = StorageT(system.band[size_t(i) * m + p]);
+                }
+            }
+            vector<StorageT> D(system.diag.begin(), system.diag.end());
+            vector<StorageT> F(system.f.begin(), system.f.end());
+            host.setSystem(s, AL, D.data(), F.data());
+        }
+
+        DeviceBatchedLDLTSolver<StorageT, AccumT> device(host);
+        device.factor();
+        Batch deviceResult = host;
+        device.solve(deviceResult);
+        host.factor();
+        host.solve();
+
+        vector<StorageT> x(n);
+        vector<StorageT> y(n);
+        for (int s = 0; s < systems; ++s)
+        {
+            host.getSolution(s, x.data());
+            deviceResult.getSolution(s, y.data());
+            double difference = maxRelativeDifference(y, x);
+            check(difference <= tolerance, "System " + to_string(s) + " differs by " + to_string(difference));
+        }
+    }
+}
+
+LDLT_TEST(deviceMultiRhsMatchesHost)
+{
+    // Bandwidths below, at and above one warp of row threads, and above a full block.
+    checkMultiRhs<double, double>(200, 5, 3, 1e-12);
+    checkMultiRhs<double, double>(200, 32, 2, 1e-12);
+    checkMultiRhs<double, double>(300, 70, 2, 1e-12);
+    checkMultiRhs<double, double>(400, 150, 1, 1e-12);
+    checkMultiRhs<double, double>(50, 0, 2, 1e-14);
+    checkMultiRhs<float, double>(200, 40, 2, 1e-5);
+    checkMultiRhs<float, float>(200, 40, 2, 1e-4);
+}
+
+LDLT_TEST(deviceBatchMatchesHost)
+{
+    checkBatch<double, double>(200, 24, 3, 1e-12);
+    checkBatch<float, double>(130, 16, 4, 1e-5);
+    checkBatch<float, float>(130, 16, 2, 1e-4);
+}
@@ -0,0 +1,90 @@
+/**
+ * @file TestDistributed.cpp
+ * @brief DistributedLDLTSolver on all ranks of MPI_COMM_WORLD against the serial solve.
+ *
+ * Only built into build/ldlt_mpi_tests.exe, which 'make mpi-test' runs on 2 and 3 ranks.
+ * Every rank checks its own rows, so a test fails on a rank only after all collective
+ * calls have returned.
+ */
+#include "DistributedLDLTSolver.hpp"
+#include "TestSystems.hpp"
+
+namespace
+{
+    /**
+     * @brief Writes the system as a band file of StorageT on rank 0, visible to all ranks on return.
+     */
+    template <typename StorageT>
+    string writeSharedBandFile(const BandSystem &system, const string &name)
+    {
+        const string path = testDataDir() + "/" + name;
+        int rank = 0;
+        MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+        if (rank == 0)
+        {
+            BandMatrix<StorageT> AL(system.n, system.m);
+            for (int i = 0; i < system.n; ++i)
+            {
+                for (int p = 0; p < system.m; ++p)
+                {
+                    AL[i][p] = StorageT(system.band[size_t(i) * system.m + p]);
+                }
+            }
+            vector<StorageT> D(system.diag.begin(), system.diag.end());
+            vector<StorageT> F(system.f.begin(), system.f.end());
+            writeBandFile<StorageT>(path, AL, D, &F);
+        }
+        MPI_Barrier(MPI_COMM_WORLD);
+        return path;
+    }
+
+    /**
+     * @brief Solves the system on all ranks and compares every rank's rows with SLAUSolverLDLT.
+     */
+    template <typename StorageT, typename AccumT>
+    void checkDistributed(int n, int m, double tolerance)
+    {
+        BandSystem system = randomBandSystem(n, m, 81u + unsigned(m));
+        const string path = writeSharedBandFile<StorageT>(system, "distributed_" + to_string(m) + ".ldlt");
+
+        DistributedLDLTSolver<StorageT, AccumT> solver(MPI_COMM_WORLD, path, true);
+        solver.factorize();
+        solver.solve();
+
+        vector<StorageT> expected = solveSystem<StorageT, AccumT>(system);
+        vector<StorageT> local(expected.begin() + solver.firstRow(), expected.begin() + solver.lastRow());
+        double difference = maxRelativeDifference(solver.localSolution(), local);
+        check(difference <= tolerance, "n = " + to_string(n) + ", m = " + to_string(m) + ": rows " +
+                                           to_string(solver.firstRow()) + " to " + to_string(solver.lastRow()) +
+                                           " differ by " + to_string(difference));
+    }
+}
+
+LDLT_TEST(distributedMatchesSerial)
+{
+    checkDistributed<double, double>(1000, 4, 1e-12);
+    checkDistributed<double, double>(777, 9, 1e-12);
+    checkDistributed<double, double>(500, 1, 1e-12);
+    checkDistributed<float, double>(1000, 4, 1e-5);
+}
+
+LDLT_TEST(distributedRejectsShortBlocks)
+{
+    int ranks = 1;
+    MPI_Comm_size(MPI_COMM_WORLD, &ranks);
+    const int m = 5;
+    // One row short of 2m rows on every rank; a single rank has no blocks to split.
+    BandSystem system = randomBandSystem(2 * m * ranks - 1, m, 82u);
+    const string path = writeSharedBandFile<double>(system, "distributed_short.ldlt");
+
+    bool threw = false;
+    try
+    {
+        DistributedLDLTSolver<double, double> solver(MPI_COMM_WORLD, path);
+    }
+    catch (const invalid_argument &)
+    {
+        threw = true;
+    }
+    check(threw == (ranks > 1), "Blocks shorter than 2m rows on " + to_string(ranks) + " ranks were accepted");
+}
@@ -0,0 +1,87 @@
+/**
+ * @file TestFramework.hpp
+ * @brief Minimal test registry and checks for the unit tests run by 'make test'.
+ *
+ * A test is a function declared with LDLT_TEST(name); it fails by throwing, usually
+ * through check() or checkNear(). TestMain.cpp runs every registered test, and
+ * AllocationCounter.cpp counts heap allocations for the steady-state tests.
+ */
+
+#ifndef TestFramework_HPP
+#define TestFramework_HPP
+
+#include <bits/stdc++.h>
+#include "AllocationCounter.hpp"
+using namespace std;
+
+/**
+ * @brief Registered tests in registration order (one translation unit after the other).
+ */
+vector<pair<string, function<void()>>> &testRegistry();
+
+/**
+ * @brief Adds a test to testRegistry() during static initialization.
+ */
+struct TestRegistrar
+{
+    TestRegistrar(const string &name, function<void()> test) { testRegistry().emplace_back(name, std::move(test)); }
+};
+
+/**
+ * @brief Defines and registers the test function `name`.
+ */
+#define LDLT_TEST(name)                                     \
+    static void name();                                     \
+    static const TestRegistrar name##Registrar(#name, name); \
+    static void name()
+
+/**
+ * @brief Throws with the message if the condition does not hold.
+ */
+inline void check(bool condition, const string &message)
+{
+    if (!condition)
+    {
+        throw runtime_error(message);
+    }
+}
+
+/**
+ * @brief Throws unless |actual - expected| <= tolerance * max(1, |expected|).
+ */
+inline void checkNear(double actual, double expected, double tolerance, const string &what)
+{
+    if (!(abs(actual - expected) <= tolerance * max(1.0, abs(expected))))
+    {
+        ostringstream message;
+        message << setprecision(17) << what << ": " << actual << " differs from " << expected;
+        throw runtime_error(message.str());
+    }
+}
+
+/**
+ * @brief Largest |a[i] - b[i]| / max(1, |b[i]|) over two vectors of equal length.
+ */
+template <typename T, typename U>
+double maxRelativeDifference(const vector<T> &a, const vector<U> &b)
+{
+    check(a.size() == b.size(), "Vectors differ in length");
+    double worst = 0;
+    for (size_t i = 0; i < a.size(); ++i)
+    {
+        worst = max(worst, abs(double(a[i]) - double(b[i])) / max(1.0, abs(double(b[i]))));
+    }
+    return worst;
+}
+
+/**
+ * @brief Directory for the files the tests write, created on first use.
+ */
+inline string testDataDir()
+{
+    const string dir = "build/test_data";
+    filesystem::create_directories(dir);
+    return dir;
+}
+
+#endif // TestFramework_HPP
@@ -0,0 +1,117 @@
+/**
+ * @file TestKernels.cpp
+ * @brief Every factorization kernel against the serial kernel, and the solve residual.
+ */
+#include "FixedBandKernels.hpp"
+#include "TestSystems.hpp"
+
+namespace
+{
+    /**
+     * @brief Factors the system with one kernel and returns the factors.
+     */
+    template <typename StorageT, typename AccumT>
+    shared_ptr<const LDLTFactorization<StorageT, AccumT>> factorWith(const BandSystem &system, FactorizationKernel kernel,
+                                                                    int threads = 1, int panelWidth = 32)
+    {
+        SLAUSolverLDLT<StorageT, AccumT> solver(system.n, system.m, testDataDir() + "/X.txt");
+        loadSystem(solver, system);
+        solver.setNumThreads(threads);
+        solver.setFactorizationKernel(kernel, panelWidth);
+        return solver.factorize();
+    }
+
+    /**
+     * @brief Largest relative difference between the L and D factors of two factorizations.
+     */
+    template <typename StorageT, typename AccumT>
+    double factorDifference(const LDLTFactorization<StorageT, AccumT> &a, const LDLTFactorization<StorageT, AccumT> &b)
+    {
+        const int n = a.size();
+        const int m = a.bandwidth();
+        double worst = maxRelativeDifference(a.D(), b.D());
+        for (int i = 0; i < n; ++i)
+        {
+            for (int p = max(0, m - i); p < m; ++p)
+            {
+                worst = max(worst, abs(double(a.L()[i][p]) - double(b.L()[i][p])) / max(1.0, abs(double(b.L()[i][p]))));
+            }
+        }
+        return worst;
+    }
+
+    /**
+     * @brief Checks one kernel against the serial kernel on a random system.
+     */
+    template <typename StorageT, typename AccumT>
+    void checkKernel(int n, int m, FactorizationKernel kernel, double tolerance, int threads = 1, int panelWidth = 32)
+    {
+        BandSystem system = randomBandSystem(n, m, 7u + unsigned(m));
+        auto serial = factorWith<StorageT, AccumT>(system, FactorizationKernel::Serial);
+        auto other = factorWith<StorageT, AccumT>(system, kernel, threads, panelWidth);
+
+        double difference = factorDifference(*other, *serial);
+        check(difference <= tolerance, "n = " + to_string(n) + ", m = " + to_string(m) + ": factors differ by " +
+                                           to_string(difference));
+
+        vector<StorageT> x(system.f.begin(), system.f.end());
+        other->solve(x);
+        double residual = system.relativeResidual(x);
+        check(residual <= (is_same_v<StorageT, float> ? 1e-5 : 1e-13),
+              "Relative residual " + to_string(residual) + " with m = " + to_string(m));
+    }
+}
+
+LDLT_TEST(wavefrontMatchesSerial)
+{
+    // The wavefront kernel computes every entry in the serial order, so the factors are bitwise equal.
+    checkKernel<double, double>(500, 17, FactorizationKernel::Wavefront, 0, 4);
+    checkKernel<float, double>(500, 17, FactorizationKernel::Wavefront, 0, 4);
+    checkKernel<float, float>(300, 40, FactorizationKernel::Wavefront, 0, 3);
+}
+
+LDLT_TEST(blockedMatchesSerial)
+{
+    checkKernel<double, double>(400, 40, FactorizationKernel::Blocked, 1e-12, 1, 8);
+    checkKernel<double, double>(300, 37, FactorizationKernel::Blocked, 1e-12, 1, 32);
+    checkKernel<float, double>(400, 40, FactorizationKernel::Blocked, 1e-5, 1, 8);
+    checkKernel<float, float>(400, 40, FactorizationKernel::Blocked, 1e-4, 1, 8);
+    // Wide enough for Auto to pick the blocked kernel (m >= 512), with a partial four-column group.
+    checkKernel<double, double>(1100, 515, FactorizationKernel::Auto, 1e-12);
+}
+
+LDLT_TEST(fixedMatchesSerial)
+{
+    for (int m : {1, 2, 3, 4, 8})
+    {
+        check(hasFixedBandKernel(m), "No fixed kernel for m = " + to_string(m));
+        checkKernel<double, double>(257, m, FactorizationKernel::Fixed, 1e-14);
+        checkKernel<float, double>(257, m, FactorizationKernel::Fixed, 1e-6);
+        checkKernel<float, float>(257, m, FactorizationKernel::Fixed, 1e-6);
+    }
+}
+
+LDLT_TEST(fixedRejectsOtherBandwidths)
+{
+    BandSystem system = randomBandSystem(50, 5, 3u);
+    bool threw = false;
+    try
+    {
+        factorWith<double, double>(system, FactorizationKernel::Fixed);
+    }
+    catch (const invalid_argument &)
+    {
+        threw = true;
+    }
+    check(threw, "The fixed kernel accepted m = 5");
+}
+
+LDLT_TEST(serialSolvesNarrowAndWideBands)
+{
+    for (int m : {0, 1, 5, 64})
+    {
+        BandSystem system = randomBandSystem(200, m, 11u);
+        double residual = system.relativeResidual(solveSystem<double, double>(system));
+        check(residual <= 1e-13, "Relative residual " + to_string(residual) + " with m = " + to_string(m));
+    }
+}
@@ -0,0 +1,91 @@
+/**
+ * @file TestMain.cpp
+ * @brief Runs the registered unit tests: 'make test', or build/ldlt_tests.exe [name...].
+ *
+ * Without arguments every test runs; otherwise only the named ones. Each test
+ * prints PASS, or FAIL with the reason, and the exit status is 1 if any failed.
+ *
+ * With LDLT_USE_MPI ('make mpi-test') every rank runs every test. A test passes
+ * only if it passed on all ranks; rank 0 prints the results, and a rank that
+ * failed prints its reason with its rank number.
+ */
+#include "TestFramework.hpp"
+
+#ifdef LDLT_USE_MPI
+#include <mpi.h>
+#endif
+
+vector<pair<string, function<void()>>> &testRegistry()
+{
+    static vector<pair<string, function<void()>>> registry;
+    return registry;
+}
+
+int main(int argc, char **argv)
+{
+    int rank = 0;
+#ifdef LDLT_USE_MPI
+    MPI_Init(&argc, &argv);
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+#endif
+
+    set<string> selected(argv + 1, argv + argc);
+    int run = 0;
+    int failed = 0;
+    for (const auto &[name, test] : testRegistry())
+    {
+        if (!selected.empty() && selected.count(name) == 0)
+        {
+            continue;
+        }
+        ++run;
+        string reason;
+        try
+        {
+            test();
+        }
+        catch (const exception &e)
+        {
+            reason = e.what();
+        }
+
+        int localFailure = reason.empty() ? 0 : 1;
+        int anyFailure = localFailure;
+#ifdef LDLT_USE_MPI
+        MPI_Allreduce(&localFailure, &anyFailure, 1, MPI_INT, MPI_MAX, MPI_COMM_WORLD);
+        if (localFailure != 0 && rank != 0)
+        {
+            cout << "FAIL " << name << " on rank " << rank << ": " << reason << '\n' << flush;
+        }
+        MPI_Barrier(MPI_COMM_WORLD);
+#endif
+        if (anyFailure != 0)
+        {
+            ++failed;
+        }
+        if (rank == 0)
+        {
+            if (localFailure != 0)
+            {
+                cout << "FAIL " << name << ": " << reason << '\n';
+            }
+            else if (anyFailure != 0)
+            {
+                cout << "FAIL " << name << " on another rank\n";
+            }
+            else
+            {
+                cout << "PASS " << name << '\n';
+            }
+        }
+    }
+    if (rank == 0)
+    {
+        cout << run - failed << " of " << run << " tests passed\n";
+    }
+
+#ifdef LDLT_USE_MPI
+    MPI_Finalize();
+#endif
+    return failed > 0 || run == 0 ? 1 : 0;
+}
@@ -0,0 +1,92 @@
+/**
+ * @file TestRefinement.cpp
+ * @brief solveWithRefinement() on well and badly conditioned systems.
+ */
+#include "TestSystems.hpp"
+
+namespace
+{
+    /**
+     * @brief Graph Laplacian of a random weighted band plus delta * I; cond(A) grows like 1 / delta.
+     */
+    BandSystem shiftedLaplacianSystem(int n, int m, double delta, unsigned seed)
+    {
+        BandSystem system;
+        system.n = n;
+        system.m = m;
+        system.band.assign(size_t(n) * m, 0.0);
+        system.diag.assign(n, delta);
+        system.f.resize(n);
+        mt19937 generator(seed);
+        uniform_real_distribution<double> weight(0.5, 1.0);
+        uniform_real_distribution<double> value(-1.0, 1.0);
+        for (int i = 0; i < n; ++i)
+        {
+            for (int j = max(0, i - m); j < i; ++j)
+            {
+                double w = weight(generator);
+                system.at(i, j) = -w;
+                system.diag[i] += w;
+                system.diag[j] += w;
+            }
+            system.f[i] = value(generator);
+        }
+        return system;
+    }
+
+    /// Six significant digits; to_string() prints small residuals as 0.000000.
+    string formatted(double value)
+    {
+        ostringstream text;
+        text << setprecision(6) << value;
+        return text.str();
+    }
+
+    /**
+     * @brief Refines with a tolerance it cannot reach and returns the report.
+     */
+    RefinementReport refine(SLAUSolverLDLT<double, double> &solver, const BandSystem &system, int maxIterations)
+    {
+        vector<double> f(system.f);
+        solver.setVectorF(f.data());
+        RefinementReport report = solver.solveWithRefinement(1e-20, maxIterations);
+        double residual = system.relativeResidual(solver.getVectorF());
+        check(report.relativeResidual <= 1.5 * residual && residual <= 1.5 * report.relativeResidual,
+              "The report gives " + formatted(report.relativeResidual) + " for a solution with residual " +
+                  formatted(residual));
+        return report;
+    }
+}
+
+LDLT_TEST(refinementReachesDoubleAccuracy)
+{
+    BandSystem system = randomBandSystem(2000, 8, 71u);
+    SLAUSolverLDLT<double, double> solver(system.n, system.m, testDataDir() + "/X.txt");
+    loadSystem(solver, system);
+    RefinementReport report = solver.solveWithRefinement(1e-14, 30);
+    check(report.converged, "Refinement stopped at " + formatted(report.relativeResidual));
+    check(system.relativeResidual(solver.getVectorF()) <= 1e-14, "Refined solution has a large residual");
+}
+
+LDLT_TEST(refinementReturnsTheBestIterate)
+{
+    // Refinement stalls at the rounding floor of the double residual, where a step
+    // can make x slightly worse; more iterations must never return a worse x.
+    for (double delta : {1e-5, 1e-6})
+    {
+        BandSystem system = shiftedLaplacianSystem(2000, 3, delta, 3u);
+        SLAUSolverLDLT<double, double> solver(system.n, system.m, testDataDir() + "/X.txt");
+        loadSystem(solver, system);
+        double previous = numeric_limits<double>::infinity();
+        for (int maxIterations = 0; maxIterations <= 10; ++maxIterations)
+        {
+            RefinementReport report = refine(solver, system, maxIterations);
+            check(!report.converged, "A tolerance of 1e-20 was reached");
+            check(report.iterations <= maxIterations, "Reported " + to_string(report.iterations) + " iterations");
+            check(report.relativeResidual <= previous,
+                  "With " + to_string(maxIterations) + " iterations and delta = " + formatted(delta) +
+                      " the residual grew from " + formatted(previous) + " to " + formatted(report.relativeResidual));
+            previous = report.relativeResidual;
+        }
+    }
+}
@@ -0,0 +1,108 @@
+/**
+ * @file TestReordering.cpp
+ * @brief Bandwidth reduction and residual of ReorderedBandSolver on a scrambled grid.
+ */
+#include "SparseReordering.hpp"
+#include "TestFramework.hpp"
+
+namespace
+{
+    /**
+     * @brief 5-point Laplacian (plus a shift) of a k x k grid with randomly numbered unknowns.
+     */
+    SparseMatrix<double> scrambledGrid(int k, unsigned seed)
+    {
+        const int n = k * k;
+        vector<int> label(n);
+        iota(label.begin(), label.end(), 0);
+        shuffle(label.begin(), label.end(), mt19937(seed));
+
+        vector<int> rows;
+        vector<int> cols;
+        vector<double> values;
+        auto add = [&](int a, int b, double value)
+        {
+            rows.push_back(label[a]);
+            cols.push_back(label[b]);
+            values.push_back(value);
+        };
+        for (int y = 0; y < k; ++y)
+        {
+            for (int x = 0; x < k; ++x)
+            {
+                int p = y * k + x;
+                add(p, p, 4.1);
+                if (x + 1 < k)
+                {
+                    add(p, p + 1, -1);
+                    add(p + 1, p, -1);
+                }
+                if (y + 1 < k)
+                {
+                    add(p, p + k, -1);
+                    add(p + k, p, -1);
+                }
+            }
+        }
+        return SparseMatrix<double>::fromCoo(n, rows, cols, values);
+    }
+
+    /**
+     * @brief ||f - A * x||_2 / ||f||_2 with the full CSR matrix.
+     */
+    double relativeResidual(const SparseMatrix<double> &A, const vector<double> &x, const vector<double> &f)
+    {
+        double r = 0;
+        double b = 0;
+        for (int i = 0; i < A.n; ++i)
+        {
+            double y = 0;
+            for (int p = A.rowStart[i]; p < A.rowStart[i + 1]; ++p)
+            {
+                y += A.values[p] * x[A.columns[p]];
+            }
+            r += (f[i] - y) * (f[i] - y);
+            b += f[i] * f[i];
+        }
+        return sqrt(r / b);
+    }
+}
+
+LDLT_TEST(reorderingNarrowsTheBandAndSolves)
+{
+    const int k = 30;
+    SparseMatrix<double> A = scrambledGrid(k, 17u);
+    vector<double> f(A.n);
+    mt19937 generator(3u);
+    uniform_real_distribution<double> value(-1.0, 1.0);
+    for (double &entry : f)
+    {
+        entry = value(generator);
+    }
+
+    ReorderedBandSolver<double, double> reordered(A);
+    check(reordered.bandwidth() <= k + 2, "RCM bandwidth " + to_string(reordered.bandwidth()) + " on a " +
+                                              to_string(k) + " x " + to_string(k) + " grid");
+    check(reordered.bandwidth() < reordered.originalBandwidth(), "RCM did not reduce the bandwidth");
+
+    vector<int> order = reordered.permutation();
+    sort(order.begin(), order.end());
+    for (int i = 0; i < A.n; ++i)
+    {
+        check(order[i] == i, "The RCM order is not a permutation");
+    }
+
+    vector<double> x(A.n);
+    reordered.factor();
+    reordered.solve(f.data(), x.data());
+    double residual = relativeResidual(A, x, f);
+    check(residual <= 1e-13, "Relative residual " + to_string(residual) + " after RCM");
+
+    // The unreordered band solve gives the same solution.
+    ReorderedBandSolver<double, double> original(A, false);
+    check(original.bandwidth() == original.originalBandwidth(), "Unreordered bandwidth changed");
+    vector<double> y(f);
+    original.factor();
+    original.solve(y.data(), y.data());
+    check(maxRelativeDifference(x, y) <= 1e-11, "Reordered and unreordered solutions differ");
+}
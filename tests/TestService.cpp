@@ -0,0 +1,140 @@
+/**
+ * @file TestService.cpp
+ * @brief Cache hits, misses and parse skips of SolverService, and its band-file checks.
+ */
+#include "SolverService.hpp"
+#include "TextParser.hpp"
+#include "TestSystems.hpp"
+
+namespace
+{
+    /**
+     * @brief Text files of one system, written through a solver.
+     */
+    struct TextSystemFiles
+    {
+        string input;
+        string al;
+        string d;
+        string f;
+
+        TextSystemFiles(const string &prefix, const BandSystem &system)
+            : input(prefix + "input.txt"), al(prefix + "AL.txt"), d(prefix + "D.txt"), f(prefix + "F.txt")
+        {
+            SLAUSolverLDLT<double, double> writer(system.n, system.m, prefix + "X.txt");
+            loadSystem(writer, system);
+            writer.saveToFile(input, al, d, f);
+        }
+
+        string request(const string &id, const string &x) const
+        {
+            return "solve id=" + id + " input=" + input + " al=" + al + " d=" + d + " f=" + f + " x=" + x;
+        }
+    };
+
+    /**
+     * @brief Sends one request and checks that the response starts with the expected text.
+     */
+    void expectResponse(SolverService<double, double> &service, const string &request, const string &expected)
+    {
+        bool quit = false;
+        string response = service.handle(request, quit);
+        check(response.compare(0, expected.size(), expected) == 0, "Expected '" + expected + "...', got '" + response + "'");
+    }
+}
+
+LDLT_TEST(serviceCachesFactorsByContent)
+{
+    const string dir = testDataDir();
+    BandSystem system = randomBandSystem(300, 6, 51u);
+    TextSystemFiles first(dir + "/service_a_", system);
+    TextSystemFiles copy(dir + "/service_b_", system);
+    const string x = dir + "/service_X.txt";
+
+    SolverService<double, double> service(size_t(1) << 24);
+    expectResponse(service, first.request("1", x), "ok id=1 cache=miss parsed=1 n=300 m=6");
+    expectResponse(service, first.request("2", x), "ok id=2 cache=hit parsed=0");
+    // The same matrix in other files hits after the parse.
+    expectResponse(service, copy.request("3", x), "ok id=3 cache=hit parsed=1");
+
+    vector<double> solution(system.n);
+    parseVectorText(x, solution.data(), system.n);
+    check(system.relativeResidual(solution) <= 1e-13, "Cached solve has a large residual");
+
+    // A changed matrix parses again and misses.
+    system.diag[17] += 1;
+    TextSystemFiles changed(dir + "/service_a_", system);
+    expectResponse(service, changed.request("4", x), "ok id=4 cache=miss parsed=1");
+
+    ServiceStats stats = service.stats();
+    check(stats.jobs == 4 && stats.hits == 2 && stats.misses == 2 && stats.parseSkips == 1, service.statsLine());
+}
+
+LDLT_TEST(serviceNeedsAnFSectionOrRhs)
+{
+    const string dir = testDataDir();
+    BandSystem system = randomBandSystem(100, 3, 52u);
+    BandMatrix<double> AL(system.n, system.m);
+    for (int i = 0; i < system.n; ++i)
+    {
+        copy(system.band.begin() + size_t(i) * system.m, system.band.begin() + size_t(i + 1) * system.m, AL[i]);
+    }
+    const string band = dir + "/service_noF.ldlt";
+    writeBandFile<double>(band, AL, system.diag, nullptr);
+    vector<double> f(system.f);
+    writeVectorText(dir + "/service_F.txt", f.data(), f.size(), precisionDigits<double>);
+
+    SolverService<double, double> service(size_t(1) << 24);
+    const string x = " x=" + dir + "/service_X.txt";
+    // Without f= the job fails on a miss and on a hit alike.
+    expectResponse(service, "solve id=1 band=" + band + x, "error id=1 " + band + " has no F section; pass f=");
+    expectResponse(service, "solve id=2 band=" + band + " f=" + dir + "/service_F.txt" + x, "ok id=2 cache=miss");
+    expectResponse(service, "solve id=3 band=" + band + x, "error id=3 " + band + " has no F section; pass f=");
+    expectResponse(service, "solve id=4 band=" + band + " f=" + dir + "/service_F.txt" + x, "ok id=4 cache=hit parsed=0");
+}
+
+LDLT_TEST(factorsTellCollidingMatricesApart)
+{
+    BandSystem system = randomBandSystem(80, 4, 53u);
+    SLAUSolverLDLT<double, double> solver(system.n, system.m, testDataDir() + "/X.txt");
+    loadSystem(solver, system);
+    SLAUSolverLDLT<double, double> same(system.n, system.m, testDataDir() + "/X.txt");
+    loadSystem(same, system);
+    SLAUSolverLDLT<double, double> other(system.n, system.m, testDataDir() + "/X.txt");
+    system.at(40, 38) += 1e-9;
+    loadSystem(other, system);
+
+    auto factors = solver.factorize(true);
+    check(same.matches(*factors), "An equal matrix did not match the kept copy of A");
+    check(!other.matches(*factors), "A different matrix matched the kept copy of A");
+}
+
+LDLT_TEST(serviceCountsOnlyFailedSolveJobs)
+{
+    SolverService<double, double> service(size_t(1) << 20);
+    expectResponse(service, "frobnicate id=1", "error id=1 Unknown request 'frobnicate'");
+    expectResponse(service, "stats id", "error id= Expected key=value, got 'id'");
+    expectResponse(service, "solve id=2 x=" + testDataDir() + "/service_X.txt", "error id=2 Missing f=");
+
+    ServiceStats stats = service.stats();
+    check(stats.jobs == 1 && stats.failed == 1, service.statsLine());
+}
+
+LDLT_TEST(serviceForgetsFilesOfEvictedFactors)
+{
+    const string dir = testDataDir();
+    BandSystem systemA = randomBandSystem(300, 6, 54u);
+    BandSystem systemB = randomBandSystem(300, 6, 55u);
+    TextSystemFiles a(dir + "/service_evict_a_", systemA);
+    TextSystemFiles b(dir + "/service_evict_b_", systemB);
+    const string x = dir + "/service_X.txt";
+
+    // Room for the factors and the kept copy of A of one of the two systems only.
+    SolverService<double, double> service(size_t(60000));
+    expectResponse(service, a.request("1", x), "ok id=1 cache=miss");
+    expectResponse(service, b.request("2", x), "ok id=2 cache=miss");
+    check(service.stats().evictions == 1, service.statsLine());
+    check(service.knownFileSets() == 1, "Kept " + to_string(service.knownFileSets()) + " file sets after an eviction");
+    expectResponse(service, a.request("3", x), "ok id=3 cache=miss parsed=1");
+    check(service.knownFileSets() == 1, "Kept " + to_string(service.knownFileSets()) + " file sets after an eviction");
+}
@@ -0,0 +1,56 @@
+/**
+ * @file TestStreaming.cpp
+ * @brief StreamingLDLTSolver against the in-core solver on the same text files.
+ */
+#include "StreamingLDLTSolver.hpp"
+#include "TextParser.hpp"
+#include "TestSystems.hpp"
+
+namespace
+{
+    /**
+     * @brief Writes the system as text, solves it in core and out of core and compares x.
+     */
+    template <typename StorageT, typename AccumT>
+    void checkStreaming(int n, int m, size_t blockBytes, double tolerance)
+    {
+        const string dir = testDataDir();
+        const string prefix = dir + "/stream_" + to_string(m) + "_";
+        const string inputFilePath = prefix + "input.txt";
+        const string alFilePath = prefix + "AL.txt";
+        const string dFilePath = prefix + "D.txt";
+        const string fFilePath = prefix + "F.txt";
+
+        BandSystem system = randomBandSystem(n, m, 41u);
+        {
+            SLAUSolverLDLT<StorageT, AccumT> writer(n, m, prefix + "X.txt");
+            loadSystem(writer, system);
+            writer.saveToFile(inputFilePath, alFilePath, dFilePath, fFilePath);
+        }
+
+        SLAUSolverLDLT<StorageT, AccumT> inCore(inputFilePath, alFilePath, dFilePath, fFilePath, prefix + "X.txt");
+        inCore.performLDLtDecomposition();
+        inCore.solveLinearSystem();
+
+        StreamingLDLTSolver<StorageT, AccumT> streaming(inputFilePath, alFilePath, dFilePath, fFilePath,
+                                                        prefix + "factors.bin", prefix + "X_stream.txt", blockBytes);
+        streaming.solve();
+        check(streaming.size() == n && streaming.bandwidth() == m, "Streaming solver read the wrong size");
+
+        vector<StorageT> streamed(n);
+        parseVectorText(prefix + "X_stream.txt", streamed.data(), n);
+        double difference = maxRelativeDifference(streamed, inCore.getVectorF());
+        check(difference <= tolerance, "Streaming solution with m = " + to_string(m) + " differs by " + to_string(difference));
+        check(system.relativeResidual(streamed) <= 10 * tolerance, "Streaming solution has a large residual");
+    }
+}
+
+LDLT_TEST(streamingMatchesInCore)
+{
+    // Small blocks make the factor file I/O cross many block boundaries.
+    checkStreaming<double, double>(1000, 7, 4096, 1e-12);
+    checkStreaming<double, double>(300, 64, 1 << 16, 1e-12);
+    checkStreaming<double, double>(200, 0, 4096, 1e-12);
+    checkStreaming<float, double>(1000, 7, 4096, 1e-5);
+    checkStreaming<float, float>(1000, 7, 4096, 1e-4);
+}
@@ -0,0 +1,125 @@
+/**
+ * @file TestSystems.hpp
+ * @brief Reference band systems for the unit tests, built independently of the solver.
+ *
+ * A BandSystem keeps A in double in the solver's band layout, so a test can change
+ * it, load it into any SLAUSolverLDLT instantiation through setRow() and check a
+ * solution against its own O(n * m) multiply.
+ */
+
+#ifndef TestSystems_HPP
+#define TestSystems_HPP
+
+#include "SLAUSolverLDLT.hpp"
+#include "TestFramework.hpp"
+
+/**
+ * @struct BandSystem
+ * @brief Symmetric band matrix A and right-hand side f, all in double.
+ */
+struct BandSystem
+{
+    int n = 0;            ///< Size of the system
+    int m = 0;            ///< Bandwidth
+    vector<double> band;  ///< A(i, j), j in [i - m, i), at band[i * m + m - i + j]
+    vector<double> diag;  ///< A(i, i)
+    vector<double> f;     ///< Right-hand side
+
+    double &at(int i, int j) { return band[size_t(i) * m + m - i + j]; }
+    double at(int i, int j) const { return band[size_t(i) * m + m - i + j]; }
+
+    /// y = A * x with the full symmetric matrix.
+    vector<double> multiply(const vector<double> &x) const
+    {
+        vector<double> y(n);
+        for (int i = 0; i < n; ++i)
+        {
+            y[i] += diag[i] * x[i];
+            for (int j = max(0, i - m); j < i; ++j)
+            {
+                y[i] += at(i, j) * x[j];
+                y[j] += at(i, j) * x[i];
+            }
+        }
+        return y;
+    }
+
+    /// ||f - A * x||_2 / ||f||_2.
+    template <typename T>
+    double relativeResidual(const vector<T> &x) const
+    {
+        vector<double> y = multiply(vector<double>(x.begin(), x.end()));
+        double r = 0;
+        double b = 0;
+        for (int i = 0; i < n; ++i)
+        {
+            r += (f[i] - y[i]) * (f[i] - y[i]);
+            b += f[i] * f[i];
+        }
+        return sqrt(r / b);
+    }
+};
+
+/**
+ * @brief Random diagonally dominant (hence positive definite) band system.
+ */
+inline BandSystem randomBandSystem(int n, int m, unsigned seed)
+{
+    BandSystem system;
+    system.n = n;
+    system.m = m;
+    system.band.assign(size_t(n) * m, 0);
+    system.diag.assign(n, 1);
+    system.f.resize(n);
+
+    mt19937 generator(seed);
+    uniform_real_distribution<double> value(-1.0, 1.0);
+    for (int i = 0; i < n; ++i)
+    {
+        for (int j = max(0, i - m); j < i; ++j)
+        {
+            system.at(i, j) = value(generator);
+            system.diag[i] += abs(system.at(i, j));
+            system.diag[j] += abs(system.at(i, j));
+        }
+    }
+    for (double &entry : system.f)
+    {
+        entry = value(generator);
+    }
+    return system;
+}
+
+/**
+ * @brief Loads rows [first, n) of the system and its right-hand side into a solver.
+ */
+template <typename StorageT, typename AccumT>
+void loadSystem(SLAUSolverLDLT<StorageT, AccumT> &solver, const BandSystem &system, int first = 0)
+{
+    vector<StorageT> row(system.m);
+    for (int i = first; i < system.n; ++i)
+    {
+        for (int p = 0; p < system.m; ++p)
+        {
+            row[p] = StorageT(system.band[size_t(i) * system.m + p]);
+        }
+        solver.setRow(i, row.data(), StorageT(system.diag[i]));
+    }
+    vector<StorageT> f(system.f.begin(), system.f.end());
+    solver.setVectorF(f.data());
+}
+
+/**
+ * @brief Solves the system in the given precision and returns x.
+ */
+template <typename StorageT, typename AccumT>
+vector<StorageT> solveSystem(const BandSystem &system)
+{
+    SLAUSolverLDLT<StorageT, AccumT> solver(system.n, system.m, testDataDir() + "/X.txt");
+    loadSystem(solver, system);
+    solver.performLDLtDecomposition();
+    solver.solveLinearSystem();
+    return solver.getVectorF();
+}
+
+#endif // TestSystems_HPP
@@ -0,0 +1,198 @@
+/**
+ * @file TestUpdates.cpp
+ * @brief refactorFrom() and rankUpdate() against a full factorization of the changed matrix.
+ *
+ * The changed matrix is built in the test's own BandSystem, so the expected solution
+ * never depends on the code under test.
+ */
+#include "TestSystems.hpp"
+
+namespace
+{
+    /**
+     * @brief Solves f with a solver that is already factored and returns x.
+     */
+    template <typename StorageT, typename AccumT>
+    vector<StorageT> solveFactored(SLAUSolverLDLT<StorageT, AccumT> &solver, const BandSystem &system)
+    {
+        vector<StorageT> f(system.f.begin(), system.f.end());
+        solver.setVectorF(f.data());
+        solver.solveLinearSystem();
+        return solver.getVectorF();
+    }
+
+    /**
+     * @brief Changes rows [k, n) of the system, refactors from k and compares with a full solve.
+     */
+    template <typename StorageT, typename AccumT>
+    void checkRefactorFrom(int n, int m, int k, int threads, double tolerance)
+    {
+        BandSystem system = randomBandSystem(n, m, 21u);
+        SLAUSolverLDLT<StorageT, AccumT> solver(n, m, testDataDir() + "/X.txt");
+        loadSystem(solver, system);
+        solver.setKeepSnapshot(true);
+        solver.setNumThreads(threads);
+        solver.performLDLtDecomposition();
+
+        // Scale the off-diagonal entries of the later rows; A stays diagonally dominant.
+        for (int i = k; i < n; ++i)
+        {
+            for (int j = max(0, i - m); j < i; ++j)
+            {
+                system.at(i, j) *= 0.5;
+            }
+            system.diag[i] += 1;
+        }
+        loadSystem(solver, system, k);
+        check(solver.getFactoredRows() == k, "setRow() left " + to_string(solver.getFactoredRows()) + " factored rows");
+        solver.refactorFrom(k);
+
+        vector<StorageT> updated = solveFactored(solver, system);
+        vector<StorageT> expected = solveSystem<StorageT, AccumT>(system);
+        double difference = maxRelativeDifference(updated, expected);
+        check(difference <= tolerance, "refactorFrom(" + to_string(k) + ") with m = " + to_string(m) +
+                                           " differs by " + to_string(difference));
+    }
+
+    /**
+     * @brief Applies a rank-k update to a factored solver and compares with a full solve.
+     */
+    template <typename StorageT, typename AccumT>
+    void checkRankUpdate(int n, int m, int k, int first, int length, double alpha, double tolerance)
+    {
+        BandSystem system = randomBandSystem(n, m, 33u);
+        SLAUSolverLDLT<StorageT, AccumT> solver(n, m, testDataDir() + "/X.txt");
+        loadSystem(solver, system);
+        solver.setKeepSnapshot(true);
+        solver.performLDLtDecomposition();
+
+        mt19937 generator(5u);
+        uniform_real_distribution<double> value(-0.5, 0.5);
+        vector<StorageT> V(size_t(k) * length);
+        for (StorageT &entry : V)
+        {
+            entry = StorageT(value(generator));
+        }
+        solver.rankUpdate(V.data(), k, first, length, length, alpha);
+
+        for (int c = 0; c < k; ++c)
+        {
+            const StorageT *v = V.data() + size_t(c) * length;
+            for (int i = first; i < first + length; ++i)
+            {
+                for (int j = first; j < i; ++j)
+                {
+                    system.at(i, j) += alpha * double(v[i - first]) * double(v[j - first]);
+                }
+                system.diag[i] += alpha * double(v[i - first]) * double(v[i - first]);
+            }
+        }
+
+        vector<StorageT> updated = solveFactored(solver, system);
+        vector<StorageT> expected = solveSystem<StorageT, AccumT>(system);
+        double difference = maxRelativeDifference(updated, expected);
+        check(difference <= tolerance, "rank-" + to_string(k) + " update with alpha = " + to_string(alpha) +
+                                           " differs by " + to_string(difference));
+        double residual = system.relativeResidual(updated);
+        check(residual <= 10 * tolerance, "Relative residual " + to_string(residual) + " after the update");
+    }
+}
+
+LDLT_TEST(refactorFromMatchesFullFactorization)
+{
+    checkRefactorFrom<double, double>(400, 9, 250, 1, 1e-12);
+    checkRefactorFrom<double, double>(400, 9, 0, 1, 1e-12);
+    checkRefactorFrom<double, double>(400, 30, 123, 4, 1e-12);
+    checkRefactorFrom<double, double>(400, 4, 77, 1, 1e-12);
+    checkRefactorFrom<float, double>(400, 9, 250, 1, 1e-5);
+    checkRefactorFrom<float, float>(400, 9, 250, 1, 1e-4);
+}
+
+LDLT_TEST(rankUpdateMatchesFullFactorization)
+{
+    checkRankUpdate<double, double>(300, 6, 1, 40, 7, 1.0, 1e-11);
+    checkRankUpdate<double, double>(300, 6, 3, 0, 7, 0.75, 1e-11);
+    checkRankUpdate<double, double>(300, 6, 2, 293, 7, 2.0, 1e-11);
+    checkRankUpdate<double, double>(300, 12, 2, 100, 5, 1.5, 1e-11);
+    checkRankUpdate<float, double>(300, 6, 2, 40, 7, 1.0, 1e-4);
+}
+
+LDLT_TEST(rankDowndateMatchesFullFactorization)
+{
+    // A is diagonally dominant by at least 1, so a downdate by 0.5 * v * v^T with |v| <= 0.5 keeps it definite.
+    checkRankUpdate<double, double>(300, 6, 1, 40, 7, -0.5, 1e-10);
+    checkRankUpdate<double, double>(300, 6, 2, 150, 4, -0.5, 1e-10);
+    checkRankUpdate<float, double>(300, 6, 1, 40, 7, -0.5, 1e-4);
+}
+
+LDLT_TEST(rankUpdateRejectsWideVectors)
+{
+    BandSystem system = randomBandSystem(50, 3, 2u);
+    SLAUSolverLDLT<double, double> solver(system.n, system.m, testDataDir() + "/X.txt");
+    loadSystem(solver, system);
+    vector<double> v(system.m + 2, 1.0);
+    bool threw = false;
+    try
+    {
+        solver.rankOneUpdate(v.data(), 0, int(v.size()), 1.0);
+    }
+    catch (const invalid_argument &)
+    {
+        threw = true;
+    }
+    check(threw, "An update spanning m + 2 rows was accepted");
+}
+
+LDLT_TEST(indefiniteDowndateStopsAndRefactors)
+{
+    BandSystem system = randomBandSystem(200, 5, 8u);
+    SLAUSolverLDLT<double, double> solver(system.n, system.m, testDataDir() + "/X.txt");
+    loadSystem(solver, system);
+    solver.setKeepSnapshot(true);
+    solver.performLDLtDecomposition();
+
+    // Subtracting more than A(first, first) along e_first makes A indefinite.
+    const int first = 60;
+    double unit = 1.0;
+    double alpha = -(system.diag[first] + 5);
+    bool threw = false;
+    try
+    {
+        solver.rankOneUpdate(&unit, first, 1, alpha);
+    }
+    catch (const runtime_error &)
+    {
+        threw = true;
+    }
+    check(threw, "An indefinite downdate was accepted");
+    check(solver.getFactoredRows() == first, "Factored rows " + to_string(solver.getFactoredRows()) +
+                                                 " after the failed downdate");
+
+    // The snapshot holds the new A, which is still nonsingular, so refactor() recovers.
+    system.diag[first] += alpha;
+    solver.refactor();
+    vector<double> f(system.f);
+    solver.setVectorF(f.data());
+    solver.solveLinearSystem();
+    vector<double> expected = solveSystem<double, double>(system);
+    check(maxRelativeDifference(solver.getVectorF(), expected) <= 1e-10, "Refactored solution differs");
+}
+
+LDLT_TEST(rankUpdateRejectsHandedOverFactors)
+{
+    BandSystem system = randomBandSystem(50, 3, 4u);
+    SLAUSolverLDLT<double, double> solver(system.n, system.m, testDataDir() + "/X.txt");
+    loadSystem(solver, system);
+    auto factors = solver.factorize();
+    double unit = 1.0;
+    bool threw = false;
+    try
+    {
+        solver.rankOneUpdate(&unit, 0, 1, 1.0);
+    }
+    catch (const logic_error &)
+    {
+        threw = true;
+    }
+    check(threw, "rankUpdate() ran on handed-over factors");
+}
@@ -0,0 +1,164 @@
+/**
+ * @file cuda_runtime.h
+ * @brief Host emulation of the parts of the CUDA runtime that DeviceKernels.cu uses.
+ *
+ * 'make test' compiles DeviceKernels.cu as C++ with LDLT_USE_CUDA against this
+ * header, so the kernels are checked without a GPU. Device memory is host memory.
+ * LDLT_LAUNCH runs the blocks of a launch one after the other and the threads of
+ * a block concurrently on std::thread, so __syncthreads() is a real barrier and a
+ * __shared__ array (a static, since only one block runs at a time) is shared by the
+ * threads of the block only. Launches are synchronous and never fail.
+ */
+
+#ifndef CudaRuntimeEmulation_HPP
+#define CudaRuntimeEmulation_HPP
+
+#include <bits/stdc++.h>
+using namespace std;
+
+#define __global__
+#define __device__
+#define __host__
+#define __shared__ static
+
+enum cudaError_t
+{
+    cudaSuccess = 0,
+    cudaErrorMemoryAllocation = 2
+};
+
+enum cudaMemcpyKind
+{
+    cudaMemcpyHostToDevice = 1,
+    cudaMemcpyDeviceToHost = 2
+};
+
+inline const char *cudaGetErrorString(cudaError_t status)
+{
+    return status == cudaSuccess ? "no error" : "out of memory";
+}
+
+inline cudaError_t cudaMalloc(void **pointer, size_t bytes)
+{
+    *pointer = malloc(bytes);
+    return *pointer != nullptr ? cudaSuccess : cudaErrorMemoryAllocation;
+}
+
+inline cudaError_t cudaFree(void *pointer)
+{
+    free(pointer);
+    return cudaSuccess;
+}
+
+inline cudaError_t cudaMemcpy(void *destination, const void *source, size_t bytes, cudaMemcpyKind)
+{
+    memcpy(destination, source, bytes);
+    return cudaSuccess;
+}
+
+inline cudaError_t cudaMemcpy2D(void *destination, size_t destinationPitch, const void *source, size_t sourcePitch,
+                                size_t width, size_t height, cudaMemcpyKind)
+{
+    for (size_t row = 0; row < height; ++row)
+    {
+        memcpy(static_cast<char *>(destination) + row * destinationPitch,
+               static_cast<const char *>(source) + row * sourcePitch, width);
+    }
+    return cudaSuccess;
+}
+
+inline cudaError_t cudaGetLastError() { return cudaSuccess; }
+inline cudaError_t cudaDeviceSynchronize() { return cudaSuccess; }
+
+inline cudaError_t cudaGetDeviceCount(int *count)
+{
+    *count = 1;
+    return cudaSuccess;
+}
+
+struct dim3
+{
+    unsigned x = 1, y = 1, z = 1;
+};
+
+/// Position of the calling emulated thread, set by the launch.
+inline thread_local dim3 threadIdx;
+inline thread_local dim3 blockIdx;
+inline thread_local dim3 blockDim;
+
+namespace cudaEmulation
+{
+    /**
+     * @brief Reusable barrier for the threads of one block.
+     */
+    class BlockBarrier
+    {
+    private:
+        mutex lock;
+        condition_variable released;
+        unsigned threads;
+        unsigned waiting = 0;
+        unsigned generation = 0;
+
+    public:
+        explicit BlockBarrier(unsigned count) : threads(count) {}
+
+        void wait()
+        {
+            unique_lock<mutex> guard(lock);
+            unsigned arrived = generation;
+            if (++waiting == threads)
+            {
+                waiting = 0;
+                ++generation;
+                released.notify_all();
+                return;
+            }
+            released.wait(guard, [&] { return generation != arrived; });
+        }
+    };
+
+    /// Barrier of the block that is running.
+    inline BlockBarrier *runningBlock = nullptr;
+
+    /**
+     * @brief Returns a callable that runs kernel on blocks x threads emulated threads.
+     */
+    template <typename... Parameters>
+    auto launch(unsigned blocks, unsigned threads, void (*kernel)(Parameters...))
+    {
+        return [=](auto... arguments)
+        {
+            for (unsigned b = 0; b < blocks; ++b)
+            {
+                BlockBarrier barrier(threads);
+                runningBlock = &barrier;
+                vector<thread> workers;
+                for (unsigned t = 0; t < threads; ++t)
+                {
+                    workers.emplace_back([&, b, t]
+                    {
+                        blockIdx.x = b;
+                        blockDim.x = threads;
+                        threadIdx.x = t;
+                        kernel(Parameters(arguments)...);
+                    });
+                }
+                for (thread &worker : workers)
+                {
+                    worker.join();
+                }
+                runningBlock = nullptr;
+            }
+        };
+    }
+}
+
+inline void __syncthreads()
+{
+    cudaEmulation::runningBlock->wait();
+}
+
+#define LDLT_LAUNCH(blocks, threads, ...) cudaEmulation::launch(blocks, threads, __VA_ARGS__)
+
+#endif // CudaRuntimeEmulation_HPP
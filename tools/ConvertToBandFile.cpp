@@ -0,0 +1,100 @@
+/**
+ * @file ConvertToBandFile.cpp
+ * @brief Converts the text layout of data/ (input.txt, AL.txt, D.txt, F.txt) to a binary band file.
+ *
+ * Usage:
+ * @code
+ * ldlt_convert.exe input.txt AL.txt D.txt F.txt system.ldlt [--float | --double]
+ * @endcode
+ */
+#include "BandFile.hpp"
+
+namespace
+{
+    ifstream openText(const string &filePath)
+    {
+        ifstream file(filePath);
+        if (!file.is_open())
+        {
+            throw runtime_error("Could not open file: " + filePath);
+        }
+        return file;
+    }
+
+    template <typename T>
+    void convert(const string &inputFilePath, const string &alFilePath, const string &dFilePath,
+                 const string &fFilePath, const string &outputFilePath)
+    {
+        int n = 0, m = 0;
+        ifstream input = openText(inputFilePath);
+        if (!(input >> n >> m) || n < 0 || m < 0)
+        {
+            throw runtime_error("Could not read n and m from " + inputFilePath);
+        }
+
+        BandMatrix<T> AL(n, m);
+        vector<T> D(n), F(n);
+
+        ifstream al = openText(alFilePath);
+        for (int i = 0; i < n; ++i)
+        {
+            T *row = AL[i];
+            for (int j = 0; j < m; ++j)
+            {
+                if (!(al >> row[j]))
+                {
+                    throw runtime_error("Unexpected end of " + alFilePath + " at row " + to_string(i + 1));
+                }
+            }
+        }
+
+        ifstream d = openText(dFilePath);
+        ifstream f = openText(fFilePath);
+        for (int i = 0; i < n; ++i)
+        {
+            if (!(d >> D[i]))
+            {
+                throw runtime_error("Unexpected end of " + dFilePath + " at row " + to_string(i + 1));
+            }
+            if (!(f >> F[i]))
+            {
+                throw runtime_error("Unexpected end of " + fFilePath + " at row " + to_string(i + 1));
+            }
+        }
+
+        writeBandFile(outputFilePath, AL, D, &F);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    if (argc < 6 || argc > 7)
+    {
+        cerr << "Usage: " << argv[0] << " input.txt AL.txt D.txt F.txt output.ldlt [--float | --double]\n";
+        return 2;
+    }
+
+    try
+    {
+        string precision = argc == 7 ? argv[6] : "--double";
+        if (precision == "--float")
+        {
+            convert<float>(argv[1], argv[2], argv[3], argv[4], argv[5]);
+        }
+        else if (precision == "--double")
+        {
+            convert<double>(argv[1], argv[2], argv[3], argv[4], argv[5]);
+        }
+        else
+        {
+            throw invalid_argument("Unknown precision option: " + precision);
+        }
+    }
+    catch (const exception &e)
+    {
+        cerr << "EROR: " << e.what() << '\n';
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,121 @@
+/**
+ * @file DistributedSolve.cpp
+ * @brief Solves a band file with DistributedLDLTSolver on all ranks of MPI_COMM_WORLD.
+ *
+ * Usage:
+ * @code
+ * mpirun -np 16 build/ldlt_mpi.exe --band-file system.ldlt [--output X.txt] [--output-format text|binary]
+ *                                   [--precision float|double|float_double] [--threads t] [--verify 1]
+ * @endcode
+ *
+ * The band file needs an F section (see ldlt_convert.exe). Rank 0 writes the
+ * solution and prints the phase times, the maximum over all ranks.
+ */
+#include "DistributedLDLTSolver.hpp"
+
+namespace
+{
+    template <typename StorageT, typename AccumT>
+    void run(const string &bandFilePath, const string &xFilePath, SolutionFormat format, int threads, bool verify)
+    {
+        DistributedLDLTSolver<StorageT, AccumT> solver(MPI_COMM_WORLD, bandFilePath, verify);
+        solver.setNumThreads(threads);
+        solver.factorize();
+        solver.solve();
+        solver.writeSolution(xFilePath, format);
+
+        int rank = 0;
+        MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+        if (rank == 0)
+        {
+            const DistributedStats &stats = solver.stats();
+            cout << "Ranks: " << stats.ranks << ", n = " << solver.size() << ", m = " << solver.bandwidth()
+                 << ", interface system " << stats.reducedSize << '\n'
+                 << fixed << setprecision(6) << "Local factorization: " << stats.localFactorSeconds << " s\n"
+                 << "Spikes: " << stats.spikeSeconds << " s\n"
+                 << "Interface system: " << stats.reducedSeconds << " s\n"
+                 << "Solve: " << stats.solveSeconds << " s\n";
+        }
+    }
+}
+
+int main(int argc, char **argv)
+{
+    MPI_Init(&argc, &argv);
+    try
+    {
+        string bandFilePath;
+        string xFilePath = "data/X.txt";
+        string precisionFlag;
+        SolutionFormat outputFormat = SolutionFormat::Text;
+        int threads = 1;
+        bool verify = false;
+
+        for (int i = 1; i < argc; ++i)
+        {
+            string arg = argv[i];
+            if (i + 1 >= argc)
+            {
+                throw invalid_argument("Missing value for " + arg);
+            }
+            if (arg == "--band-file")
+            {
+                bandFilePath = argv[++i];
+            }
+            else if (arg == "--output")
+            {
+                xFilePath = argv[++i];
+            }
+            else if (arg == "--output-format")
+            {
+                outputFormat = parseSolutionFormat(argv[++i]);
+            }
+            else if (arg == "--precision")
+            {
+                precisionFlag = argv[++i];
+            }
+            else if (arg == "--threads")
+            {
+                threads = stoi(argv[++i]);
+            }
+            else if (arg == "--verify")
+            {
+                verify = stoi(argv[++i]) != 0;
+            }
+            else
+            {
+                throw invalid_argument("Unknown option: " + arg);
+            }
+        }
+        if (bandFilePath.empty())
+        {
+            throw invalid_argument("--band-file is required");
+        }
+
+        // The storage type has to match the file; float files default to float accumulation.
+        Precision precision;
+        if (!precisionFlag.empty())
+        {
+            precision = parsePrecision(precisionFlag);
+        }
+        else
+        {
+            MappedBandFile file(bandFilePath, false);
+            precision = file.scalarType() == BandScalarType::Float32 ? Precision::Float : Precision::Double;
+        }
+        dispatchPrecision(precision, [&](auto pair)
+        {
+            using Pair = decltype(pair);
+            run<typename Pair::Storage, typename Pair::Accum>(bandFilePath, xFilePath, outputFormat, threads, verify);
+        });
+    }
+    catch (const exception &e)
+    {
+        // The other ranks may be waiting in a collective call.
+        cerr << "EROR: " << e.what() << '\n';
+        MPI_Abort(MPI_COMM_WORLD, 1);
+    }
+
+    MPI_Finalize();
+    return 0;
+}